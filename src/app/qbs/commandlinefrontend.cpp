@@ -43,6 +43,9 @@
 
 #include <QDir>
 #include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMetaObject>
 #include <QProcessEnvironment>
 #include <QTimer>
@@ -111,6 +114,7 @@ void CommandLineFrontend::start()
         case StatusCommandType:
         case InstallCommandType:
         case DumpNodesTreeCommandType:
+        case AffectedCommandType:
             if (m_parser.buildConfigurations().count() > 1) {
                 QString error = Tr::tr("Invalid use of command '%1': There can be only one "
                                "build configuration.\n").arg(m_parser.commandName());
@@ -130,8 +134,10 @@ void CommandLineFrontend::start()
         params.setDryRun(m_parser.dryRun());
         params.setLogElapsedTime(m_parser.logTime());
         params.setSettingsDirectory(m_settings->baseDirectoy());
-        if (!m_parser.buildBeforeInstalling() || m_parser.command() == DumpNodesTreeCommandType)
+        if (!m_parser.buildBeforeInstalling() || m_parser.command() == DumpNodesTreeCommandType
+                || m_parser.command() == AffectedCommandType) {
             params.setRestoreBehavior(SetupProjectParameters::RestoreOnly);
+        }
         foreach (const QVariantMap &buildConfig, m_parser.buildConfigurations()) {
             QVariantMap userConfig = buildConfig;
             const QString buildVariantKey = QLatin1String("qbs.buildVariant");
@@ -205,6 +211,11 @@ void CommandLineFrontend::handleJobFinished(bool success, AbstractJob *job)
 {
     try {
         job->deleteLater();
+        if (success && m_parser.logTime()) {
+            const Metrics metrics = job->metrics();
+            if (!metrics.isEmpty())
+                qbsInfo() << Tr::tr("Collected metrics:\n%1").arg(metrics.toString());
+        }
         if (!success) {
             qbsError() << job->error().toString();
             m_resolveJobs.removeOne(job);
@@ -292,6 +303,18 @@ void CommandLineFrontend::handleTaskProgress(int value, AbstractJob *job)
     }
 }
 
+void CommandLineFrontend::handleProcessOutputReport(const QString &commandDescription,
+        const QString &executableFilePath, const QStringList &stdOut, const QStringList &stdErr)
+{
+    // The output of commands running in parallel interleaves, so say where it comes from.
+    const QString origin = commandDescription.isEmpty()
+            ? QDir::toNativeSeparators(executableFilePath) : commandDescription;
+    if (!stdOut.isEmpty())
+        qbsInfo() << origin << ":\n" << stdOut.join(QLatin1Char('\n'));
+    if (!stdErr.isEmpty())
+        qbsWarning() << origin << ":\n" << stdErr.join(QLatin1Char('\n'));
+}
+
 void CommandLineFrontend::handleProcessResultReport(const qbs::ProcessResult &result)
 {
     bool hasOutput = !result.stdOut().isEmpty() || !result.stdErr().isEmpty();
@@ -381,6 +404,10 @@ void CommandLineFrontend::handleProjectsResolved()
         dumpNodesTree();
         qApp->quit();
         break;
+    case AffectedCommandType:
+        printAffected();
+        qApp->quit();
+        break;
     case HelpCommandType:
         Q_ASSERT_X(false, Q_FUNC_INFO, "Impossible.");
     }
@@ -523,11 +550,35 @@ void CommandLineFrontend::dumpNodesTree()
     QFile stdOut;
     stdOut.open(stdout, QIODevice::WriteOnly);
     const ErrorInfo error = m_projects.first().dumpNodesTree(stdOut, productsToUse()
-                                                             .value(m_projects.first()));
+                                                             .value(m_projects.first()),
+                                                             m_parser.nodeTreeDumpOptions());
     if (error.hasError())
         throw error;
 }
 
+void CommandLineFrontend::printAffected()
+{
+    const Project &project = m_projects.first();
+    const QStringList &changedFiles = m_parser.changedFiles();
+    QJsonArray products;
+    foreach (const ProductData &product, project.affectedProducts(changedFiles)) {
+        QJsonObject productObject;
+        productObject.insert(QLatin1String("name"), product.name());
+        productObject.insert(QLatin1String("profile"), product.profile());
+        products << productObject;
+    }
+    QJsonArray targetArtifacts;
+    foreach (const TargetArtifact &ta, project.affectedTargetArtifacts(changedFiles))
+        targetArtifacts << ta.filePath();
+    QJsonObject result;
+    result.insert(QLatin1String("products"), products);
+    result.insert(QLatin1String("targetArtifacts"), targetArtifacts);
+
+    QFile stdOut;
+    stdOut.open(stdout, QIODevice::WriteOnly);
+    stdOut.write(QJsonDocument(result).toJson());
+}
+
 void CommandLineFrontend::connectBuildJobs()
 {
     foreach (AbstractJob * const job, m_buildJobs)
@@ -546,6 +597,8 @@ void CommandLineFrontend::connectBuildJob(AbstractJob *job)
             this, SLOT(handleCommandDescriptionReport(QString,QString)));
     connect(bjob, SIGNAL(reportProcessResult(qbs::ProcessResult)),
             this, SLOT(handleProcessResultReport(qbs::ProcessResult)));
+    connect(bjob, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+            this, SLOT(handleProcessOutputReport(QString,QString,QStringList,QStringList)));
 }
 
 void CommandLineFrontend::connectJob(AbstractJob *job)
@@ -66,6 +66,9 @@ private slots:
     void handleNewTaskStarted(const QString &description, int totalEffort);
     void handleTotalEffortChanged(int totalEffort);
     void handleTaskProgress(int value, qbs::AbstractJob *job);
+    void handleProcessOutputReport(const QString &commandDescription,
+                                   const QString &executableFilePath, const QStringList &stdOut,
+                                   const QStringList &stdErr);
     void handleProcessResultReport(const qbs::ProcessResult &result);
     void checkCancelStatus();
 
@@ -84,6 +87,7 @@ private:
     int runTarget();
     void updateTimestamps();
     void dumpNodesTree();
+    void printAffected();
     void connectBuildJobs();
     void connectBuildJob(AbstractJob *job);
     void connectJob(AbstractJob *job);
@@ -36,6 +36,7 @@
 #include <tools/error.h>
 #include <tools/hostosinfo.h>
 
+#include <QDir>
 #include <QMap>
 #include <QSet>
 
@@ -248,6 +249,7 @@ static QList<CommandLineOption::Type> buildOptions()
             << CommandLineOption::ForceTimestampCheckOptionType
             << CommandLineOption::BuildNonDefaultOptionType
             << CommandLineOption::CommandEchoModeOptionType
+            << CommandLineOption::StreamOutputOptionType
             << CommandLineOption::NoInstallOptionType
             << CommandLineOption::RemoveFirstOptionType;
 }
@@ -282,6 +284,7 @@ QList<CommandLineOption::Type> CleanCommand::supportedOptions() const
     options.removeOne(CommandLineOption::JobsOptionType);
     options.removeOne(CommandLineOption::BuildNonDefaultOptionType);
     options.removeOne(CommandLineOption::CommandEchoModeOptionType);
+    options.removeOne(CommandLineOption::StreamOutputOptionType);
     return options << CommandLineOption::AllArtifactsOptionType;
 }
 
@@ -469,6 +472,8 @@ QString DumpNodesTreeCommand::longDescription() const
     QString description = Tr::tr("qbs %1 [options] [[variant] [property:value] ...] ...\n")
             .arg(representation());
     description += Tr::tr("Internal command; for debugging purposes only.\n");
+    description += Tr::tr("The 'json-lines' and 'binary' formats are suitable for large "
+                          "build graphs,\nas they write every node only once.\n");
     return description += supportedOptionsDescription();
 }
 
@@ -485,7 +490,62 @@ QList<CommandLineOption::Type> DumpNodesTreeCommand::supportedOptions() const
             << CommandLineOption::QuietOptionType
             << CommandLineOption::FileOptionType
             << CommandLineOption::BuildDirectoryOptionType
-            << CommandLineOption::ProductsOptionType;
+            << CommandLineOption::ProductsOptionType
+            << CommandLineOption::DumpFormatOptionType
+            << CommandLineOption::FileTagsOptionType
+            << CommandLineOption::MaxDepthOptionType;
+}
+
+QString AffectedCommand::shortDescription() const
+{
+    return Tr::tr("List the products and target artifacts affected by changed files.");
+}
+
+QString AffectedCommand::longDescription() const
+{
+    QString description = Tr::tr("qbs %1 [options] [variant] [property:value] ... "
+                                 "-- <file> ...
+").arg(representation());
+    description += Tr::tr("Looks up the given files in the stored build graph and prints "
+                          "the products and target artifacts depending on them as a JSON "
+                          "object. The project is neither resolved nor built.
+");
+    return description += supportedOptionsDescription();
+}
+
+QString AffectedCommand::representation() const
+{
+    return QLatin1String("affected");
+}
+
+QList<CommandLineOption::Type> AffectedCommand::supportedOptions() const
+{
+    return QList<CommandLineOption::Type>()
+            << CommandLineOption::FileOptionType
+            << CommandLineOption::BuildDirectoryOptionType
+            << CommandLineOption::LogLevelOptionType
+            << CommandLineOption::VerboseOptionType
+            << CommandLineOption::QuietOptionType;
+}
+
+void AffectedCommand::parseMore(QStringList &input)
+{
+    // Build variants and properties
+    while (!input.isEmpty()) {
+        const QString arg = input.takeFirst();
+        if (arg == QLatin1String("--"))
+            break;
+        addOneToAdditionalArguments(arg);
+    }
+
+    if (input.isEmpty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of command '%1': No files given.
+Usage: %2")
+                        .arg(representation(), longDescription()));
+    }
+    foreach (const QString &filePath, input)
+        m_changedFiles << QDir::cleanPath(QDir::current().absoluteFilePath(filePath));
+    input.clear();
 }
 
 QString HelpCommand::shortDescription() const
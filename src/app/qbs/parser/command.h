@@ -203,6 +203,23 @@ private:
     QList<CommandLineOption::Type> supportedOptions() const Q_DECL_OVERRIDE;
 };
 
+class AffectedCommand : public Command
+{
+public:
+    AffectedCommand(CommandLineOptionPool &optionPool) : Command(optionPool) {}
+    QStringList changedFiles() const { return m_changedFiles; }
+
+private:
+    CommandType type() const { return AffectedCommandType; }
+    QString shortDescription() const;
+    QString longDescription() const;
+    QString representation() const;
+    QList<CommandLineOption::Type> supportedOptions() const;
+    void parseMore(QStringList &input);
+
+    QStringList m_changedFiles;
+};
+
 class HelpCommand : public Command
 {
 public:
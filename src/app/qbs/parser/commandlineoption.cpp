@@ -357,6 +357,20 @@ QString ProductsOption::longRepresentation() const
     return QLatin1String("--products");
 }
 
+QString FileTagsOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <tag>[,<tag>...]\n"
+                  "\tOnly take nodes into account that have one of these file tags.\n"
+                  "\tRules match if they produce artifacts with one of these tags.\n")
+            .arg(longRepresentation());
+}
+
+QString FileTagsOption::longRepresentation() const
+{
+    return QLatin1String("--file-tags");
+}
+
 static QStringList allLogLevelStrings()
 {
     QStringList result;
@@ -523,6 +537,8 @@ QString LogTimeOption::description(CommandType command) const
     Q_UNUSED(command);
     QString desc = Tr::tr("%1\n\tLog the time that the operations involved in this command take.\n")
             .arg(longRepresentation());
+    desc += Tr::tr("\tAlso print a breakdown of the time spent in the individual phases, along\n"
+                   "\twith counters and duration histograms.\n");
     desc += Tr::tr("\tThis option is implied in log levels '%1' and higher.\n")
             .arg(logLevelName(LoggerDebug));
     return desc += Tr::tr("\tThis option is mutually exclusive with '%1'.\n")
@@ -589,6 +605,19 @@ QString CommandEchoModeOption::longRepresentation() const
     return QLatin1String("--command-echo-mode");
 }
 
+QString StreamOutputOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tPrint the output of commands while they are running.\n"
+                  "\tBy default, the output of a command is printed once it has finished.\n")
+            .arg(longRepresentation());
+}
+
+QString StreamOutputOption::longRepresentation() const
+{
+    return QLatin1String("--stream-output");
+}
+
 CommandEchoMode CommandEchoModeOption::commandEchoMode() const
 {
     return m_echoMode;
@@ -611,4 +640,92 @@ void CommandEchoModeOption::doParse(const QString &representation, QStringList &
     m_echoMode = commandEchoModeFromName(mode);
 }
 
+static QString dumpFormatName(NodeTreeDumpOptions::Format format)
+{
+    switch (format) {
+    case NodeTreeDumpOptions::TreeFormat:
+        return QLatin1String("tree");
+    case NodeTreeDumpOptions::JsonLinesFormat:
+        return QLatin1String("json-lines");
+    case NodeTreeDumpOptions::BinaryFormat:
+        return QLatin1String("binary");
+    }
+    return QString();
+}
+
+static QList<NodeTreeDumpOptions::Format> allDumpFormats()
+{
+    return QList<NodeTreeDumpOptions::Format>() << NodeTreeDumpOptions::TreeFormat
+            << NodeTreeDumpOptions::JsonLinesFormat << NodeTreeDumpOptions::BinaryFormat;
+}
+
+static QStringList allDumpFormatNames()
+{
+    QStringList names;
+    foreach (const NodeTreeDumpOptions::Format format, allDumpFormats())
+        names << dumpFormatName(format);
+    return names;
+}
+
+DumpFormatOption::DumpFormatOption() : m_format(NodeTreeDumpOptions::TreeFormat)
+{
+}
+
+QString DumpFormatOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <format>\n"
+                  "\tThe output format. Possible values are '%2'.\n"
+                  "\tThe default is '%3'. The other formats list every node once,\n"
+                  "\tfollowed by the edges to its children.\n")
+            .arg(longRepresentation(), allDumpFormatNames().join(QLatin1String("', '")),
+                 dumpFormatName(NodeTreeDumpOptions::TreeFormat));
+}
+
+QString DumpFormatOption::longRepresentation() const
+{
+    return QLatin1String("--format");
+}
+
+void DumpFormatOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString formatName = getArgument(representation, input);
+    foreach (const NodeTreeDumpOptions::Format format, allDumpFormats()) {
+        if (dumpFormatName(format) == formatName) {
+            m_format = format;
+            return;
+        }
+    }
+    throw ErrorInfo(Tr::tr("Invalid use of option '%1': Unknown format '%2'.\nUsage: %3")
+                    .arg(representation, formatName, description(command())));
+}
+
+MaxDepthOption::MaxDepthOption() : m_maxDepth(-1)
+{
+}
+
+QString MaxDepthOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <n>\n"
+                  "\tOnly take nodes into account that are at most <n> edges away\n"
+                  "\tfrom a product's root nodes. The default is not to limit the depth.\n")
+            .arg(longRepresentation());
+}
+
+QString MaxDepthOption::longRepresentation() const
+{
+    return QLatin1String("--max-depth");
+}
+
+void MaxDepthOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString depthString = getArgument(representation, input);
+    bool stringOk;
+    m_maxDepth = depthString.toInt(&stringOk);
+    if (!stringOk || m_maxDepth < 0)
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal depth '%2'.\nUsage: %3")
+                    .arg(representation, depthString, description(command())));
+}
+
 } // namespace qbs
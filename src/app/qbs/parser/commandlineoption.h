@@ -33,6 +33,7 @@
 #include "commandtype.h"
 
 #include <tools/commandechomode.h>
+#include <tools/nodetreedumpoptions.h>
 
 #include <QStringList>
 
@@ -59,8 +60,12 @@ public:
         BuildNonDefaultOptionType,
         LogTimeOptionType,
         CommandEchoModeOptionType,
+        StreamOutputOptionType,
         SettingsDirOptionType,
-        GeneratorOptionType
+        GeneratorOptionType,
+        DumpFormatOptionType,
+        FileTagsOptionType,
+        MaxDepthOptionType
     };
 
     virtual ~CommandLineOption();
@@ -271,6 +276,14 @@ public:
     QString longRepresentation() const;
 };
 
+class FileTagsOption : public StringListOption
+{
+public:
+    QString description(CommandType command) const;
+    QString shortRepresentation() const { return QString(); }
+    QString longRepresentation() const;
+};
+
 class LogLevelOption : public CommandLineOption
 {
 public:
@@ -345,6 +358,48 @@ private:
     CommandEchoMode m_echoMode;
 };
 
+class StreamOutputOption : public OnOffOption
+{
+public:
+    QString description(CommandType command) const;
+    QString shortRepresentation() const { return QString(); }
+    QString longRepresentation() const;
+};
+
+class DumpFormatOption : public CommandLineOption
+{
+public:
+    DumpFormatOption();
+
+    NodeTreeDumpOptions::Format format() const { return m_format; }
+
+    QString description(CommandType command) const;
+    QString shortRepresentation() const { return QString(); }
+    QString longRepresentation() const;
+
+private:
+    void doParse(const QString &representation, QStringList &input);
+
+    NodeTreeDumpOptions::Format m_format;
+};
+
+class MaxDepthOption : public CommandLineOption
+{
+public:
+    MaxDepthOption();
+
+    int maxDepth() const { return m_maxDepth; }
+
+    QString description(CommandType command) const;
+    QString shortRepresentation() const { return QString(); }
+    QString longRepresentation() const;
+
+private:
+    void doParse(const QString &representation, QStringList &input);
+
+    int m_maxDepth;
+};
+
 class SettingsDirOption : public CommandLineOption
 {
 public:
@@ -104,12 +104,24 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::CommandEchoModeOptionType:
             option = new CommandEchoModeOption;
             break;
+        case CommandLineOption::StreamOutputOptionType:
+            option = new StreamOutputOption;
+            break;
         case CommandLineOption::SettingsDirOptionType:
             option = new SettingsDirOption;
             break;
         case CommandLineOption::GeneratorOptionType:
             option = new GeneratorOption;
             break;
+        case CommandLineOption::DumpFormatOptionType:
+            option = new DumpFormatOption;
+            break;
+        case CommandLineOption::FileTagsOptionType:
+            option = new FileTagsOption;
+            break;
+        case CommandLineOption::MaxDepthOptionType:
+            option = new MaxDepthOption;
+            break;
         default:
             qFatal("Unknown option type %d", type);
         }
@@ -225,6 +237,12 @@ CommandEchoModeOption *CommandLineOptionPool::commandEchoModeOption() const
                 getOption(CommandLineOption::CommandEchoModeOptionType));
 }
 
+StreamOutputOption *CommandLineOptionPool::streamOutputOption() const
+{
+    return static_cast<StreamOutputOption *>(
+                getOption(CommandLineOption::StreamOutputOptionType));
+}
+
 SettingsDirOption *CommandLineOptionPool::settingsDirOption() const
 {
     return static_cast<SettingsDirOption *>(getOption(CommandLineOption::SettingsDirOptionType));
@@ -235,4 +253,19 @@ GeneratorOption *CommandLineOptionPool::generatorOption() const
     return static_cast<GeneratorOption *>(getOption(CommandLineOption::GeneratorOptionType));
 }
 
+DumpFormatOption *CommandLineOptionPool::dumpFormatOption() const
+{
+    return static_cast<DumpFormatOption *>(getOption(CommandLineOption::DumpFormatOptionType));
+}
+
+FileTagsOption *CommandLineOptionPool::fileTagsOption() const
+{
+    return static_cast<FileTagsOption *>(getOption(CommandLineOption::FileTagsOptionType));
+}
+
+MaxDepthOption *CommandLineOptionPool::maxDepthOption() const
+{
+    return static_cast<MaxDepthOption *>(getOption(CommandLineOption::MaxDepthOptionType));
+}
+
 } // namespace qbs
@@ -63,8 +63,12 @@ public:
     BuildNonDefaultOption *buildNonDefaultOption() const;
     LogTimeOption *logTimeOption() const;
     CommandEchoModeOption *commandEchoModeOption() const;
+    StreamOutputOption *streamOutputOption() const;
     SettingsDirOption *settingsDirOption() const;
     GeneratorOption *generatorOption() const;
+    DumpFormatOption *dumpFormatOption() const;
+    FileTagsOption *fileTagsOption() const;
+    MaxDepthOption *maxDepthOption() const;
 
 private:
     mutable QHash<CommandLineOption::Type, CommandLineOption *> m_options;
@@ -44,6 +44,7 @@
 #include <tools/generateoptions.h>
 #include <tools/hostosinfo.h>
 #include <tools/installoptions.h>
+#include <tools/nodetreedumpoptions.h>
 #include <tools/preferences.h>
 #include <tools/settings.h>
 
@@ -198,6 +199,16 @@ InstallOptions CommandLineParser::installOptions(const QString &profile) const
     return options;
 }
 
+NodeTreeDumpOptions CommandLineParser::nodeTreeDumpOptions() const
+{
+    Q_ASSERT(command() == DumpNodesTreeCommandType);
+    NodeTreeDumpOptions options;
+    options.setFormat(d->optionPool.dumpFormatOption()->format());
+    options.setFileTags(d->optionPool.fileTagsOption()->arguments());
+    options.setMaxDepth(d->optionPool.maxDepthOption()->maxDepth());
+    return options;
+}
+
 bool CommandLineParser::force() const
 {
     return d->optionPool.forceOption()->enabled();
@@ -234,6 +245,12 @@ QStringList CommandLineParser::runArgs() const
     return static_cast<RunCommand *>(d->command)->targetParameters();
 }
 
+QStringList CommandLineParser::changedFiles() const
+{
+    Q_ASSERT(d->command->type() == AffectedCommandType);
+    return static_cast<AffectedCommand *>(d->command)->changedFiles();
+}
+
 QStringList CommandLineParser::products() const
 {
     return d->optionPool.productsOption()->arguments();
@@ -398,6 +415,7 @@ QList<Command *> CommandLineParser::CommandLineParserPrivate::allCommands() cons
             << commandPool.getCommand(UpdateTimestampsCommandType)
             << commandPool.getCommand(InstallCommandType)
             << commandPool.getCommand(DumpNodesTreeCommandType)
+            << commandPool.getCommand(AffectedCommandType)
             << commandPool.getCommand(HelpCommandType);
 }
 
@@ -504,6 +522,7 @@ void CommandLineParser::CommandLineParserPrivate::setupBuildOptions()
     buildOptions.setMaxJobCount(jobsOption->jobCount());
     buildOptions.setLogElapsedTime(logTime);
     buildOptions.setEchoMode(echoMode());
+    buildOptions.setStreamProcessOutput(optionPool.streamOutputOption()->enabled());
     buildOptions.setInstall(!optionPool.noInstallOption()->enabled());
     buildOptions.setRemoveExistingInstallation(optionPool.removeFirstoption()->enabled());
 }
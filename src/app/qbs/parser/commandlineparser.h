@@ -40,6 +40,7 @@ class BuildOptions;
 class CleanOptions;
 class GenerateOptions;
 class InstallOptions;
+class NodeTreeDumpOptions;
 class Settings;
 
 class CommandLineParser
@@ -61,6 +62,7 @@ public:
     CleanOptions cleanOptions(const QString &profile) const;
     GenerateOptions generateOptions() const;
     InstallOptions installOptions(const QString &profile) const;
+    NodeTreeDumpOptions nodeTreeDumpOptions() const;
     bool force() const;
     bool forceTimestampCheck() const;
     bool dryRun() const;
@@ -68,6 +70,7 @@ public:
     bool withNonDefaultProducts() const;
     bool buildBeforeInstalling() const;
     QStringList runArgs() const;
+    QStringList changedFiles() const;
     QStringList products() const;
     QList<QVariantMap> buildConfigurations() const;
     bool showProgress() const;
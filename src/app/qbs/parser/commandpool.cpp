@@ -77,6 +77,9 @@ qbs::Command *CommandPool::getCommand(CommandType type) const
         case DumpNodesTreeCommandType:
             command = new DumpNodesTreeCommand(m_optionPool);
             break;
+        case AffectedCommandType:
+            command = new AffectedCommand(m_optionPool);
+            break;
         case HelpCommandType:
             command = new HelpCommand(m_optionPool);
             break;
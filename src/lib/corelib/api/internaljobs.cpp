@@ -45,6 +45,7 @@
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
 #include <tools/error.h>
+#include <tools/metricscollector.h>
 #include <tools/progressobserver.h>
 #include <tools/preferences.h>
 #include <tools/qbsassert.h>
@@ -113,6 +114,9 @@ InternalJob::InternalJob(const Logger &logger, QObject *parent)
     , m_logger(logger)
     , m_timed(false)
 {
+    // A thread wrapper gets the logger of its synchronous job, so they share the collector.
+    if (!m_logger.metricsCollector())
+        m_logger.setMetricsCollector(MetricsCollectorPtr(new MetricsCollector));
 }
 
 InternalJob::~InternalJob()
@@ -135,10 +139,16 @@ void InternalJob::shareObserverWith(InternalJob *otherJob)
     m_observer = otherJob->m_observer;
 }
 
+Metrics InternalJob::metrics() const
+{
+    return m_logger.metricsCollector()->metrics();
+}
+
 void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project)
 {
     try {
         doSanityChecks(project, logger());
+        PhaseTimer phaseTimer(logger(), Metrics::BuildGraphStoring);
         project->store(logger());
     } catch (const ErrorInfo &error) {
         logger().printWarning(error);
@@ -357,6 +367,8 @@ void InternalBuildJob::build(const TopLevelProjectPtr &project,
     m_executor->moveToThread(executorThread);
     connect(m_executor, SIGNAL(reportCommandDescription(QString,QString)),
             this, SIGNAL(reportCommandDescription(QString,QString)));
+    connect(m_executor, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+            this, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)));
     connect(m_executor, SIGNAL(reportProcessResult(qbs::ProcessResult)),
             this, SIGNAL(reportProcessResult(qbs::ProcessResult)));
 
@@ -37,6 +37,7 @@
 #include <tools/cleanoptions.h>
 #include <tools/installoptions.h>
 #include <tools/error.h>
+#include <tools/metrics.h>
 #include <tools/setupprojectparameters.h>
 
 #include <QList>
@@ -66,6 +67,7 @@ public:
     void setError(const ErrorInfo &error) { m_error = error; }
 
     Logger logger() const { return m_logger; }
+    Metrics metrics() const;
     bool timed() const { return m_timed; }
     void shareObserverWith(InternalJob *otherJob);
 
@@ -149,6 +151,9 @@ public:
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const QString &commandDescription,
+                             const QString &executableFilePath, const QStringList &stdOut,
+                             const QStringList &stdErr);
     void reportProcessResult(const qbs::ProcessResult &result);
 
 protected:
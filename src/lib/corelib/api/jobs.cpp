@@ -156,6 +156,15 @@ ErrorInfo AbstractJob::error() const
     return internalJob()->error();
 }
 
+/*!
+ * \brief Returns the timings and counts collected by this job so far.
+ * The data is complete once the job has finished.
+ */
+Metrics AbstractJob::metrics() const
+{
+    return internalJob()->metrics();
+}
+
 /*!
  * \brief Cancels this job.
  * Note that the job might not finish immediately. If you need to make sure it has actually
@@ -283,6 +292,18 @@ void SetupProjectJob::finish()
  * The \a message parameter is the localized message to print.
  */
 
+/*!
+ * \fn void BuildJob::reportProcessOutput(const QString &commandDescription, const QString &executableFilePath, const QStringList &stdOut, const QStringList &stdErr)
+ * \brief Signals that a running external command has produced output.
+ * This signal is only emitted if \c BuildOptions::streamProcessOutput() is enabled, or for
+ * output that exceeded \c BuildOptions::processOutputSpillThreshold(); in the latter case,
+ * it is emitted after the program has finished.
+ * The \a stdOut and \a stdErr parameters contain the complete lines that have been written to
+ * the respective channel by the program at \a executableFilePath since the last report.
+ * The \a commandDescription parameter is the description of the command the program was
+ * started for; it is empty for commands that do not have one.
+ */
+
 /*!
  * \fn void BuildJob::reportProcessResult(const qbs::ProcessResult &result)
  * \brief Signals that an external command has finished.
@@ -295,6 +316,8 @@ BuildJob::BuildJob(const Logger &logger, QObject *parent)
     InternalBuildJob *job = static_cast<InternalBuildJob *>(internalJob());
     connect(job, SIGNAL(reportCommandDescription(QString,QString)),
             this, SIGNAL(reportCommandDescription(QString,QString)));
+    connect(job, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+            this, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)));
     connect(job, SIGNAL(reportProcessResult(qbs::ProcessResult)),
             this, SIGNAL(reportProcessResult(qbs::ProcessResult)));
 }
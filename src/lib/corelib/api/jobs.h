@@ -33,6 +33,7 @@
 #include "project.h"
 #include "../language/forward_decls.h"
 #include "../tools/error.h"
+#include "../tools/metrics.h"
 #include "../tools/qbs_export.h"
 
 #include <QObject>
@@ -63,6 +64,7 @@ public:
     State state() const { return m_state; }
 
     ErrorInfo error() const;
+    Metrics metrics() const;
 
 public slots:
     void cancel();
@@ -120,6 +122,9 @@ class QBS_EXPORT BuildJob : public AbstractJob
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const QString &commandDescription,
+                             const QString &executableFilePath, const QStringList &stdOut,
+                             const QStringList &stdErr);
     void reportProcessResult(const qbs::ProcessResult &result);
 
 private:
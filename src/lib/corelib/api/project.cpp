@@ -44,6 +44,7 @@
 #include <buildgraph/buildgraph.h>
 #include <buildgraph/command.h>
 #include <buildgraph/emptydirectoriesremover.h>
+#include <buildgraph/nodegraphdumper.h>
 #include <buildgraph/nodetreedumper.h>
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/productinstaller.h>
@@ -59,6 +60,7 @@
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/installoptions.h>
+#include <tools/nodetreedumpoptions.h>
 #include <tools/preferences.h>
 #include <tools/processresult.h>
 #include <tools/propertyfinder.h>
@@ -111,6 +113,20 @@ ProjectData ProjectPrivate::projectData()
     return m_projectData;
 }
 
+QList<ProductData> ProjectPrivate::takeChangedProducts()
+{
+    projectData();
+    QList<ProductData> changedProducts;
+    foreach (const ResolvedProductConstPtr &product, m_changedProducts) {
+        const ProductData &p = m_productDataCache.value(product);
+        if (p.isValid()) // Products in disabled sub-projects are not part of the project data.
+            changedProducts << p;
+    }
+    m_changedProducts.clear();
+    qSort(changedProducts);
+    return changedProducts;
+}
+
 static void addDependencies(QList<ResolvedProductPtr> &products)
 {
     for (int i = 0; i < products.count(); ++i) {
@@ -232,19 +248,12 @@ GroupData ProjectPrivate::findGroupData(const ProductData &product, const QStrin
     return GroupData();
 }
 
-GroupData ProjectPrivate::createGroupDataFromGroup(const GroupPtr &resolvedGroup)
+GroupData ProjectPrivate::createGroupDataFromGroup(const GroupConstPtr &resolvedGroup)
 {
     GroupData group;
     group.d->name = resolvedGroup->name;
     group.d->location = resolvedGroup->location;
-    foreach (const SourceArtifactConstPtr &sa, resolvedGroup->files)
-        group.d->sourceArtifacts << createApiSourceArtifact(sa);
-    if (resolvedGroup->wildcards) {
-        foreach (const SourceArtifactConstPtr &sa, resolvedGroup->wildcards->files)
-            group.d->sourceArtifactsFromWildcards << createApiSourceArtifact(sa);
-    }
-    qSort(group.d->sourceArtifacts);
-    qSort(group.d->sourceArtifactsFromWildcards);
+    group.d->pendingGroup = resolvedGroup;
     group.d->properties.d->m_map = resolvedGroup->properties;
     group.d->isEnabled = resolvedGroup->enabled;
     group.d->isValid = true;
@@ -300,6 +309,7 @@ void ProjectPrivate::addGroup(const ProductData &product, const QString &groupNa
         resolvedGroup->properties = resolvedProducts[i]->moduleProperties;
         resolvedGroup->overrideTags = false;
         resolvedProducts.at(i)->groups << resolvedGroup;
+        productChanged(resolvedProducts.at(i));
         products.at(i).d->groups << createGroupDataFromGroup(resolvedGroup);
         qSort(products.at(i).d->groups);
     }
@@ -453,8 +463,9 @@ void ProjectPrivate::addFiles(const ProductData &product, const GroupData &group
             foreach (const SourceArtifactConstPtr &sa, addedSourceArtifacts)
                 createArtifact(resolvedProduct, sa, logger);
         }
+        productChanged(resolvedProduct);
     }
-    doSanityChecks(internalProject, logger);
+    doSanityChecks(internalProject, groupContext.resolvedProducts, logger);
     QList<SourceArtifact> sourceArtifacts;
     QList<SourceArtifact> sourceArtifactsFromWildcards;
     foreach (const QString &fp, filesContext.absoluteFilePaths) {
@@ -506,8 +517,9 @@ void ProjectPrivate::removeFiles(const ProductData &product, const GroupData &gr
         removeFilesFromBuildGraph(groupContext.resolvedProducts.at(i), sourceArtifacts);
         foreach (const SourceArtifactPtr &sa, sourceArtifacts)
             groupContext.resolvedGroups.at(i)->files.removeOne(sa);
+        productChanged(groupContext.resolvedProducts.at(i));
     }
-    doSanityChecks(internalProject, logger);
+    doSanityChecks(internalProject, groupContext.resolvedProducts, logger);
 
     m_projectData.d.detach();
     updateInternalCodeLocations(internalProject, remover.itemPosition(), remover.lineOffset());
@@ -533,8 +545,9 @@ void ProjectPrivate::removeGroup(const ProductData &product, const GroupData &gr
         removeFilesFromBuildGraph(product, group->allFiles());
         const bool removed = product->groups.removeOne(group);
         QBS_CHECK(removed);
+        productChanged(product);
     }
-    doSanityChecks(internalProject, logger);
+    doSanityChecks(internalProject, context.resolvedProducts, logger);
 
     m_projectData.d.detach();
     updateInternalCodeLocations(internalProject, remover.itemPosition(), remover.lineOffset());
@@ -623,7 +636,7 @@ void ProjectPrivate::updateExternalCodeLocations(const ProjectData &project,
         updateExternalCodeLocations(subProject, changeLocation, lineOffset);
     foreach (const ProductData &product, project.products()) {
         updateLocationIfNecessary(product.d->location, changeLocation, lineOffset);
-        foreach (const GroupData &group, product.groups())
+        foreach (const GroupData &group, product.d->groups)
             updateLocationIfNecessary(group.d->location, changeLocation, lineOffset);
     }
 }
@@ -634,6 +647,18 @@ void ProjectPrivate::prepareChangeToProject()
         throw ErrorInfo(Tr::tr("A job is currently in process."));
     if (!m_projectData.isValid())
         retrieveProjectData(m_projectData, internalProject);
+
+    // The change will modify the resolved products and groups in place, so the data we already
+    // gave out must not be created from them lazily afterwards. Product data that is not in the
+    // cache anymore was evicted by an earlier change and has been loaded completely back then.
+    foreach (const ProductData &product, m_productDataCache)
+        product.d->loadAll();
+}
+
+void ProjectPrivate::productChanged(const ResolvedProductConstPtr &product)
+{
+    m_productDataCache.remove(product);
+    m_changedProducts << product;
 }
 
 RuleCommandList ProjectPrivate::ruleCommands(const ProductData &product,
@@ -689,52 +714,132 @@ RuleCommandList ProjectPrivate::ruleCommands(const ProductData &product,
                            "from input file '%2'.").arg(outputFileTag, inputFilePath));
 }
 
+ArtifactSet ProjectPrivate::artifactsAffectedByFiles(const QStringList &filePaths) const
+{
+    QStringList cleanFilePaths;
+    foreach (const QString &filePath, filePaths) {
+        const QString cleanFilePath = QDir::cleanPath(filePath);
+
+        // A change to a project file can affect anything.
+        if (internalProject->buildSystemFiles.contains(cleanFilePath)) {
+            ArtifactSet allArtifacts;
+            foreach (const ResolvedProductConstPtr &product, allEnabledInternalProducts(true))
+                allArtifacts.unite(ArtifactSet::fromNodeSet(product->buildData->nodes));
+            return allArtifacts;
+        }
+        cleanFilePaths << cleanFilePath;
+    }
+    if (!internalProject->buildData)
+        return ArtifactSet();
+    return internalProject->buildData->artifactsDependingOn(cleanFilePaths);
+}
+
+QList<ProductData> ProjectPrivate::affectedProducts(const QStringList &filePaths)
+{
+    QSet<const ResolvedProduct *> seenProducts;
+    QList<ProductData> products;
+    foreach (const Artifact * const artifact, artifactsAffectedByFiles(filePaths)) {
+        const ResolvedProductConstPtr product = artifact->product.toStrongRef();
+        if (seenProducts.contains(product.data()))
+            continue;
+        seenProducts << product.data();
+        products << productData(product);
+    }
+    qSort(products);
+    return products;
+}
+
+QList<TargetArtifact> ProjectPrivate::affectedTargetArtifacts(const QStringList &filePaths)
+{
+    QList<TargetArtifact> targetArtifacts;
+    foreach (Artifact * const artifact, artifactsAffectedByFiles(filePaths)) {
+        const ResolvedProductConstPtr product = artifact->product.toStrongRef();
+
+        // Cheaper than computing the product's target artifacts for every affected artifact.
+        if (!product->buildData->roots.contains(artifact)
+                || !artifact->fileTags().matches(product->fileTags)) {
+            continue;
+        }
+        targetArtifacts << createApiTargetArtifact(artifact);
+    }
+    qSort(targetArtifacts);
+    return targetArtifacts;
+}
+
 static bool productIsRunnable(const ResolvedProductConstPtr &product)
 {
     return product->fileTags.contains("application");
 }
 
+TargetArtifact ProjectPrivate::createApiTargetArtifact(const Artifact *artifact)
+{
+    TargetArtifact ta;
+    ta.d->filePath = artifact->filePath();
+    ta.d->fileTags = artifact->fileTags().toStringList();
+    ta.d->properties.d->m_map = artifact->properties;
+    ta.d->isValid = true;
+    return ta;
+}
+
+QList<TargetArtifact> ProjectPrivate::createTargetArtifacts(const ResolvedProductConstPtr &product)
+{
+    QList<TargetArtifact> targetArtifacts;
+    if (!product->enabled)
+        return targetArtifacts;
+    QBS_CHECK(product->buildData);
+    foreach (const Artifact * const a, product->targetArtifacts())
+        targetArtifacts << createApiTargetArtifact(a);
+    qSort(targetArtifacts);
+    return targetArtifacts;
+}
+
+ProductData ProjectPrivate::productData(const ResolvedProductConstPtr &resolvedProduct)
+{
+    const QList<TargetArtifact> targetArtifacts = createTargetArtifacts(resolvedProduct);
+    const ProductData cachedProduct = m_productDataCache.value(resolvedProduct);
+    if (cachedProduct.isValid() && cachedProduct.d->targetArtifacts == targetArtifacts)
+        return cachedProduct;
+
+    ProductData product;
+    if (cachedProduct.isValid()) {
+        // Only the build graph has changed, e.g. because rules were applied during a build.
+        product.d = new ProductDataPrivate(*cachedProduct.d);
+        product.d->targetArtifacts = targetArtifacts;
+        m_changedProducts << resolvedProduct;
+        m_productDataCache.insert(resolvedProduct, product);
+        return product;
+    }
+
+    product.d->type = resolvedProduct->fileTags.toStringList();
+    product.d->name = resolvedProduct->name;
+    product.d->targetName = resolvedProduct->targetName;
+    product.d->version = resolvedProduct->productProperties
+                                                    .value(QLatin1String("version")).toString();
+    product.d->profile = resolvedProduct->profile;
+    product.d->location = resolvedProduct->location;
+    product.d->isEnabled = resolvedProduct->enabled;
+    product.d->isRunnable = productIsRunnable(resolvedProduct);
+    product.d->properties = resolvedProduct->productProperties;
+    product.d->moduleProperties.d->m_map = resolvedProduct->moduleProperties;
+    product.d->pendingProduct = resolvedProduct;
+    product.d->targetArtifacts = targetArtifacts;
+    foreach (const ResolvedProductPtr &resolvedDependentProduct, resolvedProduct->dependencies)
+        product.d->dependencies << resolvedDependentProduct->name;
+    qSort(product.d->type);
+    qSort(product.d->dependencies);
+    product.d->isValid = true;
+    m_productDataCache.insert(resolvedProduct, product);
+    return product;
+}
+
 void ProjectPrivate::retrieveProjectData(ProjectData &projectData,
                                          const ResolvedProjectConstPtr &internalProject)
 {
     projectData.d->name = internalProject->name;
     projectData.d->location = internalProject->location;
     projectData.d->enabled = internalProject->enabled;
-    foreach (const ResolvedProductConstPtr &resolvedProduct, internalProject->products) {
-        ProductData product;
-        product.d->type = resolvedProduct->fileTags.toStringList();
-        product.d->name = resolvedProduct->name;
-        product.d->targetName = resolvedProduct->targetName;
-        product.d->version = resolvedProduct->productProperties
-                                                        .value(QLatin1String("version")).toString();
-        product.d->profile = resolvedProduct->profile;
-        product.d->location = resolvedProduct->location;
-        product.d->isEnabled = resolvedProduct->enabled;
-        product.d->isRunnable = productIsRunnable(resolvedProduct);
-        product.d->properties = resolvedProduct->productProperties;
-        product.d->moduleProperties.d->m_map = resolvedProduct->moduleProperties;
-        foreach (const GroupPtr &resolvedGroup, resolvedProduct->groups)
-            product.d->groups << createGroupDataFromGroup(resolvedGroup);
-        if (resolvedProduct->enabled) {
-            QBS_CHECK(resolvedProduct->buildData);
-            foreach (const Artifact * const a, resolvedProduct->targetArtifacts()) {
-                TargetArtifact ta;
-                ta.d->filePath = a->filePath();
-                ta.d->fileTags = a->fileTags().toStringList();
-                ta.d->properties.d->m_map = a->properties;
-                ta.d->isValid = true;
-                product.d->targetArtifacts << ta;
-            }
-        }
-        foreach (const ResolvedProductPtr &resolvedDependentProduct, resolvedProduct->dependencies)
-            product.d->dependencies << resolvedDependentProduct->name;
-        qSort(product.d->type);
-        qSort(product.d->groups);
-        qSort(product.d->targetArtifacts);
-        qSort(product.d->dependencies);
-        product.d->isValid = true;
-        projectData.d->products << product;
-    }
+    foreach (const ResolvedProductConstPtr &resolvedProduct, internalProject->products)
+        projectData.d->products << productData(resolvedProduct);
     foreach (const ResolvedProjectConstPtr &internalSubProject, internalProject->subProjects) {
         if (!internalSubProject->enabled)
             continue;
@@ -841,6 +946,19 @@ ProjectData Project::projectData() const
     return d->projectData();
 }
 
+/*!
+ * \brief Returns the products whose data has changed since the last call to this function.
+ * A product changes if files or groups are added to or removed from it, or if building it
+ * has altered its target artifacts. The data of products that did not change is shared between
+ * all results of \c projectData(), so an IDE only needs to refresh what is returned here.
+ * \sa qbs::Project::projectData()
+ */
+QList<ProductData> Project::changedProducts() const
+{
+    QBS_ASSERT(isValid(), return QList<ProductData>());
+    return d->takeChangedProducts();
+}
+
 /*!
  * \brief Returns the file path of the executable associated with the given product.
  * If the product is not an application, an empty string is returned.
@@ -1120,10 +1238,49 @@ RuleCommandList Project::ruleCommands(const ProductData &product,
     }
 }
 
+/*!
+ * \brief Returns the products whose build results depend on any of the given files.
+ * The file paths must be absolute. The query uses the build graph only, so it takes very
+ * little time, but it cannot know about files the build graph has not seen yet, e.g. headers
+ * that were not scanned because their includer has never been built.
+ * A changed project file affects all products.
+ */
+QList<ProductData> Project::affectedProducts(const QStringList &changedFiles) const
+{
+    QBS_ASSERT(isValid(), return QList<ProductData>());
+    return d->affectedProducts(changedFiles);
+}
+
+/*!
+ * \brief Returns the target artifacts whose build results depend on any of the given files.
+ * \sa qbs::Project::affectedProducts()
+ */
+QList<TargetArtifact> Project::affectedTargetArtifacts(const QStringList &changedFiles) const
+{
+    QBS_ASSERT(isValid(), return QList<TargetArtifact>());
+    return d->affectedTargetArtifacts(changedFiles);
+}
+
 ErrorInfo Project::dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products)
+{
+    return dumpNodesTree(outDevice, products, NodeTreeDumpOptions());
+}
+
+/*!
+ * \brief Writes the build graph nodes of the given products to \a outDevice.
+ * With the default options, the output is an indented tree. The other formats list every node
+ * only once and are meant to be processed by tools.
+ * \sa NodeTreeDumpOptions
+ */
+ErrorInfo Project::dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products,
+                                 const NodeTreeDumpOptions &options)
 {
     try {
-        NodeTreeDumper(outDevice).start(d->internalProducts(products));
+        const QList<ResolvedProductPtr> internalProducts = d->internalProducts(products);
+        if (options.format() == NodeTreeDumpOptions::TreeFormat)
+            NodeTreeDumper(outDevice).start(internalProducts);
+        else
+            NodeGraphDumper(outDevice, options).start(internalProducts);
     } catch (const ErrorInfo &e) {
         return e;
     }
@@ -58,12 +58,14 @@ class ILogSink;
 class InstallableFile;
 class InstallJob;
 class InstallOptions;
+class NodeTreeDumpOptions;
 class ProductData;
 class ProjectData;
 class RunEnvironment;
 class Settings;
 class SetupProjectJob;
 class SetupProjectParameters;
+class TargetArtifact;
 
 namespace Internal {
 class Logger;
@@ -86,6 +88,7 @@ public:
     bool isValid() const;
     QString profile() const;
     ProjectData projectData() const;
+    QList<ProductData> changedProducts() const;
     QString targetExecutable(const ProductData &product,
                              const InstallOptions &installoptions) const;
     RunEnvironment getRunEnvironment(const ProductData &product,
@@ -135,7 +138,12 @@ public:
     RuleCommandList ruleCommands(const ProductData &product, const QString &inputFilePath,
                                  const QString &outputFileTag, ErrorInfo *error = 0) const;
 
+    QList<ProductData> affectedProducts(const QStringList &changedFiles) const;
+    QList<TargetArtifact> affectedTargetArtifacts(const QStringList &changedFiles) const;
+
     ErrorInfo dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products);
+    ErrorInfo dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products,
+                            const NodeTreeDumpOptions &options);
 
 #ifdef QBS_ENABLE_PROJECT_FILE_UPDATES
     ErrorInfo addGroup(const ProductData &product, const QString &groupName);
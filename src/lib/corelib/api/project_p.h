@@ -36,7 +36,9 @@
 #include <language/language.h>
 #include <logging/logger.h>
 
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
 
 namespace qbs {
@@ -48,6 +50,8 @@ class InstallJob;
 class InstallOptions;
 
 namespace Internal {
+class Artifact;
+class ArtifactSet;
 
 class ProjectPrivate : public QSharedData
 {
@@ -58,6 +62,7 @@ public:
     }
 
     ProjectData projectData();
+    QList<ProductData> takeChangedProducts();
     BuildJob *buildProducts(const QList<ResolvedProductPtr> &products, const BuildOptions &options,
                             bool needsDepencencyResolving,
                             QObject *jobOwner);
@@ -73,8 +78,9 @@ public:
     QList<ProductData> findProductsByName(const QString &name) const;
     GroupData findGroupData(const ProductData &product, const QString &groupName) const;
 
-    GroupData createGroupDataFromGroup(const GroupPtr &resolvedGroup);
-    SourceArtifact createApiSourceArtifact(const SourceArtifactConstPtr &sa);
+    static GroupData createGroupDataFromGroup(const GroupConstPtr &resolvedGroup);
+    static SourceArtifact createApiSourceArtifact(const SourceArtifactConstPtr &sa);
+    static TargetArtifact createApiTargetArtifact(const Artifact *artifact);
 
     struct GroupUpdateContext {
         QList<ResolvedProductPtr> resolvedProducts;
@@ -106,9 +112,13 @@ public:
     void updateExternalCodeLocations(const ProjectData &project,
                                      const CodeLocation &changeLocation, int lineOffset);
     void prepareChangeToProject();
+    void productChanged(const ResolvedProductConstPtr &product);
 
     RuleCommandList ruleCommands(const ProductData &product,
             const QString &inputFilePath, const QString &outputFileTag) const;
+    ArtifactSet artifactsAffectedByFiles(const QStringList &filePaths) const;
+    QList<ProductData> affectedProducts(const QStringList &filePaths);
+    QList<TargetArtifact> affectedTargetArtifacts(const QStringList &filePaths);
 
     TopLevelProjectPtr internalProject;
     Logger logger;
@@ -116,8 +126,16 @@ public:
 private:
     void retrieveProjectData(ProjectData &projectData,
                              const ResolvedProjectConstPtr &internalProject);
+    ProductData productData(const ResolvedProductConstPtr &resolvedProduct);
+    static QList<TargetArtifact> createTargetArtifacts(const ResolvedProductConstPtr &product);
 
     ProjectData m_projectData;
+
+    // Product data is handed out again as long as the respective product does not change,
+    // so that clients can cheaply find out what is different in a new ProjectData object.
+    // The keys keep the resolved products alive, so their addresses cannot be reused.
+    QHash<ResolvedProductConstPtr, ProductData> m_productDataCache;
+    QSet<ResolvedProductConstPtr> m_changedProducts;
 };
 
 } // namespace Internal
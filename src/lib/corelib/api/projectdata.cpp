@@ -30,7 +30,9 @@
 #include "projectdata.h"
 
 #include "projectdata_p.h"
+#include "project_p.h"
 #include "propertymap_p.h"
+#include <language/language.h>
 #include <language/propertymapinternal.h>
 #include <tools/fileinfo.h>
 #include <tools/propertyfinder.h>
@@ -40,6 +42,64 @@
 #include <algorithm>
 
 namespace qbs {
+namespace Internal {
+
+GroupDataPrivate::GroupDataPrivate(const GroupDataPrivate &other)
+    : QSharedData(other), name(other.name), location(other.location),
+      properties(other.properties), isEnabled(other.isEnabled), isValid(other.isValid)
+{
+    other.loadSourceArtifacts();
+    sourceArtifacts = other.sourceArtifacts;
+    sourceArtifactsFromWildcards = other.sourceArtifactsFromWildcards;
+}
+
+void GroupDataPrivate::loadSourceArtifacts() const
+{
+    QMutexLocker locker(&loadMutex);
+    if (!pendingGroup)
+        return;
+    foreach (const SourceArtifactConstPtr &sa, pendingGroup->files)
+        sourceArtifacts << ProjectPrivate::createApiSourceArtifact(sa);
+    if (pendingGroup->wildcards) {
+        foreach (const SourceArtifactConstPtr &sa, pendingGroup->wildcards->files)
+            sourceArtifactsFromWildcards << ProjectPrivate::createApiSourceArtifact(sa);
+    }
+    qSort(sourceArtifacts);
+    qSort(sourceArtifactsFromWildcards);
+    pendingGroup.clear();
+}
+
+ProductDataPrivate::ProductDataPrivate(const ProductDataPrivate &other)
+    : QSharedData(other), type(other.type), dependencies(other.dependencies), name(other.name),
+      targetName(other.targetName), version(other.version), profile(other.profile),
+      location(other.location), properties(other.properties),
+      moduleProperties(other.moduleProperties), targetArtifacts(other.targetArtifacts),
+      isEnabled(other.isEnabled), isRunnable(other.isRunnable), isValid(other.isValid)
+{
+    // The copy shares the group data with the original.
+    other.loadGroups();
+    groups = other.groups;
+}
+
+void ProductDataPrivate::loadGroups() const
+{
+    QMutexLocker locker(&loadMutex);
+    if (!pendingProduct)
+        return;
+    foreach (const GroupPtr &resolvedGroup, pendingProduct->groups)
+        groups << ProjectPrivate::createGroupDataFromGroup(resolvedGroup);
+    qSort(groups);
+    pendingProduct.clear();
+}
+
+void ProductDataPrivate::loadAll() const
+{
+    loadGroups();
+    foreach (const GroupData &group, groups)
+        group.d->loadSourceArtifacts();
+}
+
+} // namespace Internal
 
 /*!
  * \class GroupData
@@ -95,6 +155,7 @@ QString GroupData::name() const
  */
 QList<SourceArtifact> GroupData::sourceArtifacts() const
 {
+    d->loadSourceArtifacts();
     return d->sourceArtifacts;
 }
 
@@ -103,6 +164,7 @@ QList<SourceArtifact> GroupData::sourceArtifacts() const
  */
 QList<SourceArtifact> GroupData::sourceArtifactsFromWildcards() const
 {
+    d->loadSourceArtifacts();
     return d->sourceArtifactsFromWildcards;
 }
 
@@ -424,6 +486,8 @@ bool operator<(const InstallableFile &file1, const InstallableFile &file2)
 /*!
  * \class ProductData
  * \brief The \c ProductData class corresponds to the Product item in a qbs source file.
+ * The groups of a product and the files in them are only collected when they are first asked
+ * for, so products an IDE never looks into cost next to nothing.
  */
 
 ProductData::ProductData() : d(new Internal::ProductDataPrivate)
@@ -521,6 +585,7 @@ QList<TargetArtifact> ProductData::targetArtifacts() const
  */
 QList<GroupData> ProductData::groups() const
 {
+    d->loadGroups();
     return d->groups;
 }
 
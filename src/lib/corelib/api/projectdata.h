@@ -109,6 +109,7 @@ QBS_EXPORT bool operator<(const SourceArtifact &ta1, const SourceArtifact &ta2);
 
 class QBS_EXPORT GroupData
 {
+    friend class Internal::ProductDataPrivate;
     friend class Internal::ProjectPrivate;
 public:
     GroupData();
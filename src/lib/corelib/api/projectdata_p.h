@@ -32,6 +32,9 @@
 
 #include "projectdata.h"
 
+#include <language/forward_decls.h>
+
+#include <QMutex>
 #include <QSharedData>
 
 namespace qbs {
@@ -42,11 +45,19 @@ class GroupDataPrivate : public QSharedData
 public:
     GroupDataPrivate() : isValid(false)
     { }
+    GroupDataPrivate(const GroupDataPrivate &other);
+
+    // Creates the source artifact lists from the resolved group on first access.
+    // GroupData objects are implicitly shared and may be read from several threads,
+    // which is why this happens under loadMutex.
+    void loadSourceArtifacts() const;
 
     QString name;
     CodeLocation location;
-    QList<SourceArtifact> sourceArtifacts;
-    QList<SourceArtifact> sourceArtifactsFromWildcards;
+    mutable GroupConstPtr pendingGroup; // Reset once the source artifacts are loaded.
+    mutable QList<SourceArtifact> sourceArtifacts;
+    mutable QList<SourceArtifact> sourceArtifactsFromWildcards;
+    mutable QMutex loadMutex;
     PropertyMap properties;
     bool isEnabled;
     bool isValid;
@@ -89,6 +100,14 @@ class ProductDataPrivate : public QSharedData
 public:
     ProductDataPrivate() : isValid(false)
     { }
+    ProductDataPrivate(const ProductDataPrivate &other);
+
+    // Creates the group list from the resolved product on first access. See above.
+    void loadGroups() const;
+
+    // Loads everything that is still pending, so the data no longer depends on the
+    // resolved objects, e.g. because these are about to be changed.
+    void loadAll() const;
 
     QStringList type;
     QStringList dependencies;
@@ -97,7 +116,9 @@ public:
     QString version;
     QString profile;
     CodeLocation location;
-    QList<GroupData> groups;
+    mutable ResolvedProductConstPtr pendingProduct; // Reset once the groups are loaded.
+    mutable QList<GroupData> groups;
+    mutable QMutex loadMutex;
     QVariantMap properties;
     PropertyMap moduleProperties;
     QList<TargetArtifact> targetArtifacts;
@@ -36,6 +36,7 @@
 #include <tools/error.h>
 
 #include <QObject>
+#include <QStringList>
 
 namespace qbs {
 class ErrorInfo;
@@ -62,6 +63,9 @@ public slots:
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const QString &commandDescription,
+                             const QString &executableFilePath, const QStringList &stdOut,
+                             const QStringList &stdErr);
     void finished(const qbs::ErrorInfo &err = ErrorInfo()); // !hasError() <=> command successful
 
 protected:
@@ -31,6 +31,7 @@
 
 #include "artifact.h"
 #include "artifactvisitor.h"
+#include "emptydirectoriesremover.h"
 #include "productbuilddata.h"
 #include "projectbuilddata.h"
 #include "transformer.h"
@@ -44,11 +45,12 @@
 #include <tools/qbsassert.h>
 
 #include <QCoreApplication>
-#include <QDir>
-#include <QDirIterator>
 #include <QFileInfo>
+#include <QRunnable>
 #include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QThreadPool>
 
 namespace qbs {
 namespace Internal {
@@ -86,6 +88,38 @@ static void removeArtifactFromDisk(Artifact *artifact, bool dryRun, const Logger
         throw ErrorInfo(errorMessage);
 }
 
+// Removes a batch of files from disk. Run in a worker thread, so it must not touch the build graph.
+class FileRemovalTask : public QRunnable
+{
+public:
+    FileRemovalTask(const QStringList &filePaths) : m_filePaths(filePaths)
+    {
+        setAutoDelete(false);
+    }
+
+    const QStringList &removedFiles() const { return m_removedFiles; }
+    const QStringList &errors() const { return m_errors; }
+
+private:
+    void run()
+    {
+        foreach (const QString &filePath, m_filePaths) {
+            const QFileInfo fileInfo(filePath);
+            if (!FileInfo::fileExists(fileInfo))
+                continue;
+            QString errorMessage;
+            if (removeFileRecursion(fileInfo, &errorMessage))
+                m_removedFiles << filePath;
+            else
+                m_errors << errorMessage;
+        }
+    }
+
+    const QStringList m_filePaths;
+    QStringList m_removedFiles;
+    QStringList m_errors;
+};
+
 class CleanupVisitor : public ArtifactVisitor
 {
 public:
@@ -95,18 +129,21 @@ public:
         , m_options(options)
         , m_observer(observer)
         , m_logger(logger)
-        , m_hasError(false)
+        , m_allInProductBuildDir(true)
     {
     }
 
     void visitProduct(const ResolvedProductConstPtr &product)
     {
         m_product = product;
+        m_productBuildDir = product->buildDirectory() + QLatin1Char('/');
         ArtifactVisitor::visitProduct(product);
     }
 
-    const QSet<QString> &directories() const { return m_directories; }
-    bool hasError() const { return m_hasError; }
+    const QStringList &filesToRemove() const { return m_filesToRemove; }
+
+    // True if all files to remove are located in the product's build directory.
+    bool allInProductBuildDir() const { return m_allInProductBuildDir; }
 
 private:
     void doVisit(Artifact *artifact)
@@ -123,25 +160,40 @@ private:
                     return;
             }
         }
-        try {
-            removeArtifactFromDisk(artifact, m_options.dryRun(), m_logger);
-        } catch (const ErrorInfo &error) {
-            if (!m_options.keepGoing())
-                throw;
-            m_logger.printWarning(error);
-            m_hasError = true;
+        if (m_options.dryRun()) {
+            removeArtifactFromDisk(artifact, true, m_logger);
+
+            // Remembered so that the directories that would become empty can be listed.
+            m_filesToRemove << artifact->filePath();
+            return;
         }
-        m_directories << artifact->dirPath();
+
+        // The actual removal happens in bulk later on.
+        invalidateArtifactTimestamp(artifact);
+        m_filesToRemove << artifact->filePath();
+        if (!artifact->filePath().startsWith(m_productBuildDir))
+            m_allInProductBuildDir = false;
     }
 
     const CleanOptions m_options;
     const ProgressObserver * const m_observer;
     Logger m_logger;
-    bool m_hasError;
+    bool m_allInProductBuildDir;
     ResolvedProductConstPtr m_product;
-    QSet<QString> m_directories;
+    QString m_productBuildDir;
+    QStringList m_filesToRemove;
 };
 
+static bool hasSourcesInBuildDir(const ResolvedProductConstPtr &product)
+{
+    const QString buildDir = product->buildDirectory() + QLatin1Char('/');
+    foreach (const SourceArtifactConstPtr &sa, product->allFiles()) {
+        if (sa->absoluteFilePath.startsWith(buildDir))
+            return true;
+    }
+    return false;
+}
+
 ArtifactCleaner::ArtifactCleaner(const Logger &logger, ProgressObserver *observer)
     : m_logger(logger), m_observer(observer)
 {
@@ -153,65 +205,80 @@ void ArtifactCleaner::cleanup(const TopLevelProjectPtr &project,
     m_hasError = false;
 
     const QString configString = Tr::tr(" for configuration %1").arg(project->id());
-    m_observer->initialize(Tr::tr("Cleaning up%1").arg(configString), products.count() + 1);
+    m_observer->initialize(Tr::tr("Cleaning up%1").arg(configString), products.count() + 2);
 
-    QSet<QString> directories;
+    QStringList filesToRemove;
     foreach (const ResolvedProductPtr &product, products) {
         CleanupVisitor visitor(options, m_observer, m_logger);
         visitor.visitProduct(product);
-        directories.unite(visitor.directories());
-        if (visitor.hasError())
-            m_hasError = true;
+
+        // If the product's build directory holds nothing but artifacts that are to be removed,
+        // a single tree removal is much cheaper than deleting them one by one.
+        if (options.cleanType() == CleanOptions::CleanupAll && !options.dryRun()
+                && visitor.allInProductBuildDir() && !hasSourcesInBuildDir(product)) {
+            filesToRemove << product->buildDirectory();
+        } else {
+            filesToRemove << visitor.filesToRemove();
+        }
         m_observer->incrementProgressValue();
     }
 
-    // Directories created during the build are not artifacts (TODO: should they be?),
-    // so we have to clean them up manually.
-    QList<QString> dirList = directories.toList();
-    for (int i = 0; i < dirList.count(); ++i) {
-        const QString &dir = dirList.at(i);
-        if (!dir.startsWith(project->buildDirectory))
-            continue;
-        if (FileInfo(dir).exists())
-            removeEmptyDirectories(dir, options);
-        if (dir != project->buildDirectory) {
-            const QString parentDir = QDir::cleanPath(dir + QLatin1String("/.."));
-            if (parentDir != project->buildDirectory && !dirList.contains(parentDir))
-                dirList << parentDir;
+    EmptyDirectoriesRemover emptyDirectoriesRemover(project.data(), m_logger);
+    if (options.dryRun()) {
+        m_observer->incrementProgressValue();
+        foreach (const QString &dirPath,
+                 emptyDirectoriesRemover.emptyParentDirectoriesAfterRemoval(filesToRemove)) {
+            printRemovalMessage(dirPath, true, m_logger);
         }
+        m_observer->incrementProgressValue();
+    } else {
+        removeFiles(filesToRemove, options);
+        m_observer->incrementProgressValue();
+
+        // Directories created during the build are not artifacts (TODO: should they be?),
+        // so we have to clean them up manually.
+        emptyDirectoriesRemover.removeEmptyParentDirectories(filesToRemove);
+        m_observer->incrementProgressValue();
     }
-    m_observer->incrementProgressValue();
 
     if (m_hasError)
         throw ErrorInfo(Tr::tr("Failed to remove some files."));
     m_observer->setFinished();
 }
 
-void ArtifactCleaner::removeEmptyDirectories(const QString &rootDir, const CleanOptions &options,
-                                             bool *isEmpty)
+void ArtifactCleaner::removeFiles(const QStringList &filePaths, const CleanOptions &options)
 {
-    bool subTreeIsEmpty = true;
-    QDirIterator it(rootDir, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot);
-    while (it.hasNext()) {
-        it.next();
-        if (!it.fileInfo().isSymLink() && it.fileInfo().isDir())
-            removeEmptyDirectories(it.filePath(), options, &subTreeIsEmpty);
-        else
-            subTreeIsEmpty = false;
-    }
-    if (subTreeIsEmpty) {
-        printRemovalMessage(rootDir, options.dryRun(), m_logger);
-        if (!QDir::root().rmdir(rootDir)) {
-            ErrorInfo error(Tr::tr("Failure to remove empty directory '%1'.").arg(rootDir));
-            if (!options.keepGoing())
-                throw error;
-            m_logger.printWarning(error);
-            m_hasError = true;
-            subTreeIsEmpty = false;
-        }
+    if (filePaths.isEmpty())
+        return;
+    if (m_observer->canceled())
+        throw ErrorInfo(Tr::tr("Cleaning up was canceled."));
+
+    // Unlinking is dominated by file system latency, so we issue the requests from several
+    // threads at once. Batching keeps the scheduling overhead low.
+    static const int batchSize = 64;
+    QList<FileRemovalTask *> tasks;
+    for (int i = 0; i < filePaths.count(); i += batchSize)
+        tasks << new FileRemovalTask(filePaths.mid(i, batchSize));
+    QThreadPool threadPool;
+    foreach (FileRemovalTask * const task, tasks)
+        threadPool.start(task);
+    threadPool.waitForDone();
+
+    QStringList errors;
+    foreach (const FileRemovalTask * const task, tasks) {
+        foreach (const QString &filePath, task->removedFiles())
+            printRemovalMessage(filePath, false, m_logger);
+        errors << task->errors();
     }
-    if (!subTreeIsEmpty && isEmpty)
-        *isEmpty = false;
+    qDeleteAll(tasks);
+
+    if (errors.isEmpty())
+        return;
+    if (!options.keepGoing())
+        throw ErrorInfo(errors.first());
+    foreach (const QString &error, errors)
+        m_logger.printWarning(ErrorInfo(error));
+    m_hasError = true;
 }
 
 } // namespace Internal
@@ -31,6 +31,7 @@
 #define QBS_ARTIFACTCLEANER_H
 
 #include <QList>
+#include <QStringList>
 
 #include <language/forward_decls.h>
 #include <logging/logger.h>
@@ -49,8 +50,7 @@ public:
                  const CleanOptions &options);
 
 private:
-    void removeEmptyDirectories(const QString &rootDir, const CleanOptions &options,
-                                bool *isEmpty = 0);
+    void removeFiles(const QStringList &filePaths, const CleanOptions &options);
 
     Logger m_logger;
     bool m_hasError;
@@ -249,7 +249,9 @@ void connect(BuildGraphNode *p, BuildGraphNode *c)
     }
     p->children.insert(c);
     c->parents.insert(p);
-    p->product->topLevelProject()->buildData->isDirty = true;
+    ProjectBuildData * const buildData = p->product->topLevelProject()->buildData.data();
+    buildData->isDirty = true;
+    buildData->topologicalOrder.edgeAdded(p, c);
 }
 
 void loggedConnect(BuildGraphNode *u, BuildGraphNode *v, const Logger &logger)
@@ -300,7 +302,12 @@ bool safeConnect(Artifact *u, Artifact *v, const Logger &logger)
                              .arg(relativeArtifactFileName(u), relativeArtifactFileName(v));
     }
 
-    if (existsPath(v, u)) {
+    // Usually, the topological order tells us right away that there can be no cycle.
+    const TopLevelProject * const project = u->product->topLevelProject();
+    TopologicalOrder &order = project->buildData->topologicalOrder;
+    const bool createsCycle = order.ensureValid(project, QList<BuildGraphNode *>() << u << v)
+            ? !order.prepareEdge(u, v) : existsPath(v, u);
+    if (createsCycle) {
         QList<BuildGraphNode *> circle;
         findPath(v, u, circle);
         logger.qbsTrace() << "[BG] safeConnect: circle detected " << toStringList(circle);
@@ -541,5 +548,31 @@ void doSanityChecks(const ResolvedProjectPtr &project, const Logger &logger)
     doSanityChecks(project, allProducts, productNames, logger);
 }
 
+void doSanityChecks(const ResolvedProjectPtr &project, const QList<ResolvedProductPtr> &products,
+                    const Logger &logger)
+{
+    const QList<ResolvedProductPtr> allProductsList = project->allProducts();
+    const QSet<ResolvedProductPtr> allProducts = allProductsList.toSet();
+    const QSet<ResolvedProductPtr> changedProducts = products.toSet();
+
+    // Changes to the build graph of a product can also touch the nodes of products depending
+    // on it, but nothing beyond that.
+    QSet<ResolvedProductPtr> productsToCheck = changedProducts;
+    foreach (const ResolvedProductPtr &product, allProductsList) {
+        foreach (const ResolvedProductPtr &dependency, product->dependencies) {
+            if (changedProducts.contains(dependency)) {
+                productsToCheck << product;
+                break;
+            }
+        }
+    }
+
+    foreach (const ResolvedProductPtr &product, productsToCheck) {
+        QBS_CHECK(allProducts.contains(product));
+        QBS_CHECK(product->topLevelProject() == project->topLevelProject());
+        doSanityChecksForProduct(product, allProducts, logger);
+    }
+}
+
 } // namespace Internal
 } // namespace qbs
@@ -79,6 +79,8 @@ void setupScriptEngineForProduct(ScriptEngine *engine, const ResolvedProductCons
 QString relativeArtifactFileName(const Artifact *artifact); // Debugging helpers
 
 void doSanityChecks(const ResolvedProjectPtr &project, const Logger &logger);
+void doSanityChecks(const ResolvedProjectPtr &project, const QList<ResolvedProductPtr> &products,
+                    const Logger &logger);
 
 } // namespace Internal
 } // namespace qbs
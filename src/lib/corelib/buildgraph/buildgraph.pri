@@ -18,8 +18,10 @@ SOURCES += \
     $$PWD/filedependency.cpp \
     $$PWD/inputartifactscanner.cpp \
     $$PWD/jscommandexecutor.cpp \
+    $$PWD/nodegraphdumper.cpp \
     $$PWD/nodeset.cpp \
     $$PWD/nodetreedumper.cpp \
+    $$PWD/pathtable.cpp \
     $$PWD/processcommandexecutor.cpp \
     $$PWD/productbuilddata.cpp \
     $$PWD/productinstaller.cpp \
@@ -31,7 +33,9 @@ SOURCES += \
     $$PWD/rulesapplicator.cpp \
     $$PWD/rulesevaluationcontext.cpp \
     $$PWD/scanresultcache.cpp \
+    $$PWD/spawnedprocess.cpp \
     $$PWD/timestampsupdater.cpp \
+    $$PWD/topologicalorder.cpp \
     $$PWD/transformer.cpp
 
 HEADERS += \
@@ -54,8 +58,10 @@ HEADERS += \
     $$PWD/forward_decls.h \
     $$PWD/inputartifactscanner.h \
     $$PWD/jscommandexecutor.h \
+    $$PWD/nodegraphdumper.h \
     $$PWD/nodeset.h \
     $$PWD/nodetreedumper.h \
+    $$PWD/pathtable.h \
     $$PWD/processcommandexecutor.h \
     $$PWD/productbuilddata.h \
     $$PWD/productinstaller.h \
@@ -67,7 +73,9 @@ HEADERS += \
     $$PWD/rulesapplicator.h \
     $$PWD/rulesevaluationcontext.h \
     $$PWD/scanresultcache.h \
+    $$PWD/spawnedprocess.h \
     $$PWD/timestampsupdater.h \
+    $$PWD/topologicalorder.h \
     $$PWD/transformer.h
 
 qbs_enable_unit_tests {
@@ -43,8 +43,10 @@
 #include <language/language.h>
 #include <language/loader.h>
 #include <logging/translator.h>
+#include <tools/directorysnapshot.h>
+#include <tools/metricscollector.h>
 #include <tools/persistence.h>
-#include <tools/propertyfinder.h>
+#include <tools/propertypath.h>
 #include <tools/qbsassert.h>
 
 #include <QDir>
@@ -109,6 +111,7 @@ BuildGraphLoadResult BuildGraphLoader::load(const TopLevelProjectPtr &existingPr
 
 void BuildGraphLoader::loadBuildGraphFromDisk()
 {
+    PhaseTimer phaseTimer(m_logger, Metrics::BuildGraphLoading);
     const QString projectId = TopLevelProject::deriveId(m_parameters.topLevelProfile(),
                                                         m_parameters.finalBuildConfigurationTree());
     const QString buildDir
@@ -377,6 +380,7 @@ bool BuildGraphLoader::hasProductFileChanged(const QList<ResolvedProductPtr> &re
         QList<ResolvedProductPtr> &changedProducts)
 {
     bool hasChanged = false;
+    DirectorySnapshot directorySnapshot;
     foreach (const ResolvedProductPtr &product, restoredProducts) {
         const QString filePath = product->location.filePath();
         const FileInfo pfi(filePath);
@@ -389,15 +393,20 @@ bool BuildGraphLoader::hasProductFileChanged(const QList<ResolvedProductPtr> &re
             hasChanged = true;
         } else if (!changedProducts.contains(product)) {
             foreach (const GroupPtr &group, product->groups) {
-                if (!group->wildcards)
+                if (!group->wildcards || !group->wildcards->directoriesChanged())
                     continue;
-                const QSet<QString> files
-                        = group->wildcards->expandPatterns(group, product->sourceDirectory);
+                SourceWildCards::DirectoryTimeStamps dirTimeStamps;
+                const QSet<QString> files = group->wildcards->expandPatterns(
+                            product->sourceDirectory, &directorySnapshot, &dirTimeStamps);
                 QSet<QString> wcFiles;
                 foreach (const SourceArtifactConstPtr &sourceArtifact, group->wildcards->files)
                     wcFiles += sourceArtifact->absoluteFilePath;
-                if (files == wcFiles)
+                if (files == wcFiles) {
+                    // Remember the new state, so the directories are not listed again next time.
+                    group->wildcards->dirTimeStamps = dirTimeStamps;
+                    product->topLevelProject()->buildData->isDirty = true;
                     continue;
+                }
                 hasChanged = true;
                 changedProducts += product;
                 break;
@@ -591,11 +600,12 @@ static SourceArtifactConstPtr findSourceArtifact(const ResolvedProductConstPtr &
     return artifact;
 }
 
+// Module properties are looked up via the PropertyMapInternal object instead.
 static QVariantMap propertyMapByKind(const ResolvedProductConstPtr &product, Property::Kind kind)
 {
     switch (kind) {
     case Property::PropertyInModule:
-        return product->moduleProperties->value();
+        return QVariantMap();
     case Property::PropertyInProduct:
         return product->productProperties;
     case Property::PropertyInProject:
@@ -611,7 +621,8 @@ bool BuildGraphLoader::checkForPropertyChanges(const TransformerPtr &restoredTra
 {
     // This check must come first, as it can prevent build data rescuing.
     foreach (const Property &property, restoredTrafo->propertiesRequestedInCommands) {
-        if (checkForPropertyChange(property, propertyMapByKind(freshProduct, property.kind))) {
+        if (checkForPropertyChange(property, freshProduct->moduleProperties,
+                                   propertyMapByKind(freshProduct, property.kind))) {
             const JavaScriptCommandPtr &pseudoCommand = JavaScriptCommand::create();
             pseudoCommand->setSourceCode(QLatin1String("random stuff that will cause "
                                                        "commandsEqual() to fail"));
@@ -621,8 +632,10 @@ bool BuildGraphLoader::checkForPropertyChanges(const TransformerPtr &restoredTra
     }
 
     foreach (const Property &property, restoredTrafo->propertiesRequestedInPrepareScript) {
-        if (checkForPropertyChange(property, propertyMapByKind(freshProduct, property.kind)))
+        if (checkForPropertyChange(property, freshProduct->moduleProperties,
+                                   propertyMapByKind(freshProduct, property.kind))) {
             return true;
+        }
     }
 
     QMap<QString, SourceArtifactConstPtr> artifactMap;
@@ -634,33 +647,36 @@ bool BuildGraphLoader::checkForPropertyChanges(const TransformerPtr &restoredTra
         if (!artifact)
             continue;
         foreach (const Property &property, it.value()) {
-            if (checkForPropertyChange(property, artifact->properties->value()))
+            if (checkForPropertyChange(property, artifact->properties,
+                                       artifact->properties->value())) {
                 return true;
+            }
         }
     }
     return false;
 }
 
 bool BuildGraphLoader::checkForPropertyChange(const Property &restoredProperty,
+                                              const PropertyMapConstPtr &newModuleProperties,
                                               const QVariantMap &newProperties)
 {
-    PropertyFinder finder;
     QVariant v;
     switch (restoredProperty.kind) {
     case Property::PropertyInProduct:
     case Property::PropertyInProject:
         v = newProperties.value(restoredProperty.propertyName);
         break;
-    case Property::PropertyInModule:
-        if (restoredProperty.value.type() == QVariant::List) {
-            v = finder.propertyValues(newProperties, restoredProperty.moduleName,
-                                      restoredProperty.propertyName);
-        } else {
-            v = finder.propertyValue(newProperties, restoredProperty.moduleName,
-                                     restoredProperty.propertyName);
-        }
+    case Property::PropertyInModule: {
+        // The fresh maps are interned, so many transformers and artifacts share the same
+        // object. Going through it means every distinct property is looked up only once per map
+        // rather than once per transformer.
+        const PropertyPath path = PropertyPath::get(restoredProperty.moduleName,
+                restoredProperty.propertyName, restoredProperty.value.type() == QVariant::List
+                ? PropertyPath::MergedListValue : PropertyPath::ScalarValue);
+        v = newModuleProperties->moduleProperty(path);
         break;
     }
+    }
     if (restoredProperty.value != v) {
         m_logger.qbsDebug() << "Value for property '" << restoredProperty.moduleName << "."
                             << restoredProperty.propertyName << "' has changed.";
@@ -680,18 +696,10 @@ void BuildGraphLoader::replaceFileDependencyWithArtifact(const ResolvedProductPt
                                       "with artifact of type '%2'")
                              .arg(filedep->filePath()).arg(artifact->artifactType);
     }
-    foreach (const ResolvedProductPtr &product, fileDepProduct->topLevelProject()->allProducts()) {
-        if (!product->buildData)
-            continue;
-        foreach (Artifact *artifactInProduct, ArtifactSet::fromNodeSet(product->buildData->nodes)) {
-            if (artifactInProduct->fileDependencies.contains(filedep)) {
-                artifactInProduct->fileDependencies.remove(filedep);
-                loggedConnect(artifactInProduct, artifact, m_logger);
-            }
-        }
-    }
-    fileDepProduct->topLevelProject()->buildData->fileDependencies.remove(filedep);
-    fileDepProduct->topLevelProject()->buildData->removeFromLookupTable(filedep);
+    ProjectBuildData * const buildData = fileDepProduct->topLevelProject()->buildData.data();
+    foreach (Artifact *artifactInProduct, buildData->artifactsUsingFileDependency(filedep))
+        loggedConnect(artifactInProduct, artifact, m_logger);
+    buildData->removeFileDependency(filedep);
     m_objectsToDelete << filedep;
 }
 
@@ -98,6 +98,7 @@ private:
     bool checkForPropertyChanges(const TransformerPtr &restoredTrafo,
             const ResolvedProductPtr &freshProduct);
     bool checkForPropertyChange(const Property &restoredProperty,
+                                const PropertyMapConstPtr &newModuleProperties,
                                 const QVariantMap &newProperties);
     void replaceFileDependencyWithArtifact(const ResolvedProductPtr &fileDepProduct,
             FileDependency *filedep, Artifact *artifact);
@@ -42,7 +42,8 @@
 namespace qbs {
 namespace Internal {
 
-BuildGraphNode::BuildGraphNode() : buildState(Untouched)
+BuildGraphNode::BuildGraphNode()
+    : buildState(Untouched), topologicalIndex(0), topologicalOrderGeneration(0)
 {
 }
 
@@ -62,6 +62,10 @@ public:
 
     BuildState buildState;                  // Do not serialize. Will be refreshed for every build.
 
+    // Do not serialize. Maintained by TopologicalOrder.
+    int topologicalIndex;
+    int topologicalOrderGeneration;
+
     enum Type
     {
         ArtifactNodeType,
@@ -144,8 +144,16 @@ static QScriptValue js_Command(QScriptContext *context, QScriptEngine *engine)
                     engine->toScriptValue(commandPrototype->responseFileThreshold()));
     cmd.setProperty(QLatin1String("responseFileUsagePrefix"),
                     engine->toScriptValue(commandPrototype->responseFileUsagePrefix()));
+    cmd.setProperty(QLatin1String("inMemoryResponseFile"),
+                    engine->toScriptValue(commandPrototype->inMemoryResponseFile()));
+    cmd.setProperty(QLatin1String("usesJobServer"),
+                    engine->toScriptValue(commandPrototype->usesJobServer()));
     cmd.setProperty(QLatin1String("environment"),
                     engine->toScriptValue(commandPrototype->environment().toStringList()));
+    cmd.setProperty(QLatin1String("maxBatchSize"),
+                    engine->toScriptValue(commandPrototype->maxBatchSize()));
+    cmd.setProperty(QLatin1String("batchArguments"),
+                    engine->toScriptValue(commandPrototype->batchArguments()));
     return cmd;
 }
 
@@ -160,6 +168,9 @@ void ProcessCommand::setupForJavaScript(QScriptValue targetObject)
 ProcessCommand::ProcessCommand()
     : m_maxExitCode(0)
     , m_responseFileThreshold(HostOsInfo::isWindowsHost() ? 32000 : -1)
+    , m_inMemoryResponseFile(false)
+    , m_usesJobServer(false)
+    , m_maxBatchSize(1)
 {
 }
 
@@ -189,7 +200,52 @@ bool ProcessCommand::equals(const AbstractCommand *otherAbstractCommand) const
             && m_stderrFilterFunction == other->m_stderrFilterFunction
             && m_responseFileThreshold == other->m_responseFileThreshold
             && m_responseFileUsagePrefix == other->m_responseFileUsagePrefix
-            && m_environment == other->m_environment;
+            && m_inMemoryResponseFile == other->m_inMemoryResponseFile
+            && m_usesJobServer == other->m_usesJobServer
+            && m_environment == other->m_environment
+            && m_maxBatchSize == other->m_maxBatchSize
+            && m_batchArguments == other->m_batchArguments;
+}
+
+/*
+ * Two commands can be merged if they only differ in their per-input arguments.
+ * The description is not compared, as it typically mentions the input file.
+ */
+bool ProcessCommand::canBeBatchedWith(const ProcessCommand *other) const
+{
+    return isBatchable()
+            && highlight() == other->highlight()
+            && isSilent() == other->isSilent()
+            && properties() == other->properties()
+            && m_program == other->m_program
+            && m_arguments == other->m_arguments
+            && m_workingDir == other->m_workingDir
+            && m_maxExitCode == other->m_maxExitCode
+            && m_stdoutFilterFunction == other->m_stdoutFilterFunction
+            && m_stderrFilterFunction == other->m_stderrFilterFunction
+            && m_responseFileThreshold == other->m_responseFileThreshold
+            && m_responseFileUsagePrefix == other->m_responseFileUsagePrefix
+            && m_inMemoryResponseFile == other->m_inMemoryResponseFile
+            && m_usesJobServer == other->m_usesJobServer
+            && m_environment == other->m_environment
+            && m_maxBatchSize == other->m_maxBatchSize;
+}
+
+ProcessCommandPtr ProcessCommand::createBatchCommand(const QList<const ProcessCommand *> &commands)
+{
+    QBS_CHECK(!commands.isEmpty());
+    const ProcessCommand * const first = commands.first();
+    const ProcessCommandPtr batchCommand = ProcessCommandPtr(new ProcessCommand(*first));
+    QStringList descriptions;
+    foreach (const ProcessCommand * const cmd, commands) {
+        QBS_CHECK(cmd == first || first->canBeBatchedWith(cmd));
+        if (!cmd->description().isEmpty())
+            descriptions << cmd->description();
+        batchCommand->m_arguments += cmd->m_batchArguments;
+    }
+    batchCommand->setDescription(descriptions.join(QLatin1String("\n")));
+    batchCommand->m_batchArguments.clear();
+    return batchCommand;
 }
 
 void ProcessCommand::fillFromScriptValue(const QScriptValue *scriptValue, const CodeLocation &codeLocation)
@@ -217,9 +273,15 @@ void ProcessCommand::fillFromScriptValue(const QScriptValue *scriptValue, const
             .toInt32();
     m_responseFileUsagePrefix = scriptValue->property(QLatin1String("responseFileUsagePrefix"))
             .toString();
+    m_inMemoryResponseFile = scriptValue->property(QLatin1String("inMemoryResponseFile"))
+            .toBool();
+    m_usesJobServer = scriptValue->property(QLatin1String("usesJobServer")).toBool();
     QStringList envList = scriptValue->property(QLatin1String("environment")).toVariant()
             .toStringList();
     getEnvironmentFromList(envList);
+    m_maxBatchSize = scriptValue->property(QLatin1String("maxBatchSize")).toInt32();
+    m_batchArguments = scriptValue->property(QLatin1String("batchArguments")).toVariant()
+            .toStringList();
 
     m_predefinedProperties
             << QLatin1String("program")
@@ -230,7 +292,11 @@ void ProcessCommand::fillFromScriptValue(const QScriptValue *scriptValue, const
             << QLatin1String("stderrFilterFunction")
             << QLatin1String("responseFileThreshold")
             << QLatin1String("responseFileUsagePrefix")
-            << QLatin1String("environment");
+            << QLatin1String("inMemoryResponseFile")
+            << QLatin1String("usesJobServer")
+            << QLatin1String("environment")
+            << QLatin1String("maxBatchSize")
+            << QLatin1String("batchArguments");
     applyCommandProperties(scriptValue);
 }
 
@@ -244,7 +310,9 @@ void ProcessCommand::load(PersistentPool &pool)
     m_stdoutFilterFunction = pool.idLoadString();
     m_stderrFilterFunction = pool.idLoadString();
     m_responseFileUsagePrefix = pool.idLoadString();
-    pool.stream() >> m_maxExitCode >> m_responseFileThreshold;
+    m_batchArguments = pool.idLoadStringList();
+    pool.stream() >> m_maxExitCode >> m_responseFileThreshold >> m_inMemoryResponseFile
+                  >> m_usesJobServer >> m_maxBatchSize;
     getEnvironmentFromList(envList);
 }
 
@@ -258,7 +326,9 @@ void ProcessCommand::store(PersistentPool &pool) const
     pool.storeString(m_stdoutFilterFunction);
     pool.storeString(m_stderrFilterFunction);
     pool.storeString(m_responseFileUsagePrefix);
-    pool.stream() << m_maxExitCode << m_responseFileThreshold;
+    pool.storeStringList(m_batchArguments);
+    pool.stream() << m_maxExitCode << m_responseFileThreshold << m_inMemoryResponseFile
+                  << m_usesJobServer << m_maxBatchSize;
 }
 
 static QScriptValue js_JavaScriptCommand(QScriptContext *context, QScriptEngine *engine)
@@ -76,6 +76,7 @@ protected:
     void load(PersistentPool &pool);
     void store(PersistentPool &pool) const;
     void applyCommandProperties(const QScriptValue *scriptValue);
+    void setDescription(const QString &description) { m_description = description; }
 
     QSet<QString> m_predefinedProperties;
 
@@ -105,7 +106,15 @@ public:
     QString stderrFilterFunction() const { return m_stderrFilterFunction; }
     int responseFileThreshold() const { return m_responseFileThreshold; }
     QString responseFileUsagePrefix() const { return m_responseFileUsagePrefix; }
+    bool inMemoryResponseFile() const { return m_inMemoryResponseFile; }
+    bool usesJobServer() const { return m_usesJobServer; }
     QProcessEnvironment environment() const { return m_environment; }
+    int maxBatchSize() const { return m_maxBatchSize; }
+    QStringList batchArguments() const { return m_batchArguments; }
+
+    bool isBatchable() const { return m_maxBatchSize > 1; }
+    bool canBeBatchedWith(const ProcessCommand *other) const;
+    static ProcessCommandPtr createBatchCommand(const QList<const ProcessCommand *> &commands);
 
 private:
     ProcessCommand();
@@ -123,7 +132,11 @@ private:
     QString m_stderrFilterFunction;
     int m_responseFileThreshold; // When to use response files? In bytes of (program name + arguments).
     QString m_responseFileUsagePrefix;
+    bool m_inMemoryResponseFile;
+    bool m_usesJobServer; // Only such commands get the jobserver pipe and MAKEFLAGS.
     QProcessEnvironment m_environment;
+    int m_maxBatchSize; // How many commands of the same kind may be merged into one invocation.
+    QStringList m_batchArguments; // The per-input part of the command line.
 };
 
 class JavaScriptCommand : public AbstractCommand
@@ -34,6 +34,7 @@
 #include "buildgraph.h"
 
 #include <tools/error.h>
+#include <tools/scannerpluginmanager.h>
 #include <logging/translator.h>
 #include <language/language.h>
 #include <language/scriptengine.h>
@@ -42,6 +43,7 @@
 
 #include <QVariantMap>
 #include <QSet>
+#include <QVector>
 #include <QScriptContext>
 
 namespace qbs {
@@ -64,8 +66,21 @@ static void collectCppIncludePaths(const QVariantMap &modules, QSet<QString> *co
     }
 }
 
+QList<DependencyScanner::BatchScanResult> DependencyScanner::collectBatchDependencies(
+        const QList<FileResourceBase *> &files)
+{
+    QList<BatchScanResult> result;
+    foreach (FileResourceBase * const file, files) {
+        BatchScanResult fileResult;
+        fileResult.valid = true;
+        fileResult.dependencies = collectDependencies(file);
+        result << fileResult;
+    }
+    return result;
+}
+
 PluginDependencyScanner::PluginDependencyScanner(ScannerPlugin *plugin)
-    : m_plugin(plugin)
+    : m_plugin(plugin), m_batchPlugin(ScannerPluginManager::batchScanner(plugin))
 {
 }
 
@@ -81,32 +96,109 @@ QStringList PluginDependencyScanner::collectSearchPaths(Artifact *artifact)
     }
 }
 
+static void addDependency(QSet<QString> *dependencies, const QString &baseDirOfInFilePath,
+                          QString outFilePath, int flags)
+{
+    if (outFilePath.isEmpty())
+        return;
+    if (flags & SC_LOCAL_INCLUDE_FLAG) {
+        QString localFilePath = FileInfo::resolvePath(baseDirOfInFilePath, outFilePath);
+        if (FileInfo::exists(localFilePath))
+            outFilePath = localFilePath;
+    }
+    *dependencies += outFilePath;
+}
+
 QStringList PluginDependencyScanner::collectDependencies(FileResourceBase *file)
+{
+    if (m_batchPlugin)
+        return collectBatchDependencies(QList<FileResourceBase *>() << file).first().dependencies;
+
+    QStringList dependencies;
+    scanFile(file, &dependencies);
+    return dependencies;
+}
+
+// Returns false if the plugin could not scan the file.
+bool PluginDependencyScanner::scanFile(FileResourceBase *file, QStringList *dependencies)
 {
     QSet<QString> result;
     QString baseDirOfInFilePath = file->dirPath();
     const QString &filepath = file->filePath();
     void *scannerHandle = m_plugin->open(filepath.utf16(), ScanForDependenciesFlag);
     if (!scannerHandle)
-        return QStringList();
+        return false;
     forever {
         int flags = 0;
         int length = 0;
         const char *szOutFilePath = m_plugin->next(scannerHandle, &length, &flags);
         if (szOutFilePath == 0)
             break;
-        QString outFilePath = QString::fromLocal8Bit(szOutFilePath, length);
-        if (outFilePath.isEmpty())
+        addDependency(&result, baseDirOfInFilePath, QString::fromLocal8Bit(szOutFilePath, length),
+                      flags);
+    }
+    m_plugin->close(scannerHandle);
+    *dependencies = result.toList();
+    return true;
+}
+
+bool PluginDependencyScanner::supportsBatchScanning() const
+{
+    return m_batchPlugin;
+}
+
+QList<DependencyScanner::BatchScanResult> PluginDependencyScanner::collectBatchDependencies(
+        const QList<FileResourceBase *> &files)
+{
+    QList<BatchScanResult> result;
+
+    // Plugins implementing only version 1 of the interface get scanned file by file.
+    if (!m_batchPlugin) {
+        foreach (FileResourceBase * const file, files) {
+            BatchScanResult fileResult;
+            fileResult.valid = scanFile(file, &fileResult.dependencies);
+            result << fileResult;
+        }
+        return result;
+    }
+
+    QList<QByteArray> encodedFilePaths;
+    foreach (const FileResourceBase * const file, files)
+        encodedFilePaths << file->filePath().toUtf8();
+    QVector<const char *> filePaths;
+    filePaths.reserve(encodedFilePaths.count());
+    foreach (const QByteArray &encodedFilePath, encodedFilePaths)
+        filePaths << encodedFilePath.constData();
+
+    ScanBatchResult batchResult;
+    void * const batchHandle = m_batchPlugin->scanBatch(filePaths.constData(), filePaths.count(),
+                                                        ScanForDependenciesFlag, &batchResult);
+    if (!batchHandle) {
+        for (int i = 0; i < files.count(); ++i)
+            result << BatchScanResult();
+        return result;
+    }
+    for (int i = 0; i < files.count(); ++i) {
+        BatchScanResult fileResult;
+        fileResult.valid = batchResult.fileScanned[i];
+        if (!fileResult.valid) {
+            result << fileResult;
             continue;
-        if (flags & SC_LOCAL_INCLUDE_FLAG) {
-            QString localFilePath = FileInfo::resolvePath(baseDirOfInFilePath, outFilePath);
-            if (FileInfo::exists(localFilePath))
-                outFilePath = localFilePath;
         }
-        result += outFilePath;
+        QSet<QString> dependencies;
+        const QString baseDirOfInFilePath = files.at(i)->dirPath();
+        for (int j = batchResult.fileOffsets[i]; j < batchResult.fileOffsets[i + 1]; ++j) {
+            const ScanDependency &dependency = batchResult.dependencies[j];
+            addDependency(&dependencies, baseDirOfInFilePath,
+                          QString::fromLocal8Bit(batchResult.buffer + dependency.offset,
+                                                 dependency.size),
+                          dependency.flags);
+        }
+        fileResult.dependencies = dependencies.toList();
+        result << fileResult;
     }
-    m_plugin->close(scannerHandle);
-    return QStringList(result.toList());
+    m_batchPlugin->freeBatch(batchHandle);
+    return result;
 }
 
 bool PluginDependencyScanner::recursive() const
@@ -39,6 +39,7 @@
 #include <QScriptValue>
 
 class ScannerPlugin;
+class ScannerPluginV2;
 
 namespace qbs {
 namespace Internal {
@@ -51,12 +52,26 @@ class ScriptEngine;
 class DependencyScanner
 {
 public:
+    // The dependencies of one file of a batch. Not valid if the file could not be scanned.
+    struct BatchScanResult
+    {
+        BatchScanResult() : valid(false) {}
+
+        bool valid;
+        QStringList dependencies;
+    };
+
     virtual ~DependencyScanner() {}
 
     virtual QStringList collectSearchPaths(Artifact *artifact) = 0;
     virtual QStringList collectDependencies(FileResourceBase *file) = 0;
     virtual bool recursive() const = 0;
     virtual const void *key() const = 0;
+
+    // Scanning several files at once is only worth it if this returns true.
+    virtual bool supportsBatchScanning() const { return false; }
+    virtual QList<BatchScanResult> collectBatchDependencies(
+            const QList<FileResourceBase *> &files);
 };
 
 class PluginDependencyScanner : public DependencyScanner
@@ -69,8 +84,12 @@ private:
     QStringList collectDependencies(FileResourceBase *file);
     bool recursive() const;
     const void *key() const;
+    bool supportsBatchScanning() const;
+    QList<BatchScanResult> collectBatchDependencies(const QList<FileResourceBase *> &files);
+    bool scanFile(FileResourceBase *file, QStringList *dependencies);
 
     ScannerPlugin* m_plugin;
+    ScannerPluginV2 *m_batchPlugin;
 };
 
 class UserDependencyScanner : public DependencyScanner
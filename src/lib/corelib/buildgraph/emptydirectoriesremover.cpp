@@ -32,6 +32,7 @@
 #include "artifact.h"
 
 #include <language/language.h>
+#include <tools/fileinfo.h>
 
 #include <QDir>
 #include <QFileInfo>
@@ -41,16 +42,14 @@ namespace Internal {
 
 EmptyDirectoriesRemover::EmptyDirectoriesRemover(const TopLevelProject *project,
                                                  const Logger &logger)
-    : m_project(project), m_logger(logger)
+    : m_project(project), m_logger(logger), m_dryRun(false)
 {
 }
 
 void EmptyDirectoriesRemover::removeEmptyParentDirectories(const QStringList &artifactFilePaths)
 {
-    m_dirsToRemove.clear();
-    m_handledDirs.clear();
-    foreach (const QString &filePath, artifactFilePaths)
-        insertSorted(QFileInfo(filePath).absolutePath());
+    m_dryRun = false;
+    collectDirectories(artifactFilePaths);
     while (!m_dirsToRemove.isEmpty())
         removeDirIfEmpty();
 }
@@ -65,6 +64,32 @@ void EmptyDirectoriesRemover::removeEmptyParentDirectories(const ArtifactSet &ar
     removeEmptyParentDirectories(filePaths);
 }
 
+QStringList EmptyDirectoriesRemover::emptyParentDirectoriesAfterRemoval(
+        const QStringList &artifactFilePaths)
+{
+    m_dryRun = true;
+    m_removedPaths = artifactFilePaths.toSet();
+    m_removedDirs.clear();
+    collectDirectories(artifactFilePaths);
+    while (!m_dirsToRemove.isEmpty())
+        removeDirIfEmpty();
+    m_removedPaths.clear();
+    return m_removedDirs;
+}
+
+void EmptyDirectoriesRemover::collectDirectories(const QStringList &artifactFilePaths)
+{
+    m_dirsToRemove.clear();
+    m_handledDirs.clear();
+
+    // Many artifacts usually share a directory, so collect the distinct ones before sorting.
+    QSet<QString> dirPaths;
+    foreach (const QString &filePath, artifactFilePaths)
+        dirPaths << FileInfo::path(filePath);
+    foreach (const QString &dirPath, dirPaths)
+        insertSorted(dirPath);
+}
+
 // List is sorted so that "deeper" directories come first.
 void EmptyDirectoriesRemover::insertSorted(const QString &dirPath)
 {
@@ -88,12 +113,14 @@ void EmptyDirectoriesRemover::removeDirIfEmpty()
             || fi.filePath() == m_project->buildDirectory) {
         return;
     }
-    QDir dir(dirPath);
-    dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
-    if (dir.count() != 0)
+    if (!isEmpty(dirPath))
         return;
+    QDir dir(dirPath);
     dir.cdUp();
-    if (!dir.rmdir(fi.fileName())) {
+    if (m_dryRun) {
+        m_removedPaths << dirPath;
+        m_removedDirs << dirPath;
+    } else if (!dir.rmdir(fi.fileName())) {
         m_logger.qbsWarning() << QString::fromLocal8Bit("Cannot remove empty directory '%1'.")
                                  .arg(dirPath);
         return;
@@ -103,5 +130,19 @@ void EmptyDirectoriesRemover::removeDirIfEmpty()
         insertSorted(parentDir);
 }
 
+// In a dry run, entries that would have been removed already do not count.
+bool EmptyDirectoriesRemover::isEmpty(const QString &dirPath) const
+{
+    QDir dir(dirPath);
+    dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
+    if (!m_dryRun)
+        return dir.count() == 0;
+    foreach (const QString &entry, dir.entryList()) {
+        if (!m_removedPaths.contains(dirPath + QLatin1Char('/') + entry))
+            return false;
+    }
+    return true;
+}
+
 } // namespace Internal
 } // namespace qbs
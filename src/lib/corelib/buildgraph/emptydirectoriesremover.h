@@ -47,14 +47,23 @@ public:
     void removeEmptyParentDirectories(const QStringList &artifactFilePaths);
     void removeEmptyParentDirectories(const ArtifactSet &artifacts);
 
+    // Returns the directories that removeEmptyParentDirectories() would remove if the given
+    // files did not exist anymore. The file system is not touched.
+    QStringList emptyParentDirectoriesAfterRemoval(const QStringList &artifactFilePaths);
+
 private:
     void insertSorted(const QString &dirPath);
+    void collectDirectories(const QStringList &artifactFilePaths);
     void removeDirIfEmpty();
+    bool isEmpty(const QString &dirPath) const;
 
     const TopLevelProject * const m_project;
     Logger m_logger;
     QStringList m_dirsToRemove;
     QSet<QString> m_handledDirs;
+    bool m_dryRun;
+    QSet<QString> m_removedPaths;
+    QStringList m_removedDirs;
 };
 
 } // namespace Internal
@@ -46,14 +46,17 @@
 #include <language/language.h>
 #include <language/scriptengine.h>
 #include <logging/translator.h>
+#include <tools/directorylistingcache.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/jobserver.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
 
 #include <QDir>
 #include <QPair>
 #include <QSet>
+#include <QSocketNotifier>
 #include <QTimer>
 
 #include <algorithm>
@@ -62,9 +65,12 @@
 namespace qbs {
 namespace Internal {
 
-bool Executor::ComparePriority::operator() (const BuildGraphNode *x, const BuildGraphNode *y) const
+bool Executor::ComparePriority::operator() (const Leaf &x, const Leaf &y) const
 {
-    return x->product->buildData->buildPriority < y->product->buildData->buildPriority;
+    if (x.isGating != y.isGating)
+        return y.isGating;
+    return x.node->product->buildData->buildPriority
+            < y.node->product->buildData->buildPriority;
 }
 
 
@@ -74,6 +80,9 @@ Executor::Executor(const Logger &logger, QObject *parent)
     , m_logger(logger)
     , m_progressObserver(0)
     , m_state(ExecutorIdle)
+    , m_hasSpareJobToken(false)
+    , m_waitingForJobToken(false)
+    , m_jobTokenNotifier(0)
     , m_cancelationTimer(new QTimer(this))
     , m_doTrace(logger.traceEnabled())
     , m_doDebug(logger.debugEnabled())
@@ -82,6 +91,16 @@ Executor::Executor(const Logger &logger, QObject *parent)
     m_cancelationTimer->setSingleShot(false);
     m_cancelationTimer->setInterval(1000);
     connect(m_cancelationTimer, SIGNAL(timeout()), SLOT(checkForCancellation()));
+    connect(JobServer::instance(), SIGNAL(tokenReleased()), SLOT(onJobTokenReleased()),
+            Qt::QueuedConnection);
+
+    // Tokens given back by other processes can only be noticed by watching the pipe.
+    const int tokenFd = JobServer::instance()->tokenNotificationFd();
+    if (tokenFd != -1) {
+        m_jobTokenNotifier = new QSocketNotifier(tokenFd, QSocketNotifier::Read, this);
+        m_jobTokenNotifier->setEnabled(false);
+        connect(m_jobTokenNotifier, SIGNAL(activated(int)), SLOT(onJobTokenReleased()));
+    }
 }
 
 Executor::~Executor()
@@ -89,8 +108,10 @@ Executor::~Executor()
     // jobs must be destroyed before deleting the shared scan result cache
     foreach (ExecutorJob *job, m_availableJobs)
         delete job;
-    foreach (ExecutorJob *job, m_processingJobs.keys())
+    foreach (ExecutorJob *job, m_processingJobs.keys()) {
         delete job;
+        JobServer::instance()->releaseToken();
+    }
     delete m_inputArtifactScanContext;
     delete m_productInstaller;
 }
@@ -197,9 +218,13 @@ void Executor::doBuild()
     }
     QBS_CHECK(m_state == ExecutorIdle);
     m_leaves = Leaves();
+    m_sharedOutputs.clear();
+    m_transformersWaitingForSharedOutput.clear();
     m_changedSourceArtifacts.clear();
     m_error.clear();
     m_explicitlyCanceled = false;
+    m_waitingForJobToken = false;
+    m_processLaunchStatistics.reset();
     m_activeFileTags = FileTags::fromStringList(m_buildOptions.activeFileTags());
     m_artifactsRemovedFromDisk.clear();
     setState(ExecutorRunning);
@@ -211,6 +236,7 @@ void Executor::doBuild()
     }
 
     doSanityChecks();
+    DirectoryListingCache::instance()->startNewGeneration();
     m_evalContext = m_project->buildData->evaluationContext;
     if (!m_evalContext) { // Is null before the first build.
         m_evalContext = RulesEvaluationContextPtr(new RulesEvaluationContext(m_logger));
@@ -249,6 +275,37 @@ void Executor::setBuildOptions(const BuildOptions &buildOptions)
 }
 
 
+/*
+ * Artifacts that rules or transformers list in "explicitlyDependsOn" hold back every
+ * application of these rules. A typical example is a precompiled header, which all
+ * compiler invocations of a product wait for.
+ */
+void Executor::setupGatingFileTags()
+{
+    m_gatingFileTags.clear();
+    foreach (const ResolvedProductConstPtr &product, m_productsToBuild) {
+        foreach (const RulePtr &rule, product->rules)
+            m_gatingFileTags += rule->explicitlyDependsOn;
+        foreach (const ResolvedTransformerPtr &transformer, product->transformers)
+            m_gatingFileTags += transformer->explicitlyDependsOn;
+    }
+}
+
+bool Executor::isGatingNode(const BuildGraphNode *node) const
+{
+    if (m_gatingFileTags.isEmpty())
+        return false;
+    if (node->type() == BuildGraphNode::ArtifactNodeType)
+        return static_cast<const Artifact *>(node)->fileTags().matches(m_gatingFileTags);
+    return static_cast<const RuleNode *>(node)->rule()->collectedOutputFileTags()
+            .matches(m_gatingFileTags);
+}
+
+void Executor::addLeaf(BuildGraphNode *node)
+{
+    m_leaves.push(Leaf(node, isGatingNode(node)));
+}
+
 void Executor::initLeaves()
 {
     updateLeaves(m_roots);
@@ -287,7 +344,7 @@ void Executor::updateLeaves(BuildGraphNode *node, NodeSet &seenNodes)
     if (isLeaf) {
         if (m_doDebug)
             m_logger.qbsDebug() << "[EXEC] adding leaf " << node->toString();
-        m_leaves.push(node);
+        addLeaf(node);
     }
 }
 
@@ -296,7 +353,10 @@ bool Executor::scheduleJobs()
 {
     QBS_CHECK(m_state == ExecutorRunning);
     while (!m_leaves.empty() && !m_availableJobs.isEmpty()) {
-        BuildGraphNode * const nodeToBuild = m_leaves.top();
+        if (!acquireJobToken())
+            break;
+
+        BuildGraphNode * const nodeToBuild = m_leaves.top().node;
         m_leaves.pop();
 
         switch (nodeToBuild->buildState) {
@@ -322,7 +382,130 @@ bool Executor::scheduleJobs()
             break;
         }
     }
-    return !m_leaves.empty() || !m_processingJobs.isEmpty();
+
+    // All transformers that became ready in this round have been seen now, so the batches
+    // cannot grow any further.
+    startPendingBatches();
+
+    // Nodes that did not need a job leave the token unused; don't keep it from other builds.
+    if (m_hasSpareJobToken) {
+        m_hasSpareJobToken = false;
+        JobServer::instance()->releaseToken();
+    }
+    return !m_leaves.empty() || !m_processingJobs.isEmpty() || !m_pendingBatches.isEmpty();
+}
+
+bool Executor::acquireJobToken()
+{
+    if (m_hasSpareJobToken)
+        return true;
+    if (!JobServer::instance()->tryAcquireToken()) {
+        m_waitingForJobToken = true;
+        if (m_jobTokenNotifier)
+            m_jobTokenNotifier->setEnabled(true);
+        return false;
+    }
+    m_hasSpareJobToken = true;
+    return true;
+}
+
+/*
+ * Transformers whose single output gates other nodes can share that output with equivalent
+ * transformers in other products, e.g. a precompiled header built from the same header with
+ * the same flags. The key consists of everything that influences the output, with the path
+ * of the output itself masked. An empty key means the output cannot be shared.
+ */
+QString Executor::sharedOutputKey(const TransformerConstPtr &transformer) const
+{
+    if (transformer->outputs.count() != 1 || transformer->commands.isEmpty())
+        return QString();
+    const Artifact * const output = *transformer->outputs.begin();
+    if (!isGatingNode(output))
+        return QString();
+
+    const QString outputPlaceholder = QLatin1String("<output>");
+    QStringList keyParts = transformer->product()->buildEnvironment.toStringList();
+    keyParts.sort();
+    QStringList fileTags = output->fileTags().toStringList();
+    fileTags.sort();
+    keyParts << fileTags;
+    foreach (const AbstractCommandPtr &command, transformer->commands) {
+        if (command->type() != AbstractCommand::ProcessCommandType)
+            return QString();
+        const ProcessCommand * const processCommand
+                = static_cast<const ProcessCommand *>(command.data());
+        QStringList environment = processCommand->environment().toStringList();
+        environment.sort();
+        keyParts << processCommand->program() << processCommand->workingDir() << environment;
+        foreach (const QString &argument, processCommand->arguments())
+            keyParts << QString(argument).replace(output->filePath(), outputPlaceholder);
+    }
+    return keyParts.join(QLatin1String("\n"));
+}
+
+// Returns true if the transformer does not need to run, because an equivalent one
+// already did or currently does.
+bool Executor::shareOutput(const TransformerPtr &transformer, const QString &key)
+{
+    const Artifact * const sharedOutput = m_sharedOutputs.value(key);
+    if (sharedOutput) {
+        copySharedOutput(transformer, sharedOutput);
+        return true;
+    }
+
+    const QHash<QString, QList<TransformerPtr> >::Iterator it
+            = m_transformersWaitingForSharedOutput.find(key);
+    if (it == m_transformersWaitingForSharedOutput.end()) {
+        m_transformersWaitingForSharedOutput.insert(key, QList<TransformerPtr>());
+        return false;
+    }
+    if (m_doDebug) {
+        m_logger.qbsDebug() << "[EXEC] waiting for equivalent transformer to produce "
+                            << relativeArtifactFileName(*transformer->outputs.begin());
+    }
+    foreach (Artifact * const output, transformer->outputs)
+        output->buildState = BuildGraphNode::Building;
+    it.value() << transformer;
+    return true;
+}
+
+void Executor::finishSharedOutput(const TransformerPtr &transformer, const QString &key,
+                                  bool success)
+{
+    const QList<TransformerPtr> waitingTransformers
+            = m_transformersWaitingForSharedOutput.take(key);
+    if (success) {
+        Artifact * const output = *transformer->outputs.begin();
+        m_sharedOutputs.insert(key, output);
+        foreach (const TransformerPtr &waitingTransformer, waitingTransformers)
+            copySharedOutput(waitingTransformer, output);
+        return;
+    }
+
+    // The waiting transformers have to try on their own.
+    foreach (const TransformerPtr &waitingTransformer, waitingTransformers) {
+        foreach (Artifact * const output, waitingTransformer->outputs) {
+            output->buildState = BuildGraphNode::Buildable;
+            addLeaf(output);
+        }
+    }
+}
+
+void Executor::copySharedOutput(const TransformerPtr &transformer, const Artifact *source)
+{
+    Artifact * const output = *transformer->outputs.begin();
+    if (m_doDebug) {
+        m_logger.qbsDebug() << "[EXEC] reusing " << relativeArtifactFileName(source)
+                            << " as " << relativeArtifactFileName(output);
+    }
+    if (!m_buildOptions.dryRun()) {
+        QString errorMessage;
+        if (!copyFileRecursion(source->filePath(), output->filePath(), false, &errorMessage))
+            throw ErrorInfo(errorMessage);
+        m_project->buildData->isDirty = true;
+        output->setTimestamp(FileInfo(output->filePath()).lastModified());
+    }
+    finishTransformer(transformer);
 }
 
 bool Executor::isUpToDate(Artifact *artifact) const
@@ -502,19 +685,27 @@ void Executor::finishJob(ExecutorJob *job, bool success)
 
     const JobMap::Iterator it = m_processingJobs.find(job);
     QBS_CHECK(it != m_processingJobs.end());
-    const TransformerPtr transformer = it.value();
+    const QList<TransformerPtr> transformers = it.value();
     if (success) {
         m_project->buildData->isDirty = true;
-        foreach (Artifact *artifact, transformer->outputs) {
-            if (artifact->alwaysUpdated)
-                artifact->setTimestamp(FileTime::currentTime());
-            else
-                artifact->setTimestamp(FileInfo(artifact->filePath()).lastModified());
+        foreach (const TransformerPtr &transformer, transformers) {
+            foreach (Artifact *artifact, transformer->outputs) {
+                if (artifact->alwaysUpdated)
+                    artifact->setTimestamp(FileTime::currentTime());
+                else
+                    artifact->setTimestamp(FileInfo(artifact->filePath()).lastModified());
+            }
+            finishTransformer(transformer);
         }
-        finishTransformer(transformer);
+    }
+    foreach (const TransformerPtr &transformer, transformers) {
+        const QString key = sharedOutputKey(transformer);
+        if (!key.isEmpty())
+            finishSharedOutput(transformer, key, success);
     }
     m_processingJobs.erase(it);
     m_availableJobs.append(job);
+    JobServer::instance()->releaseToken();
 
     if (!success && !m_buildOptions.keepGoing())
         cancelJobs();
@@ -560,7 +751,7 @@ void Executor::finishNode(BuildGraphNode *leaf)
         }
 
         if (allChildrenBuilt(parent)) {
-            m_leaves.push(parent);
+            addLeaf(parent);
             if (m_doTrace) {
                 m_logger.qbsTrace() << "[EXEC] finishNode adds leaf "
                         << parent->toString() << " " << toString(parent->buildState);
@@ -621,6 +812,17 @@ void Executor::cancelJobs()
 {
     m_logger.qbsTrace() << "Canceling all jobs.";
     setState(ExecutorCanceling);
+    foreach (const QList<TransformerPtr> &batch, m_pendingBatches) {
+        foreach (const TransformerPtr &transformer, batch)
+            abandonTransformer(transformer);
+    }
+    m_pendingBatches.clear();
+    foreach (const QList<TransformerPtr> &waitingTransformers,
+             m_transformersWaitingForSharedOutput) {
+        foreach (const TransformerPtr &transformer, waitingTransformers)
+            abandonTransformer(transformer);
+    }
+    m_transformersWaitingForSharedOutput.clear();
     QList<ExecutorJob *> jobs = m_processingJobs.keys();
     foreach (ExecutorJob *job, jobs)
         job->cancel();
@@ -665,15 +867,22 @@ void Executor::addExecutorJobs()
 {
     m_logger.qbsDebug() << QString::fromLocal8Bit("[EXEC] preparing executor for %1 jobs "
                                                   "in parallel").arg(m_buildOptions.maxJobCount());
+    JobServer::instance()->ensureTokenCount(m_buildOptions.maxJobCount());
     for (int i = 1; i <= m_buildOptions.maxJobCount(); i++) {
         ExecutorJob *job = new ExecutorJob(m_logger, this);
         job->setMainThreadScriptEngine(m_evalContext->engine());
         job->setObjectName(QString::fromLatin1("J%1").arg(i));
         job->setDryRun(m_buildOptions.dryRun());
         job->setEchoMode(m_buildOptions.echoMode());
+        job->setOutputStreamingEnabled(m_buildOptions.streamProcessOutput());
+        job->setOutputSpillThreshold(m_buildOptions.processOutputSpillThreshold());
+        job->setProcessLaunchStatistics(&m_processLaunchStatistics);
         m_availableJobs.append(job);
         connect(job, SIGNAL(reportCommandDescription(QString,QString)),
                 this, SIGNAL(reportCommandDescription(QString,QString)), Qt::QueuedConnection);
+        connect(job, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+                this, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+                Qt::QueuedConnection);
         connect(job, SIGNAL(reportProcessResult(qbs::ProcessResult)),
                 this, SIGNAL(reportProcessResult(qbs::ProcessResult)), Qt::QueuedConnection);
         connect(job, SIGNAL(finished(qbs::ErrorInfo)),
@@ -844,9 +1053,25 @@ void Executor::potentiallyRunTransformer(const TransformerPtr &transformer)
             return;
     }
 
+    const QString key = sharedOutputKey(transformer);
+    if (!key.isEmpty() && shareOutput(transformer, key))
+        return;
+
     runTransformer(transformer);
 }
 
+// Returns the transformer's command if it may be merged with the commands of other transformers.
+static const ProcessCommand *batchableCommand(const TransformerConstPtr &transformer)
+{
+    if (transformer->commands.count() != 1
+            || transformer->commands.first()->type() != AbstractCommand::ProcessCommandType) {
+        return 0;
+    }
+    const ProcessCommand * const command
+            = static_cast<const ProcessCommand *>(transformer->commands.first().data());
+    return command->isBatchable() ? command : 0;
+}
+
 void Executor::runTransformer(const TransformerPtr &transformer)
 {
     QBS_CHECK(transformer);
@@ -864,12 +1089,63 @@ void Executor::runTransformer(const TransformerPtr &transformer)
         }
     }
 
-    QBS_CHECK(!m_availableJobs.isEmpty());
-    ExecutorJob *job = m_availableJobs.takeFirst();
     foreach (Artifact * const artifact, transformer->outputs)
         artifact->buildState = BuildGraphNode::Building;
-    m_processingJobs.insert(job, transformer);
-    job->run(transformer.data());
+
+    const ProcessCommand * const command = batchableCommand(transformer);
+    if (command)
+        addToBatch(transformer, command);
+    else
+        startJob(QList<TransformerPtr>() << transformer);
+}
+
+void Executor::addToBatch(const TransformerPtr &transformer, const ProcessCommand *command)
+{
+    for (int i = 0; i < m_pendingBatches.count(); ++i) {
+        QList<TransformerPtr> &batch = m_pendingBatches[i];
+        const TransformerPtr &first = batch.first();
+        if (first->rule != transformer->rule || first->product() != transformer->product()
+                || !batchableCommand(first)->canBeBatchedWith(command)) {
+            continue;
+        }
+        batch << transformer;
+        if (batch.count() >= command->maxBatchSize())
+            startJob(m_pendingBatches.takeAt(i));
+        return;
+    }
+    m_pendingBatches << (QList<TransformerPtr>() << transformer);
+}
+
+void Executor::startPendingBatches()
+{
+    while (!m_pendingBatches.isEmpty() && !m_availableJobs.isEmpty() && acquireJobToken())
+        startJob(m_pendingBatches.takeFirst());
+}
+
+void Executor::startJob(const QList<TransformerPtr> &transformers)
+{
+    QBS_CHECK(!transformers.isEmpty());
+    QBS_CHECK(!m_availableJobs.isEmpty());
+    QBS_CHECK(m_hasSpareJobToken);
+    m_hasSpareJobToken = false;
+    ExecutorJob *job = m_availableJobs.takeFirst();
+    m_processingJobs.insert(job, transformers);
+    if (transformers.count() == 1) {
+        job->run(transformers.first().data());
+        return;
+    }
+
+    if (m_doDebug) {
+        m_logger.qbsDebug() << "[EXEC] running " << transformers.count()
+                            << " transformers in one batch";
+    }
+    QList<Transformer *> batch;
+    QList<const ProcessCommand *> commands;
+    foreach (const TransformerPtr &transformer, transformers) {
+        batch << transformer.data();
+        commands << batchableCommand(transformer);
+    }
+    job->run(batch, ProcessCommand::createBatchCommand(commands));
 }
 
 void Executor::finishTransformer(const TransformerPtr &transformer)
@@ -880,10 +1156,24 @@ void Executor::finishTransformer(const TransformerPtr &transformer)
     }
 }
 
+// For transformers that were about to run when the build got canceled. Their outputs must not
+// stay in the "building" state, and the next build must not consider them up to date.
+void Executor::abandonTransformer(const TransformerPtr &transformer)
+{
+    foreach (Artifact * const output, transformer->outputs)
+        output->buildState = BuildGraphNode::Buildable;
+    if (m_buildOptions.dryRun())
+        return;
+    m_project->buildData->isDirty = true;
+    foreach (Artifact * const output, transformer->outputs)
+        output->clearTimestamp();
+}
+
 void Executor::possiblyInstallArtifact(const Artifact *artifact)
 {
-    if (m_buildOptions.install()
-            && artifact->properties->qbsPropertyValue(QLatin1String("install")).toBool()) {
+    static const PropertyPath installPath = PropertyPath::get(QLatin1String("qbs"),
+                                                              QLatin1String("install"));
+    if (m_buildOptions.install() && artifact->properties->moduleProperty(installPath).toBool()) {
             m_productInstaller->copyFile(artifact);
     }
 }
@@ -910,9 +1200,30 @@ void Executor::onJobFinished(const qbs::ErrorInfo &err)
     }
 }
 
+void Executor::onJobTokenReleased()
+{
+    if (m_jobTokenNotifier)
+        m_jobTokenNotifier->setEnabled(false); // The pipe stays readable until someone reads.
+    if (m_state != ExecutorRunning || !m_waitingForJobToken)
+        return;
+    m_waitingForJobToken = false;
+    try {
+        if (!scheduleJobs()) {
+            m_logger.qbsTrace() << "Nothing left to build; finishing.";
+            finish();
+        }
+    } catch (const ErrorInfo &error) {
+        handleError(error);
+    }
+}
+
 void Executor::finish()
 {
     QBS_ASSERT(m_state != ExecutorIdle, /* ignore */);
+    if (m_hasSpareJobToken) { // Running a transformer failed.
+        m_hasSpareJobToken = false;
+        JobServer::instance()->releaseToken();
+    }
 
     QList<ResolvedProductPtr> unbuiltProducts;
     foreach (const ResolvedProductPtr &product, m_productsToBuild) {
@@ -949,6 +1260,7 @@ void Executor::finish()
 
     if (m_explicitlyCanceled)
         m_error.append(Tr::tr("Build canceled%1.").arg(configString()));
+    logProcessLaunchStatistics();
     setState(ExecutorIdle);
     if (m_progressObserver) {
         m_progressObserver->setFinished();
@@ -961,12 +1273,30 @@ void Executor::finish()
     emit finished();
 }
 
+void Executor::logProcessLaunchStatistics() const
+{
+    const SpawnedProcess::Statistics stats = m_processLaunchStatistics.statistics();
+    if (stats.launchCount == 0)
+        return;
+    m_logger.qbsLog(m_buildOptions.logElapsedTime() ? LoggerInfo : LoggerDebug)
+            << QString::fromLocal8Bit("Started %1 processes using %2; launch time was "
+                                      "%3us on average and %4us at most.")
+               .arg(stats.launchCount)
+               .arg(QLatin1String(SpawnedProcess::usesPosixSpawn() ? "posix_spawn" : "QProcess"))
+               .arg(stats.totalLaunchTime / stats.launchCount / 1000)
+               .arg(stats.maxLaunchTime / 1000);
+}
+
 void Executor::checkForCancellation()
 {
     QBS_ASSERT(m_progressObserver, return);
     if (m_state == ExecutorRunning && m_progressObserver->canceled()) {
         cancelJobs();
         m_evalContext->engine()->cancel();
+
+        // We might have been waiting for a job token with no jobs running.
+        if (m_processingJobs.isEmpty())
+            finish();
     }
 }
 
@@ -1049,8 +1379,11 @@ void Executor::prepareProducts()
 {
     ProductPrioritySetter prioritySetter(m_project.data());
     prioritySetter.apply();
-    foreach (ResolvedProductPtr product, m_productsToBuild)
+    setupGatingFileTags();
+    foreach (ResolvedProductPtr product, m_productsToBuild) {
         product->setupBuildEnvironment(m_evalContext->engine(), m_project->environment);
+        product->clearCommandCaches();
+    }
 }
 
 void Executor::setupRootNodes()
@@ -33,6 +33,7 @@
 
 #include "forward_decls.h"
 #include "buildgraphvisitor.h"
+#include "spawnedprocess.h"
 #include <buildgraph/artifact.h>
 #include <buildgraph/scanresultcache.h>
 #include <language/forward_decls.h>
@@ -45,6 +46,7 @@
 #include <queue>
 
 QT_BEGIN_NAMESPACE
+class QSocketNotifier;
 class QTimer;
 QT_END_NAMESPACE
 
@@ -55,6 +57,7 @@ namespace Internal {
 class ExecutorJob;
 class FileTime;
 class InputArtifactScannerContext;
+class ProcessCommand;
 class ProductInstaller;
 class ProgressObserver;
 class RuleNode;
@@ -79,12 +82,16 @@ public:
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const QString &commandDescription,
+                             const QString &executableFilePath, const QStringList &stdOut,
+                             const QStringList &stdErr);
     void reportProcessResult(const qbs::ProcessResult &result);
 
     void finished();
 
 private slots:
     void onJobFinished(const qbs::ErrorInfo &err);
+    void onJobTokenReleased();
     void finish();
     void checkForCancellation();
 
@@ -95,12 +102,20 @@ private:
 
     enum ExecutorState { ExecutorIdle, ExecutorRunning, ExecutorCanceling };
 
+    struct Leaf
+    {
+        Leaf(BuildGraphNode *node, bool isGating) : node(node), isGating(isGating) {}
+
+        BuildGraphNode *node;
+        bool isGating; // Other rules explicitly depend on the node's outputs.
+    };
+
     struct ComparePriority
     {
-        bool operator() (const BuildGraphNode *x, const BuildGraphNode *y) const;
+        bool operator() (const Leaf &x, const Leaf &y) const;
     };
 
-    typedef std::priority_queue<Artifact *, std::vector<BuildGraphNode *>, ComparePriority> Leaves;
+    typedef std::priority_queue<Leaf, std::vector<Leaf>, ComparePriority> Leaves;
 
     void doBuild();
     void prepareAllNodes();
@@ -109,6 +124,9 @@ private:
     void prepareReachableNodes_impl(BuildGraphNode *node);
     void prepareProducts();
     void setupRootNodes();
+    void setupGatingFileTags();
+    bool isGatingNode(const BuildGraphNode *node) const;
+    void addLeaf(BuildGraphNode *node);
     void initLeaves();
     void updateLeaves(const NodeSet &nodes);
     void updateLeaves(BuildGraphNode *node, NodeSet &seenNodes);
@@ -124,11 +142,21 @@ private:
     void setupProgressObserver();
     void doSanityChecks();
     void handleError(const ErrorInfo &error);
+    void logProcessLaunchStatistics() const;
     void rescueOldBuildData(Artifact *artifact, bool *childrenAdded);
     bool checkForUnbuiltDependencies(Artifact *artifact);
     void potentiallyRunTransformer(const TransformerPtr &transformer);
     void runTransformer(const TransformerPtr &transformer);
+    void addToBatch(const TransformerPtr &transformer, const ProcessCommand *command);
+    void startPendingBatches();
+    void startJob(const QList<TransformerPtr> &transformers);
+    bool acquireJobToken();
+    QString sharedOutputKey(const TransformerConstPtr &transformer) const;
+    bool shareOutput(const TransformerPtr &transformer, const QString &key);
+    void finishSharedOutput(const TransformerPtr &transformer, const QString &key, bool success);
+    void copySharedOutput(const TransformerPtr &transformer, const Artifact *source);
     void finishTransformer(const TransformerPtr &transformer);
+    void abandonTransformer(const TransformerPtr &transformer);
     void possiblyInstallArtifact(const Artifact *artifact);
 
     bool mustExecuteTransformer(const TransformerPtr &transformer) const;
@@ -139,8 +167,12 @@ private:
     bool transformerHasMatchingOutputTags(const TransformerConstPtr &transformer) const;
     bool transformerHasMatchingInputFiles(const TransformerConstPtr &transformer) const;
 
-    typedef QHash<ExecutorJob *, TransformerPtr> JobMap;
+    typedef QHash<ExecutorJob *, QList<TransformerPtr> > JobMap;
     JobMap m_processingJobs;
+    QList<QList<TransformerPtr> > m_pendingBatches;
+    FileTags m_gatingFileTags;
+    QHash<QString, Artifact *> m_sharedOutputs;
+    QHash<QString, QList<TransformerPtr> > m_transformersWaitingForSharedOutput;
 
     ProductInstaller *m_productInstaller;
     RulesEvaluationContextPtr m_evalContext;
@@ -149,6 +181,10 @@ private:
     ProgressObserver *m_progressObserver;
     QList<ExecutorJob*> m_availableJobs;
     ExecutorState m_state;
+    bool m_hasSpareJobToken;
+    bool m_waitingForJobToken;
+    QSocketNotifier *m_jobTokenNotifier;
+    SpawnedProcess::StatisticsCollector m_processLaunchStatistics; // Per build.
     TopLevelProjectPtr m_project;
     QList<ResolvedProductPtr> m_productsToBuild;
     NodeSet m_roots;
@@ -48,9 +48,12 @@ ExecutorJob::ExecutorJob(const Logger &logger, QObject *parent)
     : QObject(parent)
     , m_processCommandExecutor(new ProcessCommandExecutor(logger, this))
     , m_jsCommandExecutor(new JsCommandExecutor(logger, this))
+    , m_metricsCollector(logger.metricsCollector())
 {
     connect(m_processCommandExecutor, SIGNAL(reportCommandDescription(QString,QString)),
             this, SIGNAL(reportCommandDescription(QString,QString)));
+    connect(m_processCommandExecutor, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+            this, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)));
     connect(m_processCommandExecutor, SIGNAL(reportProcessResult(qbs::ProcessResult)),
             this, SIGNAL(reportProcessResult(qbs::ProcessResult)));
     connect(m_processCommandExecutor, SIGNAL(finished(qbs::ErrorInfo)),
@@ -84,6 +87,21 @@ void ExecutorJob::setEchoMode(CommandEchoMode echoMode)
     m_jsCommandExecutor->setEchoMode(echoMode);
 }
 
+void ExecutorJob::setOutputStreamingEnabled(bool enabled)
+{
+    m_processCommandExecutor->setOutputStreamingEnabled(enabled);
+}
+
+void ExecutorJob::setOutputSpillThreshold(int byteCount)
+{
+    m_processCommandExecutor->setOutputSpillThreshold(byteCount);
+}
+
+void ExecutorJob::setProcessLaunchStatistics(SpawnedProcess::StatisticsCollector *statistics)
+{
+    m_processCommandExecutor->setProcessLaunchStatistics(statistics);
+}
+
 void ExecutorJob::run(Transformer *t)
 {
     QBS_ASSERT(m_currentCommandIdx == -1, return);
@@ -98,6 +116,28 @@ void ExecutorJob::run(Transformer *t)
     m_processCommandExecutor->setProcessEnvironment(
                 (*t->outputs.begin())->product->buildEnvironment);
     m_transformer = t;
+    m_commands = t->commands;
+    runNextCommand();
+}
+
+/*
+ * Runs one command on behalf of several transformers of the same product.
+ * The outputs are still owned by the individual transformers; the caller takes care of them.
+ */
+void ExecutorJob::run(const QList<Transformer *> &batch, const AbstractCommandPtr &batchCommand)
+{
+    QBS_ASSERT(m_currentCommandIdx == -1, return);
+    QBS_CHECK(!batch.isEmpty());
+
+    foreach (Transformer * const t, batch) {
+        t->propertiesRequestedInCommands.clear();
+        QBS_CHECK(!t->outputs.isEmpty());
+    }
+    Transformer * const first = batch.first();
+    m_processCommandExecutor->setProcessEnvironment(
+                (*first->outputs.begin())->product->buildEnvironment);
+    m_transformer = first;
+    m_commands = QList<AbstractCommandPtr>() << batchCommand;
     runNextCommand();
 }
 
@@ -111,14 +151,14 @@ void ExecutorJob::cancel()
 
 void ExecutorJob::runNextCommand()
 {
-    QBS_ASSERT(m_currentCommandIdx <= m_transformer->commands.count(), return);
+    QBS_ASSERT(m_currentCommandIdx <= m_commands.count(), return);
     ++m_currentCommandIdx;
-    if (m_currentCommandIdx >= m_transformer->commands.count()) {
+    if (m_currentCommandIdx >= m_commands.count()) {
         setFinished();
         return;
     }
 
-    const AbstractCommandPtr &command = m_transformer->commands.at(m_currentCommandIdx);
+    const AbstractCommandPtr &command = m_commands.at(m_currentCommandIdx);
     switch (command->type()) {
     case AbstractCommand::ProcessCommandType:
         m_currentCommandExecutor = m_processCommandExecutor;
@@ -130,12 +170,15 @@ void ExecutorJob::runNextCommand()
         qFatal("Missing implementation for command type %d", command->type());
     }
 
+    if (m_metricsCollector)
+        m_commandTimer.start();
     m_currentCommandExecutor->start(m_transformer, command.data());
 }
 
 void ExecutorJob::onCommandFinished(const ErrorInfo &err)
 {
     QBS_ASSERT(m_transformer, return);
+    recordCommandDuration();
     if (m_error.hasError()) { // Canceled?
         setFinished();
     } else if (err.hasError()) {
@@ -153,12 +196,25 @@ void ExecutorJob::setFinished()
     emit finished(err);
 }
 
+void ExecutorJob::recordCommandDuration()
+{
+    if (!m_metricsCollector || !m_commandTimer.isValid())
+        return;
+    const qint64 elapsed = m_commandTimer.nsecsElapsed();
+    m_commandTimer.invalidate();
+    m_metricsCollector->addPhaseDuration(Metrics::CommandExecution, elapsed);
+    m_metricsCollector->addHistogramSample(Metrics::CommandDuration, elapsed);
+    m_metricsCollector->addToCounter(Metrics::ExecutedCommands);
+}
+
 void ExecutorJob::reset()
 {
     m_transformer = 0;
+    m_commands.clear();
     m_currentCommandExecutor = 0;
     m_currentCommandIdx = -1;
     m_error.clear();
+    m_commandTimer.invalidate();
 }
 
 } // namespace Internal
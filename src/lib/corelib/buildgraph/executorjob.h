@@ -31,10 +31,14 @@
 #ifndef QBS_EXECUTORJOB_H
 #define QBS_EXECUTORJOB_H
 
+#include "forward_decls.h"
+#include "spawnedprocess.h"
 #include <language/forward_decls.h>
 #include <tools/commandechomode.h>
 #include <tools/error.h>
+#include <tools/metricscollector.h>
 
+#include <QElapsedTimer>
 #include <QObject>
 
 namespace qbs {
@@ -60,11 +64,18 @@ public:
     void setMainThreadScriptEngine(ScriptEngine *engine);
     void setDryRun(bool enabled);
     void setEchoMode(CommandEchoMode echoMode);
+    void setOutputStreamingEnabled(bool enabled);
+    void setOutputSpillThreshold(int byteCount);
+    void setProcessLaunchStatistics(SpawnedProcess::StatisticsCollector *statistics);
     void run(Transformer *t);
+    void run(const QList<Transformer *> &batch, const AbstractCommandPtr &batchCommand);
     void cancel();
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const QString &commandDescription,
+                             const QString &executableFilePath, const QStringList &stdOut,
+                             const QStringList &stdErr);
     void reportProcessResult(const qbs::ProcessResult &result);
     void finished(const qbs::ErrorInfo &error = ErrorInfo()); // !hasError() <=> command successful
 
@@ -75,13 +86,17 @@ private slots:
 private:
     void setFinished();
     void reset();
+    void recordCommandDuration();
 
     AbstractCommandExecutor *m_currentCommandExecutor;
     ProcessCommandExecutor *m_processCommandExecutor;
     JsCommandExecutor *m_jsCommandExecutor;
     Transformer *m_transformer;
+    QList<AbstractCommandPtr> m_commands;
     int m_currentCommandIdx;
     ErrorInfo m_error;
+    MetricsCollectorPtr m_metricsCollector;
+    QElapsedTimer m_commandTimer;
 };
 
 } // namespace Internal
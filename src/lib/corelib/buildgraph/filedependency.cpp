@@ -30,13 +30,13 @@
 
 #include "filedependency.h"
 
-#include <tools/fileinfo.h>
 #include <tools/persistence.h>
 
 namespace qbs {
 namespace Internal {
 
 FileResourceBase::FileResourceBase()
+    : m_dirId(PathTable::InvalidId), m_fileNameId(PathTable::InvalidId)
 {
 }
 
@@ -57,13 +57,17 @@ const FileTime &FileResourceBase::timestamp() const
 
 void FileResourceBase::setFilePath(const QString &filePath)
 {
-    m_filePath = filePath;
-    FileInfo::splitIntoDirectoryAndFileName(m_filePath, &m_dirPath, &m_fileName);
+    const int slashIndex = filePath.lastIndexOf(QLatin1Char('/'));
+    m_dirId = slashIndex < 0
+            ? PathTable::InvalidId : PathTable::directoryId(filePath.left(slashIndex));
+    m_fileNameId = PathTable::fileNameId(filePath.mid(slashIndex + 1));
 }
 
-const QString &FileResourceBase::filePath() const
+QString FileResourceBase::filePath() const
 {
-    return m_filePath;
+    if (m_dirId == PathTable::InvalidId)
+        return fileName();
+    return dirPath() + QLatin1Char('/') + fileName();
 }
 
 void FileResourceBase::load(PersistentPool &pool)
@@ -75,7 +79,7 @@ void FileResourceBase::load(PersistentPool &pool)
 
 void FileResourceBase::store(PersistentPool &pool) const
 {
-    pool.storeString(m_filePath);
+    pool.storeString(filePath());
     pool.stream()
             << m_timestamp;
 }
@@ -31,6 +31,7 @@
 #ifndef QBS_FILEDEPENDENCY_H
 #define QBS_FILEDEPENDENCY_H
 
+#include "pathtable.h"
 #include <tools/filetime.h>
 #include <tools/persistentobject.h>
 
@@ -49,10 +50,13 @@ public:
     const FileTime &timestamp() const;
     void clearTimestamp() { m_timestamp.clear(); }
 
+    // The path is not stored as such, but rebuilt from the interned directory and file name.
     void setFilePath(const QString &filePath);
-    const QString &filePath() const;
-    QString dirPath() const { return m_dirPath.toString(); }
-    QString fileName() const { return m_fileName.toString(); }
+    QString filePath() const;
+    QString dirPath() const { return PathTable::directory(m_dirId); }
+    QString fileName() const { return PathTable::fileName(m_fileNameId); }
+    int dirId() const { return m_dirId; }
+    int fileNameId() const { return m_fileNameId; }
 
 protected:
     void load(PersistentPool &pool);
@@ -60,9 +64,8 @@ protected:
 
 private:
     FileTime m_timestamp;
-    QString m_filePath;
-    QStringRef m_dirPath;
-    QStringRef m_fileName;
+    int m_dirId; // Invalid for paths without a directory part.
+    int m_fileNameId;
 };
 
 class FileDependency : public FileResourceBase
@@ -36,15 +36,19 @@
 #include "projectbuilddata.h"
 #include "transformer.h"
 #include "depscanner.h"
+#include "pathtable.h"
 #include "rulesevaluationcontext.h"
 
 #include <language/language.h>
+#include <tools/directorylistingcache.h>
 #include <tools/fileinfo.h>
+#include <tools/metricscollector.h>
 #include <tools/scannerpluginmanager.h>
 #include <tools/qbsassert.h>
 #include <tools/error.h>
 
 #include <QDir>
+#include <QElapsedTimer>
 #include <QSet>
 #include <QStringList>
 #include <QVariantMap>
@@ -61,20 +65,29 @@ InputArtifactScannerContext::~InputArtifactScannerContext()
 {
 }
 
-static void resolveWithIncludePath(const QString &includePath,
-        const ScanResultCache::Dependency &dependency, const ResolvedProduct *product,
-        ResolvedDependency *result)
+static void resolveWithIncludePath(const QString &includePath, int includePathId,
+        const ScanResultCache::Dependency &dependency, int dependencyFileNameId,
+        const ResolvedProduct *product, ResolvedDependency *result)
 {
-    QString absDirPath = dependency.dirPath().isEmpty() ? includePath : FileInfo::resolvePath(includePath, dependency.dirPath());
-    if (!dependency.isClean())
-        absDirPath = QDir::cleanPath(absDirPath);
+    const ProjectBuildData * const buildData = product->topLevelProject()->buildData.data();
+    QString absDirPath;
+    QList<FileResourceBase *> lookupResults;
+    if (dependency.dirPath().isEmpty() && dependency.isClean()) {
+        // Common case: No string operations needed unless the file is not in the build graph.
+        if (dependencyFileNameId != PathTable::InvalidId)
+            lookupResults = buildData->lookupFiles(includePathId, dependencyFileNameId);
+    } else {
+        absDirPath = dependency.dirPath().isEmpty()
+                ? includePath : FileInfo::resolvePath(includePath, dependency.dirPath());
+        if (!dependency.isClean())
+            absDirPath = QDir::cleanPath(absDirPath);
+        lookupResults = buildData->lookupFiles(absDirPath, dependency.fileName());
+    }
 
-    ResolvedProject *project = product->project.data();
     FileDependency *fileDependencyArtifact = 0;
     Artifact *dependencyInProduct = 0;
     Artifact *dependencyInOtherProduct = 0;
-    foreach (FileResourceBase *lookupResult, project->topLevelProject()
-             ->buildData->lookupFiles(absDirPath, dependency.fileName())) {
+    foreach (FileResourceBase *lookupResult, lookupResults) {
         if ((fileDependencyArtifact = dynamic_cast<FileDependency *>(lookupResult)))
             continue;
         Artifact * const foundArtifact = dynamic_cast<Artifact *>(lookupResult);
@@ -93,9 +106,10 @@ static void resolveWithIncludePath(const QString &includePath,
         return;
     }
 
-    QString absFilePath = absDirPath + QLatin1Char('/') + dependency.fileName();
-    if (FileInfo::exists(absFilePath))
-        result->filePath = absFilePath;
+    if (absDirPath.isNull())
+        absDirPath = includePath;
+    if (DirectoryListingCache::instance()->fileExists(absDirPath, dependency.fileName()))
+        result->filePath = absDirPath + QLatin1Char('/') + dependency.fileName();
 }
 
 static void resolveAbsolutePath(const ScanResultCache::Dependency &dependency,
@@ -132,16 +146,22 @@ static void resolveAbsolutePath(const ScanResultCache::Dependency &dependency,
         result->filePath = dependency.filePath();
 }
 
-static void scanWithScannerPlugin(DependencyScanner *scanner,
-                                  FileResourceBase *fileToBeScanned,
-                                  ScanResultCache::Result *scanResult)
+static void setScanResultDependencies(const QStringList &dependencies,
+                                      ScanResultCache::Result *scanResult)
 {
-    QStringList dependencies = scanner->collectDependencies(fileToBeScanned);
+    scanResult->deps.reserve(dependencies.count());
     foreach (const QString &s, dependencies)
         scanResult->deps += ScanResultCache::Dependency(s);
     scanResult->valid = true;
 }
 
+static void scanWithScannerPlugin(DependencyScanner *scanner,
+                                  FileResourceBase *fileToBeScanned,
+                                  ScanResultCache::Result *scanResult)
+{
+    setScanResultDependencies(scanner->collectDependencies(fileToBeScanned), scanResult);
+}
+
 InputArtifactScanner::InputArtifactScanner(Artifact *artifact, InputArtifactScannerContext *ctx,
                                            const Logger &logger)
     : m_artifact(artifact), m_context(ctx), m_newDependencyAdded(false), m_logger(logger)
@@ -163,8 +183,13 @@ void InputArtifactScanner::scan()
 
     m_artifact->inputsScanned = true;
 
+    const MetricsCollectorPtr collector = m_logger.metricsCollector();
+    QElapsedTimer timer;
+    if (collector)
+        timer.start();
+
     // clear file dependencies; they will be regenerated
-    m_artifact->fileDependencies.clear();
+    m_artifact->product->topLevelProject()->buildData->clearFileDependencies(m_artifact);
 
     // Remove all connections to children that were added by the dependency scanner.
     // They will be regenerated.
@@ -176,6 +201,12 @@ void InputArtifactScanner::scan()
         Artifact *inputArtifact = *it;
         scanForFileDependencies(inputArtifact);
     }
+
+    if (collector) {
+        const qint64 elapsed = timer.nsecsElapsed();
+        collector->addPhaseDuration(Metrics::Scanning, elapsed);
+        collector->addHistogramSample(Metrics::ScanDuration, elapsed);
+    }
 }
 
 void InputArtifactScanner::scanForFileDependencies(Artifact *inputArtifact)
@@ -200,10 +231,14 @@ void InputArtifactScanner::scanForFileDependencies(Artifact *inputArtifact)
         visitedFilePaths.insert(filePathToBeScanned);
 
         foreach (DependencyScanner *scanner, scanners) {
+            if (scanner->recursive() && scanner->supportsBatchScanning())
+                prefetchScanResults(scanner, fileToBeScanned, filesToScan, visitedFilePaths);
             scanForScannerFileDependencies(scanner, inputArtifact, fileToBeScanned,
                 scanner->recursive() ? &filesToScan : 0, cacheItem[scanner->key()]);
         }
     }
+    if (const MetricsCollectorPtr collector = m_logger.metricsCollector())
+        collector->addToCounter(Metrics::ScannedFiles, visitedFilePaths.count());
 }
 
 QSet<DependencyScanner *> InputArtifactScanner::scannersForArtifact(const Artifact *artifact) const
@@ -235,6 +270,49 @@ QSet<DependencyScanner *> InputArtifactScanner::scannersForArtifact(const Artifa
     return scanners;
 }
 
+// Scans the given file together with the files that are already queued, so that scanners
+// supporting it can process them in one go. The results end up in the scan result cache.
+void InputArtifactScanner::prefetchScanResults(DependencyScanner *scanner,
+        FileResourceBase *fileToBeScanned, const QList<FileResourceBase *> &filesToScan,
+        const QSet<QString> &visitedFilePaths)
+{
+    ScanResultCache * const scanResultCache = m_context->scanResultCache;
+    if (scanResultCache->value(scanner->key(), fileToBeScanned->filePath()).valid)
+        return;
+
+    QList<FileResourceBase *> batch;
+    batch << fileToBeScanned;
+    QSet<QString> batchFilePaths;
+    batchFilePaths << fileToBeScanned->filePath();
+    foreach (FileResourceBase * const file, filesToScan) {
+        const QString &filePath = file->filePath();
+        if (visitedFilePaths.contains(filePath) || batchFilePaths.contains(filePath)
+                || scanResultCache->value(scanner->key(), filePath).valid) {
+            continue;
+        }
+        batchFilePaths << filePath;
+        batch << file;
+    }
+    if (batch.count() == 1)
+        return;
+
+    QList<DependencyScanner::BatchScanResult> dependencies;
+    try {
+        dependencies = scanner->collectBatchDependencies(batch);
+    } catch (const ErrorInfo &) {
+        return; // The error will be reported when scanning the files one by one.
+    }
+    QBS_CHECK(dependencies.count() == batch.count());
+    for (int i = 0; i < batch.count(); ++i) {
+        // Files that failed to scan are left to the regular scan, which will try again.
+        if (!dependencies.at(i).valid)
+            continue;
+        ScanResultCache::Result scanResult;
+        setScanResultDependencies(dependencies.at(i).dependencies, &scanResult);
+        scanResultCache->insert(scanner->key(), batch.at(i)->filePath(), scanResult);
+    }
+}
+
 void InputArtifactScanner::scanForScannerFileDependencies(DependencyScanner *scanner,
         Artifact *inputArtifact, FileResourceBase *fileToBeScanned,
         QList<FileResourceBase *> *filesToScan,
@@ -249,6 +327,10 @@ void InputArtifactScanner::scanForScannerFileDependencies(DependencyScanner *sca
     if (!cacheHit) {
         cache.valid = true;
         cache.searchPaths = scanner->collectSearchPaths(inputArtifact);
+        cache.searchPathIds.clear();
+        cache.searchPathIds.reserve(cache.searchPaths.count());
+        foreach (const QString &searchPath, cache.searchPaths)
+            cache.searchPathIds << PathTable::directoryId(searchPath);
     }
     if (m_logger.traceEnabled()) {
         m_logger.qbsTrace()
@@ -295,11 +377,15 @@ void InputArtifactScanner::resolveScanResultDependencies(const Artifact *inputAr
         }
 
         // try include paths
-        foreach (const QString &includePath, cache.searchPaths) {
-            resolveWithIncludePath(includePath, dependency, inputArtifact->product.data(),
-                                   &resolvedDependency);
-            if (resolvedDependency.isValid())
-                goto resolved;
+        {
+            const int fileNameId = PathTable::findFileNameId(dependency.fileName());
+            for (int i = 0; i < cache.searchPaths.count(); ++i) {
+                resolveWithIncludePath(cache.searchPaths.at(i), cache.searchPathIds.at(i),
+                                       dependency, fileNameId, inputArtifact->product.data(),
+                                       &resolvedDependency);
+                if (resolvedDependency.isValid())
+                    goto resolved;
+            }
         }
 
 unresolved:
@@ -371,7 +457,7 @@ void InputArtifactScanner::handleDependency(ResolvedDependency &dependency)
         return;
 
     if (fileDependency) {
-        m_artifact->fileDependencies.insert(fileDependency);
+        product->topLevelProject()->buildData->addFileDependency(m_artifact, fileDependency);
     } else {
         if (m_artifact->children.contains(artifactDependency))
             return;
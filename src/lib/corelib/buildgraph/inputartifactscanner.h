@@ -37,6 +37,7 @@
 
 #include <QHash>
 #include <QStringList>
+#include <QVector>
 
 class ScannerPlugin;
 
@@ -92,6 +93,7 @@ private:
 
         bool valid;
         QStringList searchPaths;
+        QVector<int> searchPathIds; // The PathTable ids of the search paths.
         ResolvedDependenciesCache resolvedDependenciesCache;
     };
 
@@ -123,6 +125,8 @@ public:
 private:
     void scanForFileDependencies(Artifact *inputArtifact);
     QSet<DependencyScanner *> scannersForArtifact(const Artifact *artifact) const;
+    void prefetchScanResults(DependencyScanner *scanner, FileResourceBase *fileToBeScanned,
+            const QList<FileResourceBase *> &filesToScan, const QSet<QString> &visitedFilePaths);
     void scanForScannerFileDependencies(DependencyScanner *scanner,
             Artifact *inputArtifact, FileResourceBase *fileToBeScanned,
             QList<FileResourceBase *> *filesToScan,
@@ -0,0 +1,203 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "nodegraphdumper.h"
+
+#include "artifact.h"
+#include "productbuilddata.h"
+#include "rulenode.h"
+
+#include <language/language.h>
+#include <tools/qbsassert.h>
+
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPair>
+#include <QQueue>
+#include <QVariantMap>
+
+namespace qbs {
+namespace Internal {
+
+static const char binaryFormatMagic[] = "QBSNODES";
+static const qint32 binaryFormatVersion = 1;
+
+NodeGraphDumper::NodeGraphDumper(QIODevice &outDevice, const NodeTreeDumpOptions &options)
+    : m_outDevice(outDevice)
+    , m_format(options.format())
+    , m_fileTags(FileTags::fromStringList(options.fileTags()))
+    , m_maxDepth(options.maxDepth())
+{
+    QBS_CHECK(m_format != NodeTreeDumpOptions::TreeFormat);
+}
+
+void NodeGraphDumper::start(const QList<ResolvedProductPtr> &products)
+{
+    if (m_format == NodeTreeDumpOptions::BinaryFormat) {
+        m_stream.setDevice(&m_outDevice);
+        m_stream.setVersion(QDataStream::Qt_5_1);
+        m_stream.writeRawData(binaryFormatMagic, qstrlen(binaryFormatMagic));
+        m_stream << binaryFormatVersion;
+    }
+    foreach (const ResolvedProductPtr &product, products) {
+        if (product->buildData)
+            traverse(product);
+    }
+    m_stream.setDevice(0);
+}
+
+/*
+ * Breadth-first, so that the depth limit refers to the shortest path from a root node.
+ * Nodes of other products are written, but not descended into.
+ */
+void NodeGraphDumper::traverse(const ResolvedProductPtr &product)
+{
+    typedef QPair<BuildGraphNode *, int> NodeAndDepth;
+    QQueue<NodeAndDepth> queue;
+    foreach (BuildGraphNode * const root, product->buildData->roots)
+        queue.enqueue(qMakePair(root, 0));
+    while (!queue.isEmpty()) {
+        const NodeAndDepth current = queue.dequeue();
+        BuildGraphNode * const node = current.first;
+        if (node->product != product) {
+            if (matchesFileTags(node))
+                nodeId(node);
+            continue;
+        }
+        if (m_expandedNodes.contains(node))
+            continue;
+        m_expandedNodes += node;
+        const bool nodeMatches = matchesFileTags(node);
+        const int id = nodeMatches ? nodeId(node) : -1;
+        if (m_maxDepth >= 0 && current.second >= m_maxDepth)
+            continue;
+        foreach (BuildGraphNode * const child, node->children) {
+            if (nodeMatches && matchesFileTags(child))
+                writeEdge(id, nodeId(child));
+            queue.enqueue(qMakePair(child, current.second + 1));
+        }
+    }
+}
+
+bool NodeGraphDumper::matchesFileTags(const BuildGraphNode *node) const
+{
+    if (m_fileTags.isEmpty())
+        return true;
+    if (node->type() == BuildGraphNode::ArtifactNodeType)
+        return static_cast<const Artifact *>(node)->fileTags().matches(m_fileTags);
+    return static_cast<const RuleNode *>(node)->rule()->collectedOutputFileTags()
+            .matches(m_fileTags);
+}
+
+// Writes the node on first use.
+int NodeGraphDumper::nodeId(const BuildGraphNode *node)
+{
+    QHash<const BuildGraphNode *, int>::ConstIterator it = m_nodeIds.constFind(node);
+    if (it != m_nodeIds.constEnd())
+        return it.value();
+    const int id = m_nodeIds.count();
+    m_nodeIds.insert(node, id);
+    writeNode(id, node);
+    return id;
+}
+
+// Product names are only written once in the binary format; JSON lines carry them inline.
+int NodeGraphDumper::productId(const ResolvedProduct *product)
+{
+    QHash<const ResolvedProduct *, int>::ConstIterator it = m_productIds.constFind(product);
+    if (it != m_productIds.constEnd())
+        return it.value();
+    const int id = m_productIds.count();
+    m_productIds.insert(product, id);
+    m_stream << quint8(ProductRecord) << quint32(id) << product->uniqueName();
+    return id;
+}
+
+void NodeGraphDumper::writeNode(int id, const BuildGraphNode *node)
+{
+    const ResolvedProduct * const product = node->product;
+    QString description;
+    QStringList fileTags;
+    const bool isArtifact = node->type() == BuildGraphNode::ArtifactNodeType;
+    if (isArtifact) {
+        const Artifact * const artifact = static_cast<const Artifact *>(node);
+        description = artifact->filePath();
+        fileTags = artifact->fileTags().toStringList();
+        fileTags.sort();
+    } else {
+        description = static_cast<const RuleNode *>(node)->rule()->toString();
+    }
+
+    if (m_format == NodeTreeDumpOptions::BinaryFormat) {
+        const int productIndex = productId(product);
+        m_stream << quint8(isArtifact ? ArtifactRecord : RuleRecord) << quint32(id)
+                 << quint32(productIndex) << description;
+        if (isArtifact)
+            m_stream << fileTags;
+        return;
+    }
+
+    QVariantMap object;
+    object.insert(QLatin1String("type"),
+                  isArtifact ? QLatin1String("artifact") : QLatin1String("rule"));
+    object.insert(QLatin1String("id"), id);
+    object.insert(QLatin1String("product"), product->uniqueName());
+    if (isArtifact) {
+        object.insert(QLatin1String("filePath"), description);
+        object.insert(QLatin1String("fileTags"), fileTags);
+    } else {
+        object.insert(QLatin1String("rule"), description);
+    }
+    writeJsonLine(object);
+}
+
+void NodeGraphDumper::writeEdge(int parentId, int childId)
+{
+    if (m_format == NodeTreeDumpOptions::BinaryFormat) {
+        m_stream << quint8(EdgeRecord) << quint32(parentId) << quint32(childId);
+        return;
+    }
+
+    QVariantMap object;
+    object.insert(QLatin1String("type"), QLatin1String("edge"));
+    object.insert(QLatin1String("parent"), parentId);
+    object.insert(QLatin1String("child"), childId);
+    writeJsonLine(object);
+}
+
+void NodeGraphDumper::writeJsonLine(const QVariantMap &object)
+{
+    m_outDevice.write(QJsonDocument(QJsonObject::fromVariantMap(object))
+                      .toJson(QJsonDocument::Compact));
+    m_outDevice.write("\n");
+}
+
+} // namespace Internal
+} // namespace qbs
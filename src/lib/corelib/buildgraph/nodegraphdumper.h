@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_NODEGRAPHDUMPER_H
+#define QBS_NODEGRAPHDUMPER_H
+
+#include <language/filetags.h>
+#include <language/forward_decls.h>
+#include <tools/nodetreedumpoptions.h>
+
+#include <QDataStream>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QVariantMap>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+class BuildGraphNode;
+
+/*
+ * Writes the build graph as a list of nodes and edges, where every node is written once,
+ * before the first edge that refers to it. Unlike with the NodeTreeDumper, the size of the
+ * output is linear in the size of the graph, and the data is written while traversing.
+ */
+class NodeGraphDumper
+{
+public:
+    NodeGraphDumper(QIODevice &outDevice, const NodeTreeDumpOptions &options);
+
+    void start(const QList<ResolvedProductPtr> &products);
+
+private:
+    enum RecordType { ProductRecord, ArtifactRecord, RuleRecord, EdgeRecord };
+
+    void traverse(const ResolvedProductPtr &product);
+    bool matchesFileTags(const BuildGraphNode *node) const;
+    int nodeId(const BuildGraphNode *node);
+    int productId(const ResolvedProduct *product);
+    void writeNode(int id, const BuildGraphNode *node);
+    void writeEdge(int parentId, int childId);
+    void writeJsonLine(const QVariantMap &object);
+
+    QIODevice &m_outDevice;
+    QDataStream m_stream;
+    const NodeTreeDumpOptions::Format m_format;
+    const FileTags m_fileTags;
+    const int m_maxDepth;
+    QHash<const BuildGraphNode *, int> m_nodeIds;
+    QHash<const ResolvedProduct *, int> m_productIds;
+    QSet<const BuildGraphNode *> m_expandedNodes;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard.
@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "pathtable.h"
+
+#include <tools/stringtable.h>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class PathTable
+ * \brief The \c PathTable class maps directory paths and file names to small integers.
+ * Every \c FileResourceBase stores the ids of its directory and file name, so that the
+ * build graph's lookup table can be keyed by integers, and the strings of directories
+ * shared by many files are held only once. The full path of a file is not stored anywhere,
+ * but rebuilt from the two strings on demand. Turning an id back into a string does not take
+ * a lock.
+ */
+
+static StringTable &directories()
+{
+    static StringTable table;
+    return table;
+}
+
+static StringTable &fileNames()
+{
+    static StringTable table;
+    return table;
+}
+
+int PathTable::directoryId(const QString &dirPath)
+{
+    return directories().id(dirPath);
+}
+
+int PathTable::fileNameId(const QString &fileName)
+{
+    return fileNames().id(fileName);
+}
+
+int PathTable::findDirectoryId(const QString &dirPath)
+{
+    return directories().find(dirPath);
+}
+
+int PathTable::findFileNameId(const QString &fileName)
+{
+    return fileNames().find(fileName);
+}
+
+QString PathTable::directory(int id)
+{
+    return directories().string(id);
+}
+
+QString PathTable::fileName(int id)
+{
+    return fileNames().string(id);
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -43,28 +43,53 @@
 #include <tools/executablefinder.h>
 #include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
+#include <tools/jobserver.h>
 #include <tools/processresult.h>
 #include <tools/processresult_p.h>
 #include <tools/qbsassert.h>
 #include <tools/scripttools.h>
 #include <tools/shellutils.h>
 
+#include <QCoreApplication>
 #include <QDir>
+#include <QFileInfo>
 #include <QScriptEngine>
 #include <QScriptValue>
 #include <QTemporaryFile>
+#include <QTextCodec>
+#include <QTextDecoder>
 #include <QTimer>
 
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#endif
+
 namespace qbs {
 namespace Internal {
 
 ProcessCommandExecutor::ProcessCommandExecutor(const Logger &logger, QObject *parent)
     : AbstractCommandExecutor(logger, parent)
+    , m_streamOutput(false)
+    , m_spillThreshold(0)
+    , m_responseFileDescriptor(-1)
 {
     connect(&m_process, SIGNAL(error(QProcess::ProcessError)),  SLOT(onProcessError()));
     connect(&m_process, SIGNAL(finished(int)), SLOT(onProcessFinished(int)));
+    connect(&m_process, SIGNAL(readyReadStandardOutput()), SLOT(onReadyReadStandardOutput()));
+    connect(&m_process, SIGNAL(readyReadStandardError()), SLOT(onReadyReadStandardError()));
 }
 
+// Longer lines get reported in pieces when streaming, so that the buffer stays bounded.
+static const int MaxBufferedLineLength = 64 * 1024;
+
 // returns an empty string or one that starts with a space!
 static QString commandArgsToString(const QStringList &args)
 {
@@ -93,10 +118,14 @@ void ProcessCommandExecutor::doStart()
     // Use native separators for debug output, so people can copy-paste it to a command line.
     const QString programNative = QDir::toNativeSeparators(program);
 
-    QProcessEnvironment env = m_buildEnvironment;
     const QProcessEnvironment &additionalVariables = cmd->environment();
-    foreach (const QString &key, additionalVariables.keys())
-        env.insert(key, additionalVariables.value(key));
+    QProcessEnvironment env = commandEnvironment(additionalVariables);
+    if (cmd->usesJobServer()) {
+        JobServer::instance()->exportToEnvironment(env);
+        m_process.setInheritedFileDescriptors(JobServer::instance()->fileDescriptors());
+    } else {
+        m_process.setInheritedFileDescriptors(QList<int>());
+    }
     m_process.setProcessEnvironment(env);
 
     QStringList arguments = cmd->arguments();
@@ -128,32 +157,41 @@ void ProcessCommandExecutor::doStart()
                         .arg(cmd->responseFileThreshold()).arg(commandLineLength);
             }
 
-            // The QTemporaryFile keeps a handle on the file, even if closed.
-            // On Windows, some commands (e.g. msvc link.exe) won't accept that.
-            // We need to delete the file manually, later.
-            QTemporaryFile responseFile;
-            responseFile.setAutoRemove(false);
-            responseFile.setFileTemplate(QDir::tempPath() + QLatin1String("/qbsresp"));
-            if (!responseFile.open()) {
-                emit finished(ErrorInfo(Tr::tr("Cannot create response file '%1'.")
-                                 .arg(responseFile.fileName())));
-                return;
-            }
+            QByteArray responseFileContents;
             for (int i = 0; i < cmd->arguments().count(); ++i) {
-                responseFile.write(cmd->arguments().at(i).toLocal8Bit());
-                responseFile.write("\n");
+                responseFileContents += cmd->arguments().at(i).toLocal8Bit();
+                responseFileContents += '\n';
+            }
+            QString responseFilePath;
+            if (cmd->inMemoryResponseFile())
+                responseFilePath = createInMemoryResponseFile(responseFileContents);
+            if (responseFilePath.isEmpty()) {
+                // The QTemporaryFile keeps a handle on the file, even if closed.
+                // On Windows, some commands (e.g. msvc link.exe) won't accept that.
+                // We need to delete the file manually, later.
+                QTemporaryFile responseFile;
+                responseFile.setAutoRemove(false);
+                responseFile.setFileTemplate(QDir::tempPath() + QLatin1String("/qbsresp"));
+                if (!responseFile.open()) {
+                    emit finished(ErrorInfo(Tr::tr("Cannot create response file '%1'.")
+                                     .arg(responseFile.fileName())));
+                    return;
+                }
+                responseFile.write(responseFileContents);
+                responseFile.close();
+                m_responseFileName = responseFile.fileName();
+                responseFilePath = m_responseFileName;
             }
-            responseFile.close();
-            m_responseFileName = responseFile.fileName();
             arguments.clear();
             arguments += QDir::toNativeSeparators(cmd->responseFileUsagePrefix()
-                    + responseFile.fileName());
+                    + responseFilePath);
         }
     }
 
     logger().qbsDebug() << "[EXEC] Running external process; full command line is: "
                         << programNative << commandArgsToString(arguments);
     logger().qbsTrace() << "[EXEC] Additional environment:" << additionalVariables.toStringList();
+    resetOutputChannels();
     m_process.setWorkingDirectory(workingDir);
     m_process.start(program, arguments);
 
@@ -161,20 +199,40 @@ void ProcessCommandExecutor::doStart()
     m_arguments = arguments;
 }
 
+QProcessEnvironment ProcessCommandExecutor::commandEnvironment(
+        const QProcessEnvironment &additionalVariables) const
+{
+    // Most commands of a product use the same additional variables, typically none.
+    const ResolvedProductPtr &product = transformer()->product();
+    QStringList keyParts = additionalVariables.toStringList();
+    keyParts.sort();
+    const QString cacheKey = keyParts.join(QLatin1Char('\n'));
+    QProcessEnvironment env = product->cachedCommandEnvironment(cacheKey);
+    if (!env.isEmpty())
+        return env;
+
+    env = m_buildEnvironment;
+    foreach (const QString &key, additionalVariables.keys())
+        env.insert(key, additionalVariables.value(key));
+    JobServer::instance()->removeFromEnvironment(env);
+    product->cacheCommandEnvironment(cacheKey, env);
+    return env;
+}
+
 void ProcessCommandExecutor::cancel()
 {
     // We don't want this command to be reported as failing, since we explicitly terminated it.
     disconnect(this, SIGNAL(reportProcessResult(qbs::ProcessResult)), 0, 0);
+    disconnect(this, SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)), 0, 0);
 
     m_process.terminate();
     if (!m_process.waitForFinished(1000))
         m_process.kill();
 }
 
-QString ProcessCommandExecutor::filterProcessOutput(const QByteArray &_output,
+QString ProcessCommandExecutor::filterProcessOutput(const QString &output,
         const QString &filterFunctionSource)
 {
-    const QString output = QString::fromLocal8Bit(_output);
     if (filterFunctionSource.isEmpty())
         return output;
 
@@ -208,6 +266,167 @@ QString ProcessCommandExecutor::filterProcessOutput(const QByteArray &_output,
     return filteredOutput.toString();
 }
 
+static QStringList outputLines(QString output)
+{
+    if (output.isEmpty())
+        return QStringList();
+    if (output.endsWith(QLatin1Char('\n')))
+        output.chop(1);
+    return output.split(QLatin1Char('\n'));
+}
+
+QString ProcessCommandExecutor::filterFunctionSource(QProcess::ProcessChannel channel) const
+{
+    return channel == QProcess::StandardOutput ? processCommand()->stdoutFilterFunction()
+                                               : processCommand()->stderrFilterFunction();
+}
+
+void ProcessCommandExecutor::handleOutput(QProcess::ProcessChannel channel,
+                                          const QByteArray &newData)
+{
+    if (newData.isEmpty())
+        return;
+    OutputChannel &outputChannel = channel == QProcess::StandardOutput ? m_stdOut : m_stdErr;
+
+    // A filter function gets to see the complete output at once, so it must stay in memory.
+    if (!filterFunctionSource(channel).isEmpty()) {
+        outputChannel.data += newData;
+        return;
+    }
+
+    if (m_streamOutput) {
+        outputChannel.data += newData;
+        streamCompleteLines(channel, outputChannel.data);
+        return;
+    }
+
+    if (outputChannel.spillFile || (m_spillThreshold > 0 && !outputChannel.spillingFailed
+            && outputChannel.data.size() + newData.size() > m_spillThreshold)) {
+        spillOutput(outputChannel, newData);
+    } else {
+        outputChannel.data += newData;
+    }
+}
+
+// Reports the complete lines at the start of buffer and removes them from it. A line that
+// exceeds the maximum length is reported in parts, so that the buffer stays bounded.
+void ProcessCommandExecutor::streamCompleteLines(QProcess::ProcessChannel channel,
+                                                 QByteArray &buffer)
+{
+    const int lastLineEnd = buffer.lastIndexOf('\n');
+    if (lastLineEnd == -1 && buffer.size() < MaxBufferedLineLength)
+        return;
+    const int chunkSize = lastLineEnd == -1 ? buffer.size() : lastLineEnd + 1;
+    streamOutput(channel, buffer.left(chunkSize));
+    buffer.remove(0, chunkSize);
+}
+
+void ProcessCommandExecutor::streamOutput(QProcess::ProcessChannel channel,
+                                          const QByteArray &output)
+{
+    // A chunk can end in the middle of a multi-byte character, if a line was too long.
+    OutputChannel &outputChannel = channel == QProcess::StandardOutput ? m_stdOut : m_stdErr;
+    if (!outputChannel.decoder) {
+        outputChannel.decoder
+                = QSharedPointer<QTextDecoder>(QTextCodec::codecForLocale()->makeDecoder());
+    }
+    const QStringList lines = outputLines(outputChannel.decoder->toUnicode(output));
+    if (channel == QProcess::StandardOutput)
+        emit reportProcessOutput(command()->description(), m_program, lines, QStringList());
+    else
+        emit reportProcessOutput(command()->description(), m_program, QStringList(), lines);
+}
+
+void ProcessCommandExecutor::spillOutput(OutputChannel &channel, const QByteArray &output)
+{
+    if (!channel.spillFile) {
+        QTemporaryFile * const spillFile = new QTemporaryFile(this);
+        spillFile->setFileTemplate(QDir::tempPath() + QLatin1String("/qbsoutput-XXXXXX"));
+        if (!spillFile->open()) {
+            logger().qbsWarning() << Tr::tr("Cannot create file '%1' for process output; "
+                                            "keeping it in memory.").arg(spillFile->fileName());
+            delete spillFile;
+            channel.spillingFailed = true;
+            channel.data += output;
+            return;
+        }
+        channel.spillFile = spillFile;
+    }
+    if (channel.spillFile->write(output) != output.size()) {
+        logger().qbsWarning() << Tr::tr("Cannot write process output to file '%1': %2")
+                                 .arg(channel.spillFile->fileName(),
+                                      channel.spillFile->errorString());
+    }
+}
+
+// Reports the output of a channel that went to a spill file, reading the file in chunks of
+// bounded size rather than loading all of it into memory.
+void ProcessCommandExecutor::streamSpilledOutput(QProcess::ProcessChannel channel)
+{
+    OutputChannel &outputChannel = channel == QProcess::StandardOutput ? m_stdOut : m_stdErr;
+    QByteArray buffer = outputChannel.data;
+    outputChannel.data.clear();
+    QTemporaryFile * const spillFile = outputChannel.spillFile;
+    if (!spillFile->flush() || !spillFile->seek(0)) {
+        logger().qbsWarning() << Tr::tr("Cannot read process output from file '%1': %2")
+                                 .arg(spillFile->fileName(), spillFile->errorString());
+    } else {
+        while (!spillFile->atEnd()) {
+            const QByteArray chunk = spillFile->read(MaxBufferedLineLength);
+            if (chunk.isEmpty())
+                break;
+            buffer += chunk;
+            streamCompleteLines(channel, buffer);
+        }
+    }
+    if (!buffer.isEmpty())
+        streamOutput(channel, buffer);
+}
+
+QStringList ProcessCommandExecutor::collectOutput(QProcess::ProcessChannel channel)
+{
+    OutputChannel &outputChannel = channel == QProcess::StandardOutput ? m_stdOut : m_stdErr;
+    const QString filterSource = filterFunctionSource(channel);
+    if (!filterSource.isEmpty()) {
+        return outputLines(filterProcessOutput(QString::fromLocal8Bit(outputChannel.data),
+                                               filterSource));
+    }
+
+    if (m_streamOutput) {
+        // Only the last, unterminated line can be left.
+        if (!outputChannel.data.isEmpty())
+            streamOutput(channel, outputChannel.data);
+        return QStringList();
+    }
+
+    // Output that did not fit below the threshold does not go into the result, which would
+    // hold all of it in memory again. It is reported in chunks instead, in the right order.
+    if (outputChannel.spillFile) {
+        streamSpilledOutput(channel);
+        return QStringList();
+    }
+    return outputLines(QString::fromLocal8Bit(outputChannel.data));
+}
+
+void ProcessCommandExecutor::resetOutputChannels()
+{
+    // This also removes the spill files.
+    delete m_stdOut.spillFile;
+    delete m_stdErr.spillFile;
+    m_stdOut = OutputChannel();
+    m_stdErr = OutputChannel();
+}
+
+void ProcessCommandExecutor::onReadyReadStandardOutput()
+{
+    handleOutput(QProcess::StandardOutput, m_process.readAllStandardOutput());
+}
+
+void ProcessCommandExecutor::onReadyReadStandardError()
+{
+    handleOutput(QProcess::StandardError, m_process.readAllStandardError());
+}
+
 void ProcessCommandExecutor::sendProcessOutput(bool success)
 {
     ProcessResult result;
@@ -220,20 +439,11 @@ void ProcessCommandExecutor::sendProcessOutput(bool success)
     result.d->exitStatus = m_process.exitStatus();
     result.d->success = success;
 
-    QString tmp = filterProcessOutput(m_process.readAllStandardOutput(),
-                                      processCommand()->stdoutFilterFunction());
-    if (!tmp.isEmpty()) {
-        if (tmp.endsWith(QLatin1Char('\n')))
-            tmp.chop(1);
-        result.d->stdOut = tmp.split(QLatin1Char('\n'));
-    }
-    tmp = filterProcessOutput(m_process.readAllStandardError(),
-                              processCommand()->stderrFilterFunction());
-    if (!tmp.isEmpty()) {
-        if (tmp.endsWith(QLatin1Char('\n')))
-            tmp.chop(1);
-        result.d->stdErr = tmp.split(QLatin1Char('\n'));
-    }
+    onReadyReadStandardOutput();
+    onReadyReadStandardError();
+    result.d->stdOut = collectOutput(QProcess::StandardOutput);
+    result.d->stdErr = collectOutput(QProcess::StandardError);
+    resetOutputChannels();
 
     emit reportProcessResult(result);
 }
@@ -293,8 +503,60 @@ void ProcessCommandExecutor::doReportCommandDescription()
     AbstractCommandExecutor::doReportCommandDescription();
 }
 
+/*!
+ * Provides the response file via a memory-backed file that is accessible through the proc file
+ * system, so that no disk access is needed. We refer to the file via our own pid rather than
+ * via "self", so that the descriptor does not need to be inherited by any child process.
+ * Returns an empty string if this is not possible on the current platform or if we cannot
+ * open the path ourselves. Whether the tool can open it is not known in advance, which is why
+ * this is only done for commands that ask for it.
+ */
+QString ProcessCommandExecutor::createInMemoryResponseFile(const QByteArray &contents)
+{
+#if defined(Q_OS_LINUX) && defined(SYS_memfd_create)
+    static const bool procFileSystemAvailable = QFileInfo(QLatin1String("/proc/self/fd")).isDir();
+    if (!procFileSystemAvailable)
+        return QString();
+    const int fd = ::syscall(SYS_memfd_create, "qbsresp", MFD_CLOEXEC);
+    if (fd == -1)
+        return QString();
+    const char *data = contents.constData();
+    qint64 bytesLeft = contents.size();
+    while (bytesLeft > 0) {
+        const ssize_t bytesWritten = ::write(fd, data, bytesLeft);
+        if (bytesWritten == -1) {
+            if (errno == EINTR)
+                continue;
+            ::close(fd);
+            return QString();
+        }
+        data += bytesWritten;
+        bytesLeft -= bytesWritten;
+    }
+    const QString filePath = QString::fromLatin1("/proc/%1/fd/%2")
+            .arg(QCoreApplication::applicationPid()).arg(fd);
+    const int checkFd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (checkFd == -1) {
+        ::close(fd);
+        return QString();
+    }
+    ::close(checkFd);
+    m_responseFileDescriptor = fd;
+    return filePath;
+#else
+    Q_UNUSED(contents);
+    return QString();
+#endif
+}
+
 void ProcessCommandExecutor::removeResponseFile()
 {
+#if defined(Q_OS_UNIX)
+    if (m_responseFileDescriptor != -1) {
+        ::close(m_responseFileDescriptor);
+        m_responseFileDescriptor = -1;
+    }
+#endif
     if (m_responseFileName.isEmpty())
         return;
     QFile::remove(m_responseFileName);
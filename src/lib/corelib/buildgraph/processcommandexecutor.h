@@ -32,11 +32,19 @@
 #define QBS_PROCESSCOMMANDEXECUTOR_H
 
 #include "abstractcommandexecutor.h"
+#include "spawnedprocess.h"
 
+#include <QByteArray>
 #include <QProcess>
 #include <QProcessEnvironment>
+#include <QSharedPointer>
 #include <QString>
 
+QT_BEGIN_NAMESPACE
+class QTemporaryFile;
+class QTextDecoder;
+QT_END_NAMESPACE
+
 namespace qbs {
 class ProcessResult;
 
@@ -52,6 +60,12 @@ public:
     void setProcessEnvironment(const QProcessEnvironment &processEnvironment) {
         m_buildEnvironment = processEnvironment;
     }
+    void setOutputStreamingEnabled(bool enabled) { m_streamOutput = enabled; }
+    void setOutputSpillThreshold(int byteCount) { m_spillThreshold = byteCount; }
+    void setProcessLaunchStatistics(SpawnedProcess::StatisticsCollector *statistics)
+    {
+        m_process.setStatisticsCollector(statistics);
+    }
 
 signals:
     void reportProcessResult(const qbs::ProcessResult &result);
@@ -59,15 +73,37 @@ signals:
 private slots:
     void onProcessError();
     void onProcessFinished(int exitCode);
+    void onReadyReadStandardOutput();
+    void onReadyReadStandardError();
 
 private:
     void doReportCommandDescription();
     void doStart();
     void cancel();
 
+    struct OutputChannel
+    {
+        OutputChannel() : spillFile(0), spillingFailed(false) {}
+
+        QByteArray data;
+        QTemporaryFile *spillFile; // Owned by the executor, removed when the command is done.
+        bool spillingFailed;
+        QSharedPointer<QTextDecoder> decoder; // Keeps incomplete characters between chunks.
+    };
+
     void startProcessCommand();
-    QString filterProcessOutput(const QByteArray &output, const QString &filterFunctionSource);
+    QString filterProcessOutput(const QString &output, const QString &filterFunctionSource);
+    QString filterFunctionSource(QProcess::ProcessChannel channel) const;
+    void handleOutput(QProcess::ProcessChannel channel, const QByteArray &newData);
+    void streamCompleteLines(QProcess::ProcessChannel channel, QByteArray &buffer);
+    void streamOutput(QProcess::ProcessChannel channel, const QByteArray &output);
+    void spillOutput(OutputChannel &channel, const QByteArray &output);
+    void streamSpilledOutput(QProcess::ProcessChannel channel);
+    QStringList collectOutput(QProcess::ProcessChannel channel);
+    void resetOutputChannels();
+    QProcessEnvironment commandEnvironment(const QProcessEnvironment &additionalVariables) const;
     void sendProcessOutput(bool success);
+    QString createInMemoryResponseFile(const QByteArray &contents);
     void removeResponseFile();
     const ProcessCommand *processCommand() const;
 
@@ -75,9 +111,14 @@ private:
     QString m_program;
     QStringList m_arguments;
 
-    QProcess m_process;
+    SpawnedProcess m_process;
     QProcessEnvironment m_buildEnvironment;
     QString m_responseFileName;
+    int m_responseFileDescriptor;
+    bool m_streamOutput;
+    int m_spillThreshold;
+    OutputChannel m_stdOut;
+    OutputChannel m_stdErr;
 };
 
 } // namespace Internal
@@ -36,7 +36,7 @@
 #include <tools/qbsassert.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
-#include <tools/propertyfinder.h>
+#include <tools/propertypath.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
 
@@ -46,6 +46,11 @@
 namespace qbs {
 namespace Internal {
 
+static PropertyPath qbsPropertyPath(const char *propertyName)
+{
+    return PropertyPath::get(QLatin1String("qbs"), QLatin1String(propertyName));
+}
+
 ProductInstaller::ProductInstaller(const TopLevelProjectPtr &project,
         const QList<ResolvedProductPtr> &products, const InstallOptions &options,
         ProgressObserver *observer, const Logger &logger)
@@ -80,11 +85,12 @@ void ProductInstaller::install()
     if (m_options.removeExistingInstallation())
         removeInstallRoot();
 
+    static const PropertyPath installPath = qbsPropertyPath("install");
     QList<const Artifact *> artifactsToInstall;
     foreach (const ResolvedProductConstPtr &product, m_products) {
         QBS_CHECK(product->buildData);
         foreach (const Artifact *artifact, ArtifactSet::fromNodeSet(product->buildData->nodes)) {
-            if (artifact->properties->qbsPropertyValue(QLatin1String("install")).toBool())
+            if (artifact->properties->moduleProperty(installPath).toBool())
                 artifactsToInstall += artifact;
         }
     }
@@ -101,14 +107,17 @@ QString ProductInstaller::targetFilePath(const TopLevelProject *project,
         const QString &sourceFilePath, const PropertyMapConstPtr &properties,
         InstallOptions &options, QString *targetDirectory)
 {
-    if (!properties->qbsPropertyValue(QLatin1String("install")).toBool())
+    static const PropertyPath installPath = qbsPropertyPath("install");
+    static const PropertyPath installDirPath = qbsPropertyPath("installDir");
+    static const PropertyPath installPrefixPath = qbsPropertyPath("installPrefix");
+    static const PropertyPath installSourceBasePath = qbsPropertyPath("installSourceBase");
+
+    if (!properties->moduleProperty(installPath).toBool())
         return QString();
-    const QString relativeInstallDir
-            = properties->qbsPropertyValue(QLatin1String("installDir")).toString();
-    const QString installPrefix
-            = properties->qbsPropertyValue(QLatin1String("installPrefix")).toString();
+    const QString relativeInstallDir = properties->moduleProperty(installDirPath).toString();
+    const QString installPrefix = properties->moduleProperty(installPrefixPath).toString();
     const QString installSourceBase
-            = properties->qbsPropertyValue(QLatin1String("installSourceBase")).toString();
+            = properties->moduleProperty(installSourceBasePath).toString();
     initInstallRoot(project, options);
     QString targetDir = options.installRoot();
     targetDir.append(QLatin1Char('/')).append(installPrefix)
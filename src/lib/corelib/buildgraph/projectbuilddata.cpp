@@ -30,10 +30,12 @@
 #include "projectbuilddata.h"
 
 #include "artifact.h"
+#include "artifactset.h"
 #include "buildgraph.h"
 #include "buildgraphvisitor.h"
 #include "productbuilddata.h"
 #include "command.h"
+#include "filedependency.h"
 #include "rulegraph.h"
 #include "rulenode.h"
 #include "rulesevaluationcontext.h"
@@ -139,6 +141,7 @@ ProjectBuildData::ProjectBuildData(const ProjectBuildData *other)
     if (other) {
         *this = *other;
         m_doCleanupInDestructor = false;
+        topologicalOrder.invalidate();
     }
 }
 
@@ -154,35 +157,75 @@ QString ProjectBuildData::deriveBuildGraphFilePath(const QString &buildDir, cons
     return buildDir + QLatin1Char('/') + projectId + QLatin1String(".bg");
 }
 
+static quint64 lookupKey(int dirId, int fileNameId)
+{
+    return (quint64(quint32(dirId)) << 32) | quint32(fileNameId);
+}
+
 void ProjectBuildData::insertIntoLookupTable(FileResourceBase *fileres)
 {
     QList<FileResourceBase *> &lst
-            = m_artifactLookupTable[fileres->fileName()][fileres->dirPath()];
-    if (!lst.contains(fileres))
-        lst.append(fileres);
+            = m_artifactLookupTable[lookupKey(fileres->dirId(), fileres->fileNameId())];
+    if (lst.contains(fileres))
+        return;
+    lst.append(fileres);
+    if (Artifact * const artifact = dynamic_cast<Artifact *>(fileres)) {
+        foreach (const FileDependency * const dependency, artifact->fileDependencies)
+            m_fileDependencyUsers.insert(dependency, artifact);
+    }
 }
 
 void ProjectBuildData::removeFromLookupTable(FileResourceBase *fileres)
 {
-    m_artifactLookupTable[fileres->fileName()][fileres->dirPath()].removeOne(fileres);
+    const ArtifactLookupTable::iterator it
+            = m_artifactLookupTable.find(lookupKey(fileres->dirId(), fileres->fileNameId()));
+    if (it == m_artifactLookupTable.end())
+        return;
+    const bool removed = it.value().removeOne(fileres);
+    if (it.value().isEmpty())
+        m_artifactLookupTable.erase(it);
+    if (!removed)
+        return;
+    if (Artifact * const artifact = dynamic_cast<Artifact *>(fileres)) {
+        foreach (const FileDependency * const dependency, artifact->fileDependencies)
+            m_fileDependencyUsers.remove(dependency, artifact);
+    }
 }
 
 QList<FileResourceBase *> ProjectBuildData::lookupFiles(const QString &filePath) const
 {
     QString dirPath, fileName;
     FileInfo::splitIntoDirectoryAndFileName(filePath, &dirPath, &fileName);
+    if (!filePath.contains(QLatin1Char('/'))) { // See FileResourceBase::setFilePath().
+        const int fileNameId = PathTable::findFileNameId(fileName);
+        if (fileNameId == PathTable::InvalidId)
+            return QList<FileResourceBase *>();
+        return lookupFiles(PathTable::InvalidId, fileNameId);
+    }
     return lookupFiles(dirPath, fileName);
 }
 
 QList<FileResourceBase *> ProjectBuildData::lookupFiles(const QString &dirPath,
         const QString &fileName) const
 {
-    return m_artifactLookupTable.value(fileName).value(dirPath);
+    // Paths that were never interned cannot be in the table.
+    const int dirId = PathTable::findDirectoryId(dirPath);
+    if (dirId == PathTable::InvalidId)
+        return QList<FileResourceBase *>();
+    const int fileNameId = PathTable::findFileNameId(fileName);
+    if (fileNameId == PathTable::InvalidId)
+        return QList<FileResourceBase *>();
+    return lookupFiles(dirId, fileNameId);
+}
+
+QList<FileResourceBase *> ProjectBuildData::lookupFiles(int dirId, int fileNameId) const
+{
+    return m_artifactLookupTable.value(lookupKey(dirId, fileNameId));
 }
 
 QList<FileResourceBase *> ProjectBuildData::lookupFiles(const Artifact *artifact) const
 {
-    return lookupFiles(artifact->dirPath(), artifact->fileName());
+    return lookupFiles(artifact->dirId(), artifact->fileNameId());
 }
 
 void ProjectBuildData::insertFileDependency(FileDependency *dependency)
@@ -191,6 +234,72 @@ void ProjectBuildData::insertFileDependency(FileDependency *dependency)
     insertIntoLookupTable(dependency);
 }
 
+/*!
+ * Removes the file dependency from the project and from all artifacts using it.
+ * The object itself is not deleted.
+ */
+void ProjectBuildData::removeFileDependency(FileDependency *dependency)
+{
+    foreach (Artifact * const artifact, m_fileDependencyUsers.values(dependency))
+        artifact->fileDependencies.remove(dependency);
+    m_fileDependencyUsers.remove(dependency);
+    fileDependencies.remove(dependency);
+    removeFromLookupTable(dependency);
+}
+
+void ProjectBuildData::addFileDependency(Artifact *artifact, FileDependency *dependency)
+{
+    if (artifact->fileDependencies.contains(dependency))
+        return;
+    artifact->fileDependencies.insert(dependency);
+    m_fileDependencyUsers.insert(dependency, artifact);
+}
+
+void ProjectBuildData::clearFileDependencies(Artifact *artifact)
+{
+    foreach (const FileDependency * const dependency, artifact->fileDependencies)
+        m_fileDependencyUsers.remove(dependency, artifact);
+    artifact->fileDependencies.clear();
+}
+
+QList<Artifact *> ProjectBuildData::artifactsUsingFileDependency(
+        const FileDependency *dependency) const
+{
+    return m_fileDependencyUsers.values(dependency);
+}
+
+ArtifactSet ProjectBuildData::artifactsDependingOn(const QStringList &filePaths) const
+{
+    QList<BuildGraphNode *> nodesToVisit;
+    foreach (const QString &filePath, filePaths) {
+        foreach (FileResourceBase * const fileResource, lookupFiles(filePath)) {
+            if (Artifact * const artifact = dynamic_cast<Artifact *>(fileResource)) {
+                nodesToVisit << artifact;
+            } else {
+                // File dependencies are not nodes, so their users come from the reverse index.
+                foreach (Artifact * const user, artifactsUsingFileDependency(
+                             static_cast<const FileDependency *>(fileResource))) {
+                    nodesToVisit << user;
+                }
+            }
+        }
+    }
+
+    ArtifactSet result;
+    QSet<BuildGraphNode *> visitedNodes;
+    while (!nodesToVisit.isEmpty()) {
+        BuildGraphNode * const node = nodesToVisit.takeLast();
+        if (visitedNodes.contains(node))
+            continue;
+        visitedNodes += node;
+        if (Artifact * const artifact = dynamic_cast<Artifact *>(node))
+            result += artifact;
+        foreach (BuildGraphNode * const parent, node->parents)
+            nodesToVisit << parent;
+    }
+    return result;
+}
+
 static void disconnectArtifactChildren(Artifact *artifact, const Logger &logger)
 {
     if (logger.traceEnabled()) {
@@ -548,10 +657,8 @@ void BuildDataResolver::resolveProductBuildData(const ResolvedProductPtr &produc
         }
     }
 
-    RuleGraph ruleGraph;
-    ruleGraph.build(product->rules, product->fileTags);
     CreateRuleNodes crn(product, m_logger);
-    ruleGraph.accept(&crn);
+    ruleGraph(product)->accept(&crn);
 
     // Connect the leaf rules of this product to the root rules of all product dependencies.
     foreach (const ResolvedProductConstPtr &dep, product->dependencies) {
@@ -567,6 +674,27 @@ void BuildDataResolver::resolveProductBuildData(const ResolvedProductPtr &produc
     }
 }
 
+QSharedPointer<const RuleGraph> BuildDataResolver::ruleGraph(const ResolvedProductConstPtr &product)
+{
+    QList<quintptr> rulePointers;
+    foreach (const RulePtr &rule, product->rules)
+        rulePointers << quintptr(rule.data());
+    qSort(rulePointers);
+    QStringList productFileTags = product->fileTags.toStringList();
+    productFileTags.sort();
+    QString key = productFileTags.join(QLatin1String(",")) + QLatin1Char('|');
+    foreach (const quintptr rulePointer, rulePointers)
+        key += QString::number(rulePointer, 16) + QLatin1Char(',');
+
+    QSharedPointer<const RuleGraph> &graph = m_ruleGraphs[key];
+    if (!graph) {
+        RuleGraph * const newGraph = new RuleGraph;
+        newGraph->build(product->rules, product->fileTags);
+        graph = QSharedPointer<const RuleGraph>(newGraph);
+    }
+    return graph;
+}
+
 RulesEvaluationContextPtr BuildDataResolver::evalContext() const
 {
     return m_project->buildData->evaluationContext;
@@ -31,6 +31,7 @@
 #define QBS_PROJECTBUILDDATA_H
 
 #include "forward_decls.h"
+#include "topologicalorder.h"
 #include <language/forward_decls.h>
 #include <logging/logger.h>
 #include <tools/persistentobject.h>
@@ -39,7 +40,9 @@
 #include <QList>
 #include <QScriptValue>
 #include <QSet>
+#include <QSharedPointer>
 #include <QString>
+#include <QStringList>
 
 namespace qbs {
 namespace Internal {
@@ -47,6 +50,7 @@ class ArtifactSet;
 class BuildGraphNode;
 class FileDependency;
 class FileResourceBase;
+class RuleGraph;
 class ScriptEngine;
 
 class ProjectBuildData : public PersistentObject
@@ -62,8 +66,17 @@ public:
 
     QList<FileResourceBase *> lookupFiles(const QString &filePath) const;
     QList<FileResourceBase *> lookupFiles(const QString &dirPath, const QString &fileName) const;
+    QList<FileResourceBase *> lookupFiles(int dirId, int fileNameId) const;
     QList<FileResourceBase *> lookupFiles(const Artifact *artifact) const;
     void insertFileDependency(FileDependency *dependency);
+    void removeFileDependency(FileDependency *dependency);
+    void addFileDependency(Artifact *artifact, FileDependency *dependency);
+    void clearFileDependencies(Artifact *artifact);
+    QList<Artifact *> artifactsUsingFileDependency(const FileDependency *dependency) const;
+
+    // Returns the artifacts whose build results depend on the given files, directly or indirectly.
+    // The files themselves are included if they are artifacts.
+    ArtifactSet artifactsDependingOn(const QStringList &filePaths) const;
     void removeArtifactAndExclusiveDependents(Artifact *artifact, const Logger &logger,
             bool removeFromProduct = true, ArtifactSet *removedArtifacts = 0);
     void removeArtifact(Artifact *artifact, const Logger &logger, bool removeFromDisk = true,
@@ -75,14 +88,21 @@ public:
     // do not serialize:
     RulesEvaluationContextPtr evaluationContext;
     bool isDirty;
+    TopologicalOrder topologicalOrder;
 
 private:
     void load(PersistentPool &pool);
     void store(PersistentPool &pool) const;
 
-    typedef QHash<QString, QList<FileResourceBase *> > ResultsPerDirectory;
-    typedef QHash<QString, ResultsPerDirectory> ArtifactLookupTable;
+    // Keyed by the PathTable ids of directory and file name.
+    typedef QHash<quint64, QList<FileResourceBase *> > ArtifactLookupTable;
     ArtifactLookupTable m_artifactLookupTable;
+
+    // Reverse index of Artifact::fileDependencies for the artifacts in the lookup table.
+    // Not serialized; it is rebuilt when the artifacts are put into the lookup table on loading.
+    typedef QMultiHash<const FileDependency *, Artifact *> FileDependencyUsers;
+    FileDependencyUsers m_fileDependencyUsers;
+
     bool m_doCleanupInDestructor;
 };
 
@@ -98,12 +118,16 @@ public:
 
 private:
     void resolveProductBuildData(const ResolvedProductPtr &product);
+    QSharedPointer<const RuleGraph> ruleGraph(const ResolvedProductConstPtr &product);
     RulesEvaluationContextPtr evalContext() const;
     ScriptEngine *engine() const;
     QScriptValue scope() const;
 
     TopLevelProjectPtr m_project;
     Logger m_logger;
+
+    // Products with the same rules and file tags share their rule graph.
+    QHash<QString, QSharedPointer<const RuleGraph> > m_ruleGraphs;
 };
 
 } // namespace Internal
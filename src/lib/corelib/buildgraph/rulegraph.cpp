@@ -75,14 +75,14 @@ void RuleGraph::build(const QSet<RulePtr> &rules, const FileTags &productFileTag
         //### check: the rule graph must be a in valid shape!
     }
     foreach (const Rule *r, productRules)
-        m_rootRules += r->ruleGraphId;
+        m_rootRules += m_ruleIndices.value(r);
 }
 
 void RuleGraph::accept(RuleGraphVisitor *visitor) const
 {
     const RuleConstPtr nullParent;
     foreach (int rootIndex, m_rootRules)
-        traverse(visitor, nullParent, m_rules.at(rootIndex));
+        traverse(visitor, nullParent, rootIndex);
 }
 
 void RuleGraph::dump() const
@@ -90,9 +90,9 @@ void RuleGraph::dump() const
     QByteArray indent;
     printf("---rule graph dump:\n");
     QSet<int> rootRules;
-    foreach (const RuleConstPtr &rule, m_rules)
-        if (m_parents[rule->ruleGraphId].isEmpty())
-            rootRules += rule->ruleGraphId;
+    for (int i = 0; i < m_rules.count(); ++i)
+        if (m_parents[i].isEmpty())
+            rootRules += i;
     foreach (int idx, rootRules) {
         dump_impl(indent, idx);
     }
@@ -113,29 +113,33 @@ void RuleGraph::dump_impl(QByteArray &indent, int rootIndex) const
 
 int RuleGraph::insert(const RulePtr &rule)
 {
-    rule->ruleGraphId = m_rules.count();
+    const int index = m_rules.count();
+    m_ruleIndices.insert(rule.data(), index);
     m_rules.append(rule);
-    return rule->ruleGraphId;
+    return index;
 }
 
 void RuleGraph::connect(const Rule *creatingRule, const Rule *consumingRule)
 {
-    int maxIndex = qMax(creatingRule->ruleGraphId, consumingRule->ruleGraphId);
+    const int creatingIndex = m_ruleIndices.value(creatingRule);
+    const int consumingIndex = m_ruleIndices.value(consumingRule);
+    int maxIndex = qMax(creatingIndex, consumingIndex);
     if (m_parents.count() <= maxIndex) {
         const int c = maxIndex + 1;
         m_parents.resize(c);
         m_children.resize(c);
     }
-    m_parents[consumingRule->ruleGraphId].append(creatingRule->ruleGraphId);
-    m_children[creatingRule->ruleGraphId].append(consumingRule->ruleGraphId);
+    m_parents[consumingIndex].append(creatingIndex);
+    m_children[creatingIndex].append(consumingIndex);
 }
 
 void RuleGraph::traverse(RuleGraphVisitor *visitor, const RuleConstPtr &parentRule,
-        const RuleConstPtr &rule) const
+                         int ruleIndex) const
 {
+    const RuleConstPtr rule = m_rules.at(ruleIndex);
     visitor->visit(parentRule, rule);
-    foreach (int childIndex, m_children.at(rule->ruleGraphId))
-        traverse(visitor, rule, m_rules.at(childIndex));
+    foreach (int childIndex, m_children.at(ruleIndex))
+        traverse(visitor, rule, childIndex);
     visitor->endVisit(rule);
 }
 
@@ -34,6 +34,7 @@
 #include <language/filetags.h>
 #include <language/forward_decls.h>
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QSet>
@@ -50,6 +51,8 @@ public:
     virtual void endVisit(const RuleConstPtr &rule) { Q_UNUSED(rule); }
 };
 
+// Rule objects can be shared between products, so a rule graph must not store
+// anything in them. For the same reason, a rule graph is immutable once it has been built.
 class RuleGraph
 {
 public:
@@ -64,12 +67,12 @@ private:
     void dump_impl(QByteArray &indent, int rootIndex) const;
     int insert(const RulePtr &rule);
     void connect(const Rule *creatingRule, const Rule *consumingRule);
-    void traverse(RuleGraphVisitor *visitor, const RuleConstPtr &parentRule,
-            const RuleConstPtr &rule) const;
+    void traverse(RuleGraphVisitor *visitor, const RuleConstPtr &parentRule, int ruleIndex) const;
 
 private:
     QMap<FileTag, QList<const Rule*> > m_outputFileTagToRule;
     QVector<RulePtr> m_rules;
+    QHash<const Rule *, int> m_ruleIndices;
     QVector< QVector<int> > m_parents;
     QVector< QVector<int> > m_children;
     QSet<int> m_rootRules;
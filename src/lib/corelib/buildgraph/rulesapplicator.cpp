@@ -45,6 +45,7 @@
 #include <language/scriptengine.h>
 #include <logging/translator.h>
 #include <tools/error.h>
+#include <tools/metricscollector.h>
 #include <tools/scripttools.h>
 #include <tools/qbsassert.h>
 
@@ -81,6 +82,9 @@ void RulesApplicator::applyRule(const RuleConstPtr &rule, const ArtifactSet &inp
     if (inputArtifacts.isEmpty())
         return;
 
+    PhaseTimer phaseTimer(m_logger, Metrics::RuleApplication);
+    if (const MetricsCollectorPtr collector = m_logger.metricsCollector())
+        collector->addToCounter(Metrics::AppliedRules);
     m_rule = rule;
     m_completeInputSet = inputArtifacts;
     if (rule->name == QLatin1String("QtCoreMocRule")) {
@@ -237,6 +241,8 @@ void RulesApplicator::doApply(const ArtifactSet &inputArtifacts, QScriptValue &p
         QVariantMap outputArtifactConfig = outputArtifact->properties->value();
         outputArtifactConfig.insert(QLatin1String("modules"), artifactModulesCfg);
         outputArtifact->properties->setValue(outputArtifactConfig);
+        outputArtifact->properties = m_product->topLevelProject()->propertyMapPool
+                .intern(outputArtifact->properties);
     }
     if (!ruleArtifactArtifactMap.isEmpty())
         engine()->currentContext()->popScope();
@@ -340,7 +346,9 @@ Artifact *RulesApplicator::createOutputArtifact(const QString &filePath, const F
     }
 
     // Let a positive value of qbs.install imply the file tag "installable".
-    if (outputArtifact->properties->qbsPropertyValue(QLatin1String("install")).toBool())
+    static const PropertyPath installPath = PropertyPath::get(QLatin1String("qbs"),
+                                                              QLatin1String("install"));
+    if (outputArtifact->properties->moduleProperty(installPath).toBool())
         outputArtifact->addFileTag("installable");
 
     foreach (Artifact *inputArtifact, inputArtifacts) {
@@ -439,6 +447,8 @@ public:
             setConfigProperty(artifactCfg, valuePath, nvp.second);
         }
         outputArtifact->properties->setValue(artifactCfg);
+        outputArtifact->properties = outputArtifact->product->topLevelProject()->propertyMapPool
+                .intern(outputArtifact->properties);
     }
 
     QStringList findValuePath(const QVariantMap &cfg, const QStringList &nameParts)
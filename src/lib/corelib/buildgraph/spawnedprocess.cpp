@@ -0,0 +1,509 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "spawnedprocess.h"
+
+#include <tools/qbsassert.h>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+// Setting the child's working directory is a glibc extension.
+#if defined(Q_OS_UNIX) && defined(__GLIBC__) \
+    && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define QBS_USE_POSIX_SPAWN
+#endif
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class SpawnedProcess
+ * \brief The \c SpawnedProcess class runs an external process with as little overhead as possible.
+ * It provides the subset of the \c QProcess interface that is needed for running commands.
+ * \c QProcess forks, which takes longer the more memory the qbs process uses. Where possible,
+ * the process is therefore created via \c posix_spawn() instead, which glibc implements
+ * without copying the address space. Elsewhere, \c QProcess is used.
+ * In contrast to \c QProcess, the standard input of a spawned process is the null device.
+ * The time needed for starting processes is recorded in the \c StatisticsCollector set
+ * via \c setStatisticsCollector(), if there is one.
+ */
+
+SpawnedProcess::SpawnedProcess(QObject *parent)
+    : QObject(parent)
+    , m_statisticsCollector(0)
+    , m_useQProcess(!usesPosixSpawn())
+    , m_state(QProcess::NotRunning)
+    , m_error(QProcess::UnknownError)
+    , m_exitStatus(QProcess::NormalExit)
+    , m_exitCode(0)
+    , m_pid(0)
+    , m_pidFd(-1)
+    , m_exitNotifier(0)
+    , m_exitPollTimer(new QTimer(this))
+{
+    connect(&m_process, SIGNAL(error(QProcess::ProcessError)),
+            SIGNAL(error(QProcess::ProcessError)));
+    connect(&m_process, SIGNAL(finished(int)), SIGNAL(finished(int)));
+    connect(&m_process, SIGNAL(readyReadStandardOutput()), SIGNAL(readyReadStandardOutput()));
+    connect(&m_process, SIGNAL(readyReadStandardError()), SIGNAL(readyReadStandardError()));
+    m_exitPollTimer->setInterval(10);
+    connect(m_exitPollTimer, SIGNAL(timeout()), SLOT(checkForExit()));
+}
+
+SpawnedProcess::~SpawnedProcess()
+{
+#if defined(Q_OS_UNIX)
+    if (!m_useQProcess && m_state == QProcess::Running) {
+        ::kill(m_pid, SIGKILL);
+        ::waitpid(m_pid, 0, 0);
+    }
+#endif
+    cleanup();
+}
+
+bool SpawnedProcess::usesPosixSpawn()
+{
+#ifdef QBS_USE_POSIX_SPAWN
+    return true;
+#else
+    return false;
+#endif
+}
+
+SpawnedProcess::Statistics SpawnedProcess::StatisticsCollector::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+void SpawnedProcess::StatisticsCollector::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_statistics = Statistics();
+}
+
+void SpawnedProcess::StatisticsCollector::addLaunchTime(qint64 nsecs)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_statistics.launchCount;
+    m_statistics.totalLaunchTime += nsecs;
+    m_statistics.maxLaunchTime = qMax(m_statistics.maxLaunchTime, nsecs);
+}
+
+void SpawnedProcess::setProcessEnvironment(const QProcessEnvironment &environment)
+{
+    m_environment = environment;
+    m_process.setProcessEnvironment(environment);
+}
+
+void SpawnedProcess::setWorkingDirectory(const QString &workingDirectory)
+{
+    m_workingDirectory = workingDirectory;
+    m_process.setWorkingDirectory(workingDirectory);
+}
+
+void SpawnedProcess::start(const QString &program, const QStringList &arguments)
+{
+    QBS_ASSERT(state() == QProcess::NotRunning, return);
+    QElapsedTimer timer;
+    timer.start();
+    if (m_useQProcess)
+        startQProcess(program, arguments);
+    else
+        spawn(program, arguments);
+    if (m_statisticsCollector)
+        m_statisticsCollector->addLaunchTime(timer.nsecsElapsed());
+}
+
+void SpawnedProcess::startQProcess(const QString &program, const QStringList &arguments)
+{
+#if defined(Q_OS_UNIX)
+    // QProcess forks in start(), so the descriptors only need to be inheritable that long.
+    // Processes started by other threads in the meantime inherit them as well.
+    QList<int> restoredFds;
+    foreach (const int fd, m_inheritedFds) {
+        const int flags = ::fcntl(fd, F_GETFD);
+        if (flags != -1 && (flags & FD_CLOEXEC)
+                && ::fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC) != -1) {
+            restoredFds << fd;
+        }
+    }
+    m_process.start(program, arguments);
+    foreach (const int fd, restoredFds)
+        ::fcntl(fd, F_SETFD, ::fcntl(fd, F_GETFD) | FD_CLOEXEC);
+#else
+    m_process.start(program, arguments);
+#endif
+}
+
+void SpawnedProcess::terminate()
+{
+    if (m_useQProcess) {
+        m_process.terminate();
+        return;
+    }
+#if defined(Q_OS_UNIX)
+    if (m_state == QProcess::Running)
+        ::kill(m_pid, SIGTERM);
+#endif
+}
+
+void SpawnedProcess::kill()
+{
+    if (m_useQProcess) {
+        m_process.kill();
+        return;
+    }
+#if defined(Q_OS_UNIX)
+    if (m_state == QProcess::Running)
+        ::kill(m_pid, SIGKILL);
+#endif
+}
+
+bool SpawnedProcess::waitForFinished(int msecs)
+{
+    if (m_useQProcess)
+        return m_process.waitForFinished(msecs);
+    QElapsedTimer timer;
+    timer.start();
+    while (true) {
+        checkForExit();
+        if (m_state != QProcess::Running)
+            return true;
+        if (timer.elapsed() >= msecs)
+            return false;
+        QThread::msleep(5);
+    }
+}
+
+QProcess::ProcessState SpawnedProcess::state() const
+{
+    return m_useQProcess ? m_process.state() : m_state;
+}
+
+QProcess::ProcessError SpawnedProcess::error() const
+{
+    return m_useQProcess ? m_process.error() : m_error;
+}
+
+QString SpawnedProcess::errorString() const
+{
+    return m_useQProcess ? m_process.errorString() : m_errorString;
+}
+
+int SpawnedProcess::exitCode() const
+{
+    return m_useQProcess ? m_process.exitCode() : m_exitCode;
+}
+
+QProcess::ExitStatus SpawnedProcess::exitStatus() const
+{
+    return m_useQProcess ? m_process.exitStatus() : m_exitStatus;
+}
+
+QByteArray SpawnedProcess::readAllStandardOutput()
+{
+    if (m_useQProcess)
+        return m_process.readAllStandardOutput();
+    const QByteArray data = m_stdOut.data;
+    m_stdOut.data.clear();
+    return data;
+}
+
+QByteArray SpawnedProcess::readAllStandardError()
+{
+    if (m_useQProcess)
+        return m_process.readAllStandardError();
+    const QByteArray data = m_stdErr.data;
+    m_stdErr.data.clear();
+    return data;
+}
+
+#ifdef QBS_USE_POSIX_SPAWN
+static bool createPipe(int fds[2])
+{
+    // Close-on-exec, so that processes spawned concurrently do not inherit our ends.
+#if defined(Q_OS_LINUX)
+    if (::pipe2(fds, O_CLOEXEC) != 0)
+        return false;
+#else
+    if (::pipe(fds) != 0)
+        return false;
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+static QVector<char *> toCharPointers(const QList<QByteArray> &strings)
+{
+    QVector<char *> pointers;
+    pointers.reserve(strings.count() + 1);
+    foreach (const QByteArray &s, strings)
+        pointers << const_cast<char *>(s.constData());
+    pointers << 0;
+    return pointers;
+}
+#endif // QBS_USE_POSIX_SPAWN
+
+void SpawnedProcess::spawn(const QString &program, const QStringList &arguments)
+{
+#ifdef QBS_USE_POSIX_SPAWN
+    m_error = QProcess::UnknownError;
+    m_errorString.clear();
+    m_exitStatus = QProcess::NormalExit;
+    m_exitCode = 0;
+    m_stdOut.data.clear();
+    m_stdErr.data.clear();
+
+    int stdOutPipe[2];
+    int stdErrPipe[2];
+    if (!createPipe(stdOutPipe)) {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        QTimer::singleShot(0, this, SLOT(reportStartFailure()));
+        return;
+    }
+    if (!createPipe(stdErrPipe)) {
+        m_errorString = QString::fromLocal8Bit(::strerror(errno));
+        ::close(stdOutPipe[0]);
+        ::close(stdOutPipe[1]);
+        QTimer::singleShot(0, this, SLOT(reportStartFailure()));
+        return;
+    }
+
+    const QByteArray workingDir = QFile::encodeName(m_workingDirectory);
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&fileActions, stdOutPipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&fileActions, stdErrPipe[1], STDERR_FILENO);
+    if (!workingDir.isEmpty())
+        posix_spawn_file_actions_addchdir_np(&fileActions, workingDir.constData());
+
+    // Since glibc 2.29, dup2() onto the same descriptor clears its close-on-exec flag
+    // in the child only.
+    foreach (const int fd, m_inheritedFds)
+        posix_spawn_file_actions_adddup2(&fileActions, fd, fd);
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t signalMask;
+    sigemptyset(&signalMask);
+    posix_spawnattr_setsigmask(&attributes, &signalMask);
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    const QByteArray programData = QFile::encodeName(program);
+    QList<QByteArray> argumentList;
+    argumentList << programData;
+    foreach (const QString &argument, arguments)
+        argumentList << argument.toLocal8Bit();
+    QVector<char *> argv = toCharPointers(argumentList);
+    QList<QByteArray> environmentList;
+    foreach (const QString &entry, m_environment.toStringList())
+        environmentList << entry.toLocal8Bit();
+    QVector<char *> envp = toCharPointers(environmentList);
+
+    // Like QProcess, use our own environment if none was set.
+    pid_t pid;
+    const int result = posix_spawnp(&pid, programData.constData(), &fileActions, &attributes,
+                                    argv.data(), m_environment.isEmpty() ? environ : envp.data());
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&fileActions);
+    ::close(stdOutPipe[1]);
+    ::close(stdErrPipe[1]);
+    if (result != 0) {
+        ::close(stdOutPipe[0]);
+        ::close(stdErrPipe[0]);
+        m_errorString = QString::fromLocal8Bit(::strerror(result));
+        QTimer::singleShot(0, this, SLOT(reportStartFailure())); // Like QProcess.
+        return;
+    }
+
+    m_pid = pid;
+    m_state = QProcess::Running;
+    m_stdOut.fd = stdOutPipe[0];
+    m_stdOut.notifier = new QSocketNotifier(m_stdOut.fd, QSocketNotifier::Read, this);
+    connect(m_stdOut.notifier, SIGNAL(activated(int)), SLOT(readStandardOutput()));
+    m_stdErr.fd = stdErrPipe[0];
+    m_stdErr.notifier = new QSocketNotifier(m_stdErr.fd, QSocketNotifier::Read, this);
+    connect(m_stdErr.notifier, SIGNAL(activated(int)), SLOT(readStandardError()));
+
+    // A pidfd becomes readable when the process exits. Older kernels need polling.
+#if defined(SYS_pidfd_open)
+    m_pidFd = ::syscall(SYS_pidfd_open, pid, 0);
+#endif
+    if (m_pidFd != -1) {
+        m_exitNotifier = new QSocketNotifier(m_pidFd, QSocketNotifier::Read, this);
+        connect(m_exitNotifier, SIGNAL(activated(int)), SLOT(checkForExit()));
+    } else {
+        m_exitPollTimer->start();
+    }
+#else
+    Q_UNUSED(program);
+    Q_UNUSED(arguments);
+    QBS_ASSERT(!"posix_spawn() not supported", return);
+#endif // QBS_USE_POSIX_SPAWN
+}
+
+bool SpawnedProcess::readChannel(Channel &channel)
+{
+#if defined(Q_OS_UNIX)
+    bool dataRead = false;
+    while (channel.fd != -1) {
+        char buffer[64 * 1024];
+        const ssize_t bytesRead = ::read(channel.fd, buffer, sizeof buffer);
+        if (bytesRead > 0) {
+            channel.data.append(buffer, bytesRead);
+            dataRead = true;
+        } else if (bytesRead == 0 || (errno != EINTR && errno != EAGAIN)) {
+            closeChannel(channel);
+        } else if (errno == EAGAIN) {
+            break;
+        }
+    }
+    return dataRead;
+#else
+    Q_UNUSED(channel);
+    return false;
+#endif
+}
+
+void SpawnedProcess::closeChannel(Channel &channel)
+{
+    if (channel.notifier) {
+        channel.notifier->setEnabled(false);
+        channel.notifier->deleteLater();
+        channel.notifier = 0;
+    }
+#if defined(Q_OS_UNIX)
+    if (channel.fd != -1)
+        ::close(channel.fd);
+#endif
+    channel.fd = -1;
+}
+
+void SpawnedProcess::readStandardOutput()
+{
+    if (readChannel(m_stdOut))
+        emit readyReadStandardOutput();
+}
+
+void SpawnedProcess::readStandardError()
+{
+    if (readChannel(m_stdErr))
+        emit readyReadStandardError();
+}
+
+void SpawnedProcess::checkForExit()
+{
+#if defined(Q_OS_UNIX)
+    if (m_state != QProcess::Running)
+        return;
+    int status;
+    pid_t result;
+    do {
+        result = ::waitpid(m_pid, &status, WNOHANG);
+    } while (result == -1 && errno == EINTR);
+    if (result == 0)
+        return;
+    if (result == -1) { // Someone else reaped our child; we cannot know the outcome.
+        m_exitStatus = QProcess::CrashExit;
+        m_exitCode = -1;
+    } else if (WIFEXITED(status)) {
+        m_exitStatus = QProcess::NormalExit;
+        m_exitCode = WEXITSTATUS(status);
+    } else {
+        m_exitStatus = QProcess::CrashExit;
+        m_exitCode = WIFSIGNALED(status) ? WTERMSIG(status) : -1;
+    }
+
+    // Get the rest of the output. Processes the child left behind might still have the
+    // pipes open, so we stop at what is currently available.
+    readStandardOutput();
+    readStandardError();
+    cleanup();
+    m_state = QProcess::NotRunning;
+    if (m_exitStatus == QProcess::CrashExit) {
+        m_error = QProcess::Crashed;
+        emit error(QProcess::Crashed);
+    }
+    emit finished(m_exitCode);
+#endif
+}
+
+void SpawnedProcess::reportStartFailure()
+{
+    m_error = QProcess::FailedToStart;
+    emit error(QProcess::FailedToStart);
+}
+
+void SpawnedProcess::cleanup()
+{
+    closeChannel(m_stdOut);
+    closeChannel(m_stdErr);
+    m_exitPollTimer->stop();
+    if (m_exitNotifier) {
+        m_exitNotifier->setEnabled(false);
+        m_exitNotifier->deleteLater();
+        m_exitNotifier = 0;
+    }
+#if defined(Q_OS_UNIX)
+    if (m_pidFd != -1)
+        ::close(m_pidFd);
+#endif
+    m_pidFd = -1;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#ifndef QBS_SPAWNEDPROCESS_H
+#define QBS_SPAWNEDPROCESS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QString>
+#include <QStringList>
+
+QT_BEGIN_NAMESPACE
+class QSocketNotifier;
+class QTimer;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+class SpawnedProcess : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SpawnedProcess(QObject *parent = 0);
+    ~SpawnedProcess();
+
+    struct Statistics
+    {
+        Statistics() : launchCount(0), totalLaunchTime(0), maxLaunchTime(0) {}
+
+        int launchCount;
+        qint64 totalLaunchTime; // In nanoseconds.
+        qint64 maxLaunchTime;
+    };
+
+    // Accumulates the launch times of all processes it is set on. Thread-safe.
+    class StatisticsCollector
+    {
+    public:
+        Statistics statistics() const;
+        void reset();
+        void addLaunchTime(qint64 nsecs);
+
+    private:
+        mutable QMutex m_mutex;
+        Statistics m_statistics;
+    };
+
+    static bool usesPosixSpawn();
+    void setStatisticsCollector(StatisticsCollector *collector)
+    {
+        m_statisticsCollector = collector;
+    }
+
+    void setProcessEnvironment(const QProcessEnvironment &environment);
+    void setWorkingDirectory(const QString &workingDirectory);
+    QString workingDirectory() const { return m_workingDirectory; }
+
+    // Close-on-exec descriptors that the process should inherit nonetheless.
+    void setInheritedFileDescriptors(const QList<int> &fds) { m_inheritedFds = fds; }
+
+    void start(const QString &program, const QStringList &arguments);
+    void terminate();
+    void kill();
+    bool waitForFinished(int msecs);
+
+    QProcess::ProcessState state() const;
+    QProcess::ProcessError error() const;
+    QString errorString() const;
+    int exitCode() const;
+    QProcess::ExitStatus exitStatus() const;
+    QByteArray readAllStandardOutput();
+    QByteArray readAllStandardError();
+
+signals:
+    void error(QProcess::ProcessError error);
+    void finished(int exitCode);
+    void readyReadStandardOutput();
+    void readyReadStandardError();
+
+private slots:
+    void readStandardOutput();
+    void readStandardError();
+    void checkForExit();
+    void reportStartFailure();
+
+private:
+    struct Channel
+    {
+        Channel() : fd(-1), notifier(0) {}
+
+        int fd;
+        QSocketNotifier *notifier;
+        QByteArray data;
+    };
+
+    void startQProcess(const QString &program, const QStringList &arguments);
+    void spawn(const QString &program, const QStringList &arguments);
+    bool readChannel(Channel &channel);
+    void closeChannel(Channel &channel);
+    void cleanup();
+
+    StatisticsCollector *m_statisticsCollector;
+    QProcess m_process;
+    bool m_useQProcess;
+    QProcessEnvironment m_environment;
+    QString m_workingDirectory;
+    QList<int> m_inheritedFds;
+    QProcess::ProcessState m_state;
+    QProcess::ProcessError m_error;
+    QString m_errorString;
+    QProcess::ExitStatus m_exitStatus;
+    int m_exitCode;
+    qint64 m_pid;
+    int m_pidFd;
+    QSocketNotifier *m_exitNotifier;
+    QTimer *m_exitPollTimer;
+    Channel m_stdOut;
+    Channel m_stdErr;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_SPAWNEDPROCESS_H
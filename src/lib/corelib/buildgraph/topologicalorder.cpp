@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "topologicalorder.h"
+
+#include "buildgraphnode.h"
+#include "productbuilddata.h"
+#include <language/language.h>
+#include <tools/qbsassert.h>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+// Shared by all instances, so that an index left over in a node from an earlier order
+// is never mistaken for a current one.
+static QAtomicInt generationCounter;
+
+static bool compareIndexes(const BuildGraphNode *n1, const BuildGraphNode *n2)
+{
+    return n1->topologicalIndex < n2->topologicalIndex;
+}
+
+TopologicalOrder::TopologicalOrder()
+    : m_valid(false), m_generation(0), m_lowestIndex(0), m_highestIndex(-1)
+{
+}
+
+bool TopologicalOrder::ensureValid(const TopLevelProject *project,
+                                   const QList<BuildGraphNode *> &extraNodes)
+{
+    if (m_valid)
+        return true;
+
+    QList<BuildGraphNode *> stack = extraNodes;
+    foreach (const ResolvedProductPtr &product, project->allProducts()) {
+        if (!product->buildData)
+            continue;
+        foreach (BuildGraphNode * const node, product->buildData->nodes)
+            stack << node;
+    }
+
+    // Nodes can be connected to nodes of other products, so look at the whole components.
+    QList<BuildGraphNode *> allNodes;
+    QSet<BuildGraphNode *> seenNodes;
+    while (!stack.isEmpty()) {
+        BuildGraphNode * const node = stack.takeLast();
+        if (seenNodes.contains(node))
+            continue;
+        seenNodes.insert(node);
+        allNodes << node;
+        for (NodeSet::const_iterator it = node->children.begin(); it != node->children.end(); ++it)
+            stack << *it;
+        for (NodeSet::const_iterator it = node->parents.begin(); it != node->parents.end(); ++it)
+            stack << *it;
+    }
+
+    m_generation = generationCounter.fetchAndAddRelaxed(1) + 1;
+    QHash<BuildGraphNode *, int> remainingParentCounts;
+    QList<BuildGraphNode *> readyNodes;
+    foreach (BuildGraphNode * const node, allNodes) {
+        if (node->parents.isEmpty())
+            readyNodes << node;
+        else
+            remainingParentCounts.insert(node, node->parents.count());
+    }
+    int index = 0;
+    while (!readyNodes.isEmpty()) {
+        BuildGraphNode * const node = readyNodes.takeLast();
+        setIndex(node, index++);
+        for (NodeSet::const_iterator it = node->children.begin(); it != node->children.end();
+             ++it) {
+            if (--remainingParentCounts[*it] == 0)
+                readyNodes << *it;
+        }
+    }
+
+    // Nodes on a cycle never become ready.
+    m_valid = index == allNodes.count();
+    m_lowestIndex = 0;
+    m_highestIndex = index - 1;
+    return m_valid;
+}
+
+bool TopologicalOrder::prepareEdge(BuildGraphNode *parent, BuildGraphNode *child)
+{
+    QBS_CHECK(m_valid);
+
+    // A node without an index has no edges yet, so it cannot be part of a cycle.
+    if (!hasIndex(parent) || !hasIndex(child))
+        return true;
+    if (parent->topologicalIndex < child->topologicalIndex)
+        return true;
+
+    QList<BuildGraphNode *> forwardNodes;
+    if (!collectForward(child, parent->topologicalIndex, parent, forwardNodes))
+        return false;
+    QList<BuildGraphNode *> backwardNodes;
+    collectBackward(parent, child->topologicalIndex, backwardNodes);
+    reorder(backwardNodes, forwardNodes);
+    return true;
+}
+
+void TopologicalOrder::edgeAdded(BuildGraphNode *parent, BuildGraphNode *child)
+{
+    if (!m_valid)
+        return;
+
+    const bool parentHasIndex = hasIndex(parent);
+    const bool childHasIndex = hasIndex(child);
+    if (parentHasIndex && childHasIndex) {
+        if (!prepareEdge(parent, child))
+            invalidate();
+        return;
+    }
+
+    // Nodes get their index when they are connected for the first time. If a node without
+    // an index already has other edges, we cannot know where it belongs.
+    if ((!parentHasIndex && (!parent->parents.isEmpty() || parent->children.count() > 1))
+            || (!childHasIndex && (!child->children.isEmpty() || child->parents.count() > 1))) {
+        invalidate();
+        return;
+    }
+    if (!parentHasIndex && !childHasIndex) {
+        setIndex(parent, ++m_highestIndex);
+        setIndex(child, ++m_highestIndex);
+    } else if (!parentHasIndex) {
+        setIndex(parent, --m_lowestIndex);
+    } else {
+        setIndex(child, ++m_highestIndex);
+    }
+}
+
+bool TopologicalOrder::hasIndex(const BuildGraphNode *node) const
+{
+    return node->topologicalOrderGeneration == m_generation;
+}
+
+void TopologicalOrder::setIndex(BuildGraphNode *node, int index)
+{
+    node->topologicalIndex = index;
+    node->topologicalOrderGeneration = m_generation;
+}
+
+// Collects all descendants of start whose index is lower than upperBound.
+// Returns false if target is among them.
+bool TopologicalOrder::collectForward(BuildGraphNode *start, int upperBound,
+        BuildGraphNode *target, QList<BuildGraphNode *> &nodes) const
+{
+    QSet<BuildGraphNode *> seenNodes;
+    QList<BuildGraphNode *> stack;
+    stack << start;
+    seenNodes.insert(start);
+    while (!stack.isEmpty()) {
+        BuildGraphNode * const node = stack.takeLast();
+        nodes << node;
+        for (NodeSet::const_iterator it = node->children.begin(); it != node->children.end();
+             ++it) {
+            BuildGraphNode * const child = *it;
+            if (child == target)
+                return false;
+            if (!hasIndex(child) || child->topologicalIndex >= upperBound
+                    || seenNodes.contains(child)) {
+                continue;
+            }
+            seenNodes.insert(child);
+            stack << child;
+        }
+    }
+    return true;
+}
+
+// Collects all ancestors of start whose index is higher than lowerBound.
+void TopologicalOrder::collectBackward(BuildGraphNode *start, int lowerBound,
+                                       QList<BuildGraphNode *> &nodes) const
+{
+    QSet<BuildGraphNode *> seenNodes;
+    QList<BuildGraphNode *> stack;
+    stack << start;
+    seenNodes.insert(start);
+    while (!stack.isEmpty()) {
+        BuildGraphNode * const node = stack.takeLast();
+        nodes << node;
+        for (NodeSet::const_iterator it = node->parents.begin(); it != node->parents.end();
+             ++it) {
+            BuildGraphNode * const parent = *it;
+            if (!hasIndex(parent) || parent->topologicalIndex <= lowerBound
+                    || seenNodes.contains(parent)) {
+                continue;
+            }
+            seenNodes.insert(parent);
+            stack << parent;
+        }
+    }
+}
+
+// Hands out the indexes of the affected nodes anew, so that all ancestors of the new edge's
+// parent come before all descendants of its child. Everything else keeps its position.
+void TopologicalOrder::reorder(QList<BuildGraphNode *> &backwardNodes,
+                               QList<BuildGraphNode *> &forwardNodes)
+{
+    std::sort(backwardNodes.begin(), backwardNodes.end(), compareIndexes);
+    std::sort(forwardNodes.begin(), forwardNodes.end(), compareIndexes);
+    QList<int> indexes;
+    foreach (const BuildGraphNode * const node, backwardNodes)
+        indexes << node->topologicalIndex;
+    foreach (const BuildGraphNode * const node, forwardNodes)
+        indexes << node->topologicalIndex;
+    std::sort(indexes.begin(), indexes.end());
+
+    int i = 0;
+    foreach (BuildGraphNode * const node, backwardNodes)
+        setIndex(node, indexes.at(i++));
+    foreach (BuildGraphNode * const node, forwardNodes)
+        setIndex(node, indexes.at(i++));
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_TOPOLOGICALORDER_H
+#define QBS_TOPOLOGICALORDER_H
+
+#include <QList>
+
+namespace qbs {
+namespace Internal {
+class BuildGraphNode;
+class TopLevelProject;
+
+// Keeps the nodes of a build graph in an order in which every node comes before its children,
+// using the incremental algorithm by Pearce and Kelly. Inserting an edge that agrees with the
+// current order is constant-time; otherwise, only the nodes between the two endpoints
+// are visited.
+// If the graph contains a cycle, the order is marked as invalid, and callers have to
+// fall back to a full search.
+class TopologicalOrder
+{
+public:
+    TopologicalOrder();
+
+    bool isValid() const { return m_valid; }
+    void invalidate() { m_valid = false; }
+
+    // Computes the order from scratch, if necessary. Returns false if the graph is cyclic.
+    bool ensureValid(const TopLevelProject *project, const QList<BuildGraphNode *> &extraNodes);
+
+    // Rearranges the order so that the edge parent -> child can be added.
+    // Returns false if that edge would close a cycle, in which case nothing is changed.
+    // The order must be valid.
+    bool prepareEdge(BuildGraphNode *parent, BuildGraphNode *child);
+
+    // To be called whenever an edge was added to the graph.
+    void edgeAdded(BuildGraphNode *parent, BuildGraphNode *child);
+
+private:
+    bool hasIndex(const BuildGraphNode *node) const;
+    void setIndex(BuildGraphNode *node, int index);
+    bool collectForward(BuildGraphNode *start, int upperBound, BuildGraphNode *target,
+                        QList<BuildGraphNode *> &nodes) const;
+    void collectBackward(BuildGraphNode *start, int lowerBound,
+                         QList<BuildGraphNode *> &nodes) const;
+    void reorder(QList<BuildGraphNode *> &backwardNodes, QList<BuildGraphNode *> &forwardNodes);
+
+    bool m_valid;
+    int m_generation;
+    int m_lowestIndex;
+    int m_highestIndex;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_TOPOLOGICALORDER_H
@@ -32,14 +32,23 @@
 #include <buildgraph/artifact.h>
 #include <buildgraph/buildgraph.h>
 #include <buildgraph/cycledetector.h>
+#include <buildgraph/filedependency.h>
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/projectbuilddata.h>
+#include <buildgraph/spawnedprocess.h>
+#include <buildgraph/topologicalorder.h>
 #include <language/language.h>
 #include <logging/logger.h>
 #include <tools/error.h>
+#include <tools/hostosinfo.h>
 
 #include <QtTest>
 
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace qbs {
 namespace Internal {
 
@@ -127,5 +136,195 @@ void TestBuildGraph::testCycle()
     QVERIFY(!cycleDetected(productWithNoCycle()));
 }
 
+void TestBuildGraph::testLookupTable()
+{
+    ProjectBuildData buildData;
+    Artifact * const artifact = new Artifact;
+    artifact->setFilePath(QLatin1String("/some/dir/file.h"));
+    Artifact * const otherArtifact = new Artifact;
+    otherArtifact->setFilePath(QLatin1String("/some/other/dir/file.h"));
+    QCOMPARE(artifact->dirPath(), QString::fromLatin1("/some/dir"));
+    QCOMPARE(artifact->fileName(), QString::fromLatin1("file.h"));
+    QCOMPARE(artifact->fileNameId(), otherArtifact->fileNameId());
+    QVERIFY(artifact->dirId() != otherArtifact->dirId());
+    QCOMPARE(artifact->filePath(), QString::fromLatin1("/some/dir/file.h"));
+    QCOMPARE(otherArtifact->filePath(), QString::fromLatin1("/some/other/dir/file.h"));
+
+    FileDependency rootFile;
+    rootFile.setFilePath(QLatin1String("/file.h"));
+    QCOMPARE(rootFile.filePath(), QString::fromLatin1("/file.h"));
+    FileDependency relativeFile;
+    relativeFile.setFilePath(QLatin1String("file.h"));
+    QCOMPARE(relativeFile.filePath(), QString::fromLatin1("file.h"));
+    QVERIFY(relativeFile.dirId() != rootFile.dirId());
+
+    buildData.insertIntoLookupTable(artifact);
+    buildData.insertIntoLookupTable(otherArtifact);
+    QCOMPARE(buildData.lookupFiles(QLatin1String("/some/dir/file.h")),
+             QList<FileResourceBase *>() << artifact);
+    QCOMPARE(buildData.lookupFiles(otherArtifact->dirId(), otherArtifact->fileNameId()),
+             QList<FileResourceBase *>() << otherArtifact);
+    QVERIFY(buildData.lookupFiles(QLatin1String("/some/dir/file.cpp")).isEmpty());
+    QVERIFY(buildData.lookupFiles(QLatin1String("/unknown/dir"), QLatin1String("file.h"))
+            .isEmpty());
+
+    buildData.removeFromLookupTable(artifact);
+    QVERIFY(buildData.lookupFiles(artifact).isEmpty());
+    buildData.removeFromLookupTable(otherArtifact);
+    delete artifact;
+    delete otherArtifact;
+}
+
+void TestBuildGraph::testTopologicalOrder()
+{
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->project = project;
+    product->buildData.reset(new ProductBuildData);
+    QList<Artifact *> artifacts;
+    for (int i = 0; i < 5; ++i) {
+        Artifact * const artifact = new Artifact;
+        artifact->product = product;
+        product->buildData->nodes << artifact;
+        artifacts << artifact;
+    }
+    Artifact * const a = artifacts.at(0);
+    Artifact * const b = artifacts.at(1);
+    Artifact * const c = artifacts.at(2);
+    Artifact * const d = artifacts.at(3);
+    Artifact * const e = artifacts.at(4);
+    const Logger logger(m_logSink);
+
+    QVERIFY(safeConnect(a, b, logger));
+    QVERIFY(safeConnect(c, d, logger));
+
+    // This edge contradicts the current order, which must be rearranged.
+    QVERIFY(safeConnect(d, a, logger));
+
+    QVERIFY(!safeConnect(b, c, logger));
+    QVERIFY(safeConnect(b, e, logger));
+    QVERIFY(safeConnect(c, e, logger));
+    QVERIFY(!safeConnect(e, d, logger));
+    QVERIFY(!b->children.contains(c));
+    QVERIFY(!e->children.contains(d));
+
+    const TopologicalOrder &order = project->buildData->topologicalOrder;
+    QVERIFY(order.isValid());
+    foreach (const Artifact * const artifact, artifacts) {
+        foreach (const BuildGraphNode * const child, artifact->children)
+            QVERIFY(artifact->topologicalIndex < child->topologicalIndex);
+    }
+
+    // A cycle created without a check invalidates the order.
+    qbs::Internal::connect(e, c);
+    QVERIFY(!order.isValid());
+    QVERIFY(!safeConnect(b, d, logger));
+    qbs::Internal::disconnect(e, c, logger);
+    QVERIFY(safeConnect(a, e, logger));
+    QVERIFY(order.isValid());
+}
+
+void TestBuildGraph::testArtifactsDependingOn()
+{
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->project = project;
+    product->buildData.reset(new ProductBuildData);
+    ProjectBuildData buildData;
+    QList<Artifact *> artifacts;
+    foreach (const char *filePath, QList<const char *>() << "/p/main.cpp" << "/p/main.o"
+             << "/p/other.cpp" << "/p/other.o" << "/p/app") {
+        Artifact * const artifact = new Artifact;
+        artifact->product = product;
+        artifact->setFilePath(QLatin1String(filePath));
+        product->buildData->nodes << artifact;
+        buildData.insertIntoLookupTable(artifact);
+        artifacts << artifact;
+    }
+    Artifact * const mainCpp = artifacts.at(0);
+    Artifact * const mainObj = artifacts.at(1);
+    Artifact * const otherCpp = artifacts.at(2);
+    Artifact * const otherObj = artifacts.at(3);
+    Artifact * const app = artifacts.at(4);
+    qbs::Internal::connect(mainObj, mainCpp);
+    qbs::Internal::connect(otherObj, otherCpp);
+    qbs::Internal::connect(app, mainObj);
+    FileDependency * const header = new FileDependency;
+    header->setFilePath(QLatin1String("/p/header.h"));
+    buildData.insertFileDependency(header);
+    buildData.addFileDependency(mainObj, header);
+
+    typedef QSet<Artifact *> Artifacts;
+    QCOMPARE(Artifacts(buildData.artifactsDependingOn(QStringList(QLatin1String("/p/header.h")))),
+             Artifacts() << mainObj << app);
+    QCOMPARE(Artifacts(buildData.artifactsDependingOn(QStringList(QLatin1String("/p/other.cpp")))),
+             Artifacts() << otherCpp << otherObj);
+    QCOMPARE(Artifacts(buildData.artifactsDependingOn(QStringList()
+                                                      << QLatin1String("/p/main.cpp")
+                                                      << QLatin1String("/p/other.o"))),
+             Artifacts() << mainCpp << mainObj << app << otherObj);
+    QVERIFY(buildData.artifactsDependingOn(QStringList(QLatin1String("/p/unknown.h"))).isEmpty());
+
+    // The reverse index follows changes of the file dependencies and of the lookup table.
+    buildData.removeFromLookupTable(mainObj);
+    QVERIFY(buildData.artifactsUsingFileDependency(header).isEmpty());
+    buildData.insertIntoLookupTable(mainObj);
+    QCOMPARE(buildData.artifactsUsingFileDependency(header), QList<Artifact *>() << mainObj);
+    buildData.addFileDependency(otherObj, header);
+    QCOMPARE(Artifacts(buildData.artifactsDependingOn(QStringList(QLatin1String("/p/header.h")))),
+             Artifacts() << mainObj << otherObj << app);
+    buildData.clearFileDependencies(mainObj);
+    QVERIFY(mainObj->fileDependencies.isEmpty());
+    QCOMPARE(Artifacts(buildData.artifactsDependingOn(QStringList(QLatin1String("/p/header.h")))),
+             Artifacts() << otherObj);
+
+    // The artifacts are owned by the product's build data, the file dependency by the project's.
+}
+
+void TestBuildGraph::testSpawnedProcess()
+{
+    if (!HostOsInfo::isAnyUnixHost())
+        QSKIP("This test needs a POSIX shell.");
+
+    SpawnedProcess::StatisticsCollector statistics;
+    SpawnedProcess process;
+    process.setStatisticsCollector(&statistics);
+    QSignalSpy finishedSpy(&process, SIGNAL(finished(int)));
+    process.setWorkingDirectory(QLatin1String("/"));
+    process.start(QLatin1String("/bin/sh"), QStringList() << QLatin1String("-c")
+                  << QLatin1String("pwd; echo err >&2; exit 3"));
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(process.state(), QProcess::NotRunning);
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 3);
+    QCOMPARE(process.readAllStandardOutput(), QByteArray("/\n"));
+    QCOMPARE(process.readAllStandardError(), QByteArray("err\n"));
+    QCOMPARE(statistics.statistics().launchCount, 1);
+
+#if defined(Q_OS_UNIX)
+    // Close-on-exec descriptors reach the process only if they are explicitly inherited.
+    int fds[2];
+    QVERIFY(::pipe(fds) == 0);
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    const QStringList readFromPipeArgs = QStringList() << QLatin1String("-c")
+            << QString::fromLatin1(": <&%1").arg(fds[0]);
+    process.start(QLatin1String("/bin/sh"), readFromPipeArgs);
+    QVERIFY(finishedSpy.wait(10000));
+    QVERIFY(process.exitCode() != 0);
+    process.setInheritedFileDescriptors(QList<int>() << fds[0] << fds[1]);
+    process.start(QLatin1String("/bin/sh"), readFromPipeArgs);
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(process.exitCode(), 0);
+    QVERIFY(::fcntl(fds[0], F_GETFD) & FD_CLOEXEC);
+    ::close(fds[0]);
+    ::close(fds[1]);
+    process.setInheritedFileDescriptors(QList<int>());
+#endif
+
+    QSignalSpy errorSpy(&process, SIGNAL(error(QProcess::ProcessError)));
+    process.start(QLatin1String("/nonexistent/program"), QStringList());
+    QVERIFY(errorSpy.wait(10000));
+    QCOMPARE(process.error(), QProcess::FailedToStart);
+}
+
 } // namespace Internal
 } // namespace qbs
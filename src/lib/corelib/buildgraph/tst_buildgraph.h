@@ -51,6 +51,10 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void testCycle();
+    void testLookupTable();
+    void testTopologicalOrder();
+    void testArtifactsDependingOn();
+    void testSpawnedProcess();
 
 private:
     ResolvedProductConstPtr productWithDirectCycle();
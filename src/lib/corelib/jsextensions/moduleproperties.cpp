@@ -35,7 +35,7 @@
 #include <language/scriptengine.h>
 #include <logging/translator.h>
 #include <tools/error.h>
-#include <tools/propertyfinder.h>
+#include <tools/propertypath.h>
 
 #include <QScriptEngine>
 
@@ -130,10 +130,8 @@ QScriptValue ModuleProperties::moduleProperties(QScriptContext *context, QScript
         value = qbsEngine->retrieveFromPropertyCache(moduleName, propertyName, oneValue,
                                                      properties);
     if (!value.isValid()) {
-        if (oneValue)
-            value = PropertyFinder().propertyValue(properties->value(), moduleName, propertyName);
-        else
-            value = PropertyFinder().propertyValues(properties->value(), moduleName, propertyName);
+        value = properties->moduleProperty(PropertyPath::get(moduleName, propertyName,
+                oneValue ? PropertyPath::ScalarValue : PropertyPath::MergedListValue));
         const Property p(moduleName, propertyName, value);
         if (artifact)
             qbsEngine->addPropertyRequestedFromArtifact(artifact, p);
@@ -83,6 +83,7 @@ ItemDeclaration BuiltinDeclarations::declarationsForType(const QString &typeName
 
 void BuiltinDeclarations::setupItemForBuiltinType(Item *item, Logger logger) const
 {
+    item->invalidateNameIndex();
     foreach (const PropertyDeclaration &pd, declarationsForType(item->typeName()).properties()) {
         item->m_propertyDeclarations.insert(pd.name(), pd);
         ValuePtr &value = item->m_properties[pd.name()];
@@ -47,7 +47,7 @@ class EvaluationData
 public:
     Evaluator *evaluator;
     const Item *item;
-    mutable QHash<QScriptString, QScriptValue> valueCache;
+    mutable QHash<int, QScriptValue> valueCache;    // Keyed by interned property name.
 };
 
 } // namespace Internal
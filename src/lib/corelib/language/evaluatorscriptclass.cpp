@@ -39,6 +39,7 @@
 #include "propertydeclaration.h"
 #include <tools/architectures.h>
 #include <tools/hostosinfo.h>
+#include <tools/metricscollector.h>
 #include <tools/qbsassert.h>
 #include <tools/scripttools.h>
 
@@ -291,6 +292,11 @@ EvaluatorScriptClass::EvaluatorScriptClass(ScriptEngine *scriptEngine, const Log
     : QScriptClass(scriptEngine)
     , m_logger(logger)
     , m_valueCacheEnabled(true)
+    , m_evaluationDepth(0)
+    , m_evaluationTime(0)
+    , m_topLevelEvaluationCount(0)
+    , m_evaluationCount(0)
+    , m_parentNameId(Item::propertyNameId(QLatin1String("parent")))
 {
     m_getNativeSettingBuiltin = scriptEngine->newFunction(js_getNativeSetting, 3);
     m_getEnvBuiltin = scriptEngine->newFunction(js_getEnv, 1);
@@ -299,6 +305,16 @@ EvaluatorScriptClass::EvaluatorScriptClass(ScriptEngine *scriptEngine, const Log
     m_getHashBuiltin = scriptEngine->newFunction(js_getHash, 1);
 }
 
+EvaluatorScriptClass::~EvaluatorScriptClass()
+{
+    // Property evaluation is too frequent to report each one to the collector individually.
+    if (const MetricsCollectorPtr collector = m_logger.metricsCollector()) {
+        collector->addPhaseDuration(Metrics::PropertyEvaluation, m_evaluationTime,
+                                    m_topLevelEvaluationCount);
+        collector->addToCounter(Metrics::EvaluatedProperties, m_evaluationCount);
+    }
+}
+
 QScriptClass::QueryFlags EvaluatorScriptClass::queryProperty(const QScriptValue &object,
                                                              const QScriptString &name,
                                                              QScriptClass::QueryFlags flags,
@@ -314,8 +330,8 @@ QScriptClass::QueryFlags EvaluatorScriptClass::queryProperty(const QScriptValue
         m_logger.qbsTrace() << "[SC] queryProperty " << object.objectId() << " " << name;
 
     EvaluationData *const data = attachedPointer<EvaluationData>(object);
-    const QString nameString = name.toString();
-    if (nameString == QLatin1String("parent")) {
+    const int nameId = propertyNameId(name);
+    if (nameId == m_parentNameId) {
         *id = QPTParentProperty;
         m_queryResult.data = data;
         return QScriptClass::HandlesReadAccess;
@@ -328,15 +344,15 @@ QScriptClass::QueryFlags EvaluatorScriptClass::queryProperty(const QScriptValue
         return QScriptClass::QueryFlags();
     }
 
-    return queryItemProperty(data, nameString);
+    return queryItemProperty(data, nameId);
 }
 
 QScriptClass::QueryFlags EvaluatorScriptClass::queryItemProperty(const EvaluationData *data,
-                                                                 const QString &name,
+                                                                 int nameId,
                                                                  bool ignoreParent)
 {
     for (const Item *item = data->item; item; item = item->prototype()) {
-        m_queryResult.value = item->properties().value(name);
+        m_queryResult.value = item->ownProperty(nameId);
         if (!m_queryResult.value.isNull()) {
             m_queryResult.data = data;
             m_queryResult.itemOfProperty = item;
@@ -349,7 +365,7 @@ QScriptClass::QueryFlags EvaluatorScriptClass::queryItemProperty(const Evaluatio
             m_logger.qbsTrace() << "[SC] queryProperty: query parent";
         EvaluationData parentdata = *data;
         parentdata.item = data->item->parent();
-        const QueryFlags qf = queryItemProperty(&parentdata, name, true);
+        const QueryFlags qf = queryItemProperty(&parentdata, nameId, true);
         if (qf.testFlag(HandlesReadAccess)) {
             m_queryResult.data = data;
             return qf;
@@ -361,6 +377,14 @@ QScriptClass::QueryFlags EvaluatorScriptClass::queryItemProperty(const Evaluatio
     return QScriptClass::QueryFlags();
 }
 
+int EvaluatorScriptClass::propertyNameId(const QScriptString &name)
+{
+    QHash<QScriptString, int>::const_iterator it = m_propertyNameIds.constFind(name);
+    if (it == m_propertyNameIds.constEnd())
+        it = m_propertyNameIds.insert(name, Item::propertyNameId(name.toString()));
+    return it.value();
+}
+
 QString EvaluatorScriptClass::resultToString(const QScriptValue &scriptValue)
 {
     return (scriptValue.isObject()
@@ -435,9 +459,10 @@ QScriptValue EvaluatorScriptClass::property(const QScriptValue &object, const QS
     if (debugProperties)
         m_logger.qbsTrace() << "[SC] property " << name;
 
+    const int nameId = propertyNameId(name);
     QScriptValue result;
     if (m_valueCacheEnabled) {
-        result = data->valueCache.value(name);
+        result = data->valueCache.value(nameId);
         if (result.isValid()) {
             if (debugProperties)
                 m_logger.qbsTrace() << "[SC] cache hit " << name << ": " << resultToString(result);
@@ -445,17 +470,24 @@ QScriptValue EvaluatorScriptClass::property(const QScriptValue &object, const QS
         }
     }
 
+    if (m_evaluationDepth++ == 0)
+        m_evaluationTimer.start();
     SVConverter converter(this, &object, value, itemOfProperty, &name, data, &result,
                           &m_sourceValueStack);
     converter.start();
+    if (--m_evaluationDepth == 0) {
+        m_evaluationTime += m_evaluationTimer.nsecsElapsed();
+        ++m_topLevelEvaluationCount;
+    }
+    ++m_evaluationCount;
 
-    const PropertyDeclaration decl = data->item->propertyDeclarations().value(name.toString());
+    const PropertyDeclaration decl = data->item->ownPropertyDeclaration(nameId);
     convertToPropertyType(decl.type(), result);
 
     if (debugProperties)
         m_logger.qbsTrace() << "[SC] cache miss " << name << ": " << resultToString(result);
     if (m_valueCacheEnabled)
-        data->valueCache.insert(name, result);
+        data->valueCache.insert(nameId, result);
     return result;
 }
 
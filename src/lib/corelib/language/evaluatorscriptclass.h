@@ -35,7 +35,10 @@
 #include "builtinvalue.h"
 #include <logging/logger.h>
 
+#include <QElapsedTimer>
+#include <QHash>
 #include <QScriptClass>
+#include <QScriptString>
 #include <QStack>
 
 QT_BEGIN_NAMESPACE
@@ -51,6 +54,7 @@ class EvaluatorScriptClass : public QScriptClass
 {
 public:
     EvaluatorScriptClass(ScriptEngine *scriptEngine, const Logger &logger);
+    ~EvaluatorScriptClass();
 
     QueryFlags queryProperty(const QScriptValue &object,
                              const QScriptString &name,
@@ -69,8 +73,9 @@ public:
 
 private:
     QueryFlags queryItemProperty(const EvaluationData *data,
-                                 const QString &name,
+                                 int nameId,
                                  bool ignoreParent = false);
+    int propertyNameId(const QScriptString &name);
     static QString resultToString(const QScriptValue &scriptValue);
     static Item *findParentOfType(const Item *item, const QString &typeName);
 
@@ -92,6 +97,13 @@ private:
     QueryResult m_queryResult;
     Logger m_logger;
     bool m_valueCacheEnabled;
+    int m_evaluationDepth;
+    QElapsedTimer m_evaluationTimer;
+    qint64 m_evaluationTime;
+    int m_topLevelEvaluationCount;
+    qint64 m_evaluationCount;
+    const int m_parentNameId;
+    QHash<QScriptString, int> m_propertyNameIds;
     QScriptValue m_getNativeSettingBuiltin;
     QScriptValue m_getEnvBuiltin;
     QScriptValue m_canonicalArchitectureBuiltin;
@@ -34,6 +34,7 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/qbsassert.h>
+#include <tools/stringtable.h>
 
 namespace qbs {
 namespace Internal {
@@ -46,6 +47,7 @@ Item::Item(ItemPool *pool)
     , m_scope(0)
     , m_outerItem(0)
     , m_parent(0)
+    , m_nameIndexValid(false)
 {
 }
 
@@ -149,6 +151,53 @@ const PropertyDeclaration Item::propertyDeclaration(const QString &name) const
     return (!decl.isValid() && m_prototype) ? m_prototype->propertyDeclaration(name) : decl;
 }
 
+static StringTable &propertyNames()
+{
+    static StringTable table;
+    return table;
+}
+
+/*!
+ * Returns the process-wide id of the property name \a name, interning it if necessary.
+ * The evaluator uses these ids to look up properties without comparing strings.
+ */
+int Item::propertyNameId(const QString &name)
+{
+    return propertyNames().id(name);
+}
+
+ValuePtr Item::ownProperty(int nameId) const
+{
+    const NameIndexEntry * const entry = nameIndexEntry(nameId);
+    return entry ? entry->value : ValuePtr();
+}
+
+PropertyDeclaration Item::ownPropertyDeclaration(int nameId) const
+{
+    const NameIndexEntry * const entry = nameIndexEntry(nameId);
+    return entry ? entry->declaration : PropertyDeclaration();
+}
+
+// The index is built on first use and kept up to date by the setters afterwards.
+// Code writing to the maps directly must call invalidateNameIndex().
+const Item::NameIndexEntry *Item::nameIndexEntry(int nameId) const
+{
+    if (!m_nameIndexValid) {
+        m_nameIndex.reserve(qMax(m_properties.count(), m_propertyDeclarations.count()));
+        for (PropertyMap::const_iterator it = m_properties.constBegin();
+             it != m_properties.constEnd(); ++it) {
+            m_nameIndex[propertyNameId(it.key())].value = it.value();
+        }
+        for (PropertyDeclarationMap::const_iterator it = m_propertyDeclarations.constBegin();
+             it != m_propertyDeclarations.constEnd(); ++it) {
+            m_nameIndex[propertyNameId(it.key())].declaration = it.value();
+        }
+        m_nameIndexValid = true;
+    }
+    const QHash<int, NameIndexEntry>::const_iterator it = m_nameIndex.constFind(nameId);
+    return it == m_nameIndex.constEnd() ? 0 : &it.value();
+}
+
 void Item::setPropertyObserver(ItemObserver *observer) const
 {
     QBS_ASSERT(!observer || !m_propertyObserver, return);   // warn if accidentally overwritten
@@ -211,6 +260,8 @@ void Item::dump(int indentation) const
 void Item::removeProperty(const QString &name)
 {
     m_properties.remove(name);
+    if (m_nameIndexValid)
+        m_nameIndex[propertyNameId(name)].value.clear();
 }
 
 Item *Item::child(const QString &type, bool checkForMultiple) const
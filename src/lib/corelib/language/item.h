@@ -40,6 +40,7 @@
 #include <tools/codelocation.h>
 #include <tools/weakpointer.h>
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QSharedPointer>
@@ -103,6 +104,12 @@ public:
     JSSourceValuePtr sourceProperty(const QString &name) const;
     VariantValuePtr variantProperty(const QString &name) const;
     void setPropertyObserver(ItemObserver *observer) const;
+
+    // Lookups of the item's own properties and declarations by interned name.
+    static int propertyNameId(const QString &name);
+    ValuePtr ownProperty(int nameId) const;
+    PropertyDeclaration ownPropertyDeclaration(int nameId) const;
+
     void setProperty(const QString &name, const ValuePtr &value);
     void removeProperty(const QString &name);
     void setPropertyDeclaration(const QString &name, const PropertyDeclaration &declaration);
@@ -119,7 +126,15 @@ public:
     void dump() const;
 
 private:
+    struct NameIndexEntry
+    {
+        ValuePtr value;
+        PropertyDeclaration declaration;
+    };
+
     void dump(int indentation) const;
+    const NameIndexEntry *nameIndexEntry(int nameId) const;
+    void invalidateNameIndex();
 
     ItemPool *m_pool;
     mutable ItemObserver *m_propertyObserver;
@@ -137,6 +152,8 @@ private:
     PropertyDeclarationMap m_propertyDeclarations;
     QList<FunctionDeclaration> m_functions;
     Modules m_modules;
+    mutable QHash<int, NameIndexEntry> m_nameIndex;
+    mutable bool m_nameIndexValid;
 };
 
 inline ItemPool *Item::pool() const
@@ -207,6 +224,8 @@ inline const Item::PropertyDeclarationMap &Item::propertyDeclarations() const
 inline void Item::setProperty(const QString &name, const ValuePtr &value)
 {
     m_properties.insert(name, value);
+    if (m_nameIndexValid)
+        m_nameIndex[propertyNameId(name)].value = value;
     if (m_propertyObserver)
         m_propertyObserver->onItemPropertyChanged(this);
 }
@@ -215,6 +234,14 @@ inline void Item::setPropertyDeclaration(const QString &name,
                                          const PropertyDeclaration &declaration)
 {
     m_propertyDeclarations.insert(name, declaration);
+    if (m_nameIndexValid)
+        m_nameIndex[propertyNameId(name)].declaration = declaration;
+}
+
+inline void Item::invalidateNameIndex()
+{
+    m_nameIndexValid = false;
+    m_nameIndex.clear();
 }
 
 inline void Item::setTypeName(const QString &name)
@@ -36,6 +36,7 @@
 #include <parser/qmljslexer_p.h>
 #include <parser/qmljsparser_p.h>
 #include <tools/error.h>
+#include <tools/metricscollector.h>
 #include <QExplicitlySharedDataPointer>
 #include <QFile>
 #include <QFileInfo>
@@ -160,11 +161,14 @@ ItemReaderResult ItemReader::internalReadFile(const QString &filePath)
         if (Q_UNLIKELY(cacheValue.isProcessing()))
             throw ErrorInfo(Tr::tr("Loop detected when importing '%1'.").arg(filePath));
     } else {
+        PhaseTimer phaseTimer(m_logger, Metrics::Parsing);
         QFile file(filePath);
         if (Q_UNLIKELY(!file.open(QFile::ReadOnly)))
             throw ErrorInfo(Tr::tr("Cannot open '%1'.").arg(filePath));
 
         m_filesRead.insert(filePath);
+        if (const MetricsCollectorPtr collector = m_logger.metricsCollector())
+            collector->addToCounter(Metrics::ParsedFiles);
         const QString code = QTextStream(&file).readAll();
         QbsQmlJS::Lexer lexer(cacheValue.engine());
         lexer.setCode(code, 1);
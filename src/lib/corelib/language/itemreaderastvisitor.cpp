@@ -370,6 +370,7 @@ bool ItemReaderASTVisitor::visit(AST::UiPublicMember *ast)
     }
 
     m_item->m_properties.insert(p.name(), value);
+    m_item->invalidateNameIndex();
     return false;
 }
 
@@ -392,6 +393,7 @@ bool ItemReaderASTVisitor::visit(AST::UiScriptBinding *ast)
         m_item->m_id = idExp->name.toString();
         ensureIdScope(m_file);
         m_file->m_idScope->m_properties[m_item->m_id] = ItemValue::create(m_item);
+        m_file->m_idScope->invalidateNameIndex();
         return false;
     }
 
@@ -404,6 +406,7 @@ bool ItemReaderASTVisitor::visit(AST::UiScriptBinding *ast)
     Item *targetItem = targetItemForBinding(m_item, bindingName, value);
     checkDuplicateBinding(targetItem, bindingName, ast->qualifiedId->identifierToken);
     targetItem->m_properties.insert(bindingName.last(), value);
+    targetItem->invalidateNameIndex();
     return false;
 }
 
@@ -482,6 +485,7 @@ Item *ItemReaderASTVisitor::targetItemForBinding(Item *item,
             Item *newItem = Item::create(m_reader->m_pool);
             v = ItemValue::create(newItem);
             targetItem->m_properties.insert(bindingName.at(i), v);
+            targetItem->invalidateNameIndex();
         }
         if (Q_UNLIKELY(v->type() != Value::ItemValueType)) {
             QString msg = Tr::tr("Binding to non-item property.");
@@ -554,6 +558,7 @@ void ItemReaderASTVisitor::inheritItem(Item *dst, const Item *src)
             it != src->m_propertyDeclarations.constEnd(); ++it) {
         dst->m_propertyDeclarations[it.key()] = it.value();
     }
+    dst->invalidateNameIndex();
 }
 
 void ItemReaderASTVisitor::ensureIdScope(const FileContextPtr &file)
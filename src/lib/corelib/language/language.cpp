@@ -41,6 +41,7 @@
 #include <jsextensions/jsextensions.h>
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
+#include <tools/directorysnapshot.h>
 #include <tools/hostosinfo.h>
 #include <tools/error.h>
 #include <tools/propertyfinder.h>
@@ -49,7 +50,7 @@
 
 #include <QCryptographicHash>
 #include <QDir>
-#include <QDirIterator>
+#include <QFileInfo>
 #include <QMap>
 #include <QMutexLocker>
 #include <QScriptValue>
@@ -132,6 +133,16 @@ void SourceWildCards::load(PersistentPool &pool)
     patterns = pool.idLoadStringList();
     excludePatterns = pool.idLoadStringList();
     pool.loadContainerS(files);
+    int count;
+    pool.stream() >> count;
+    dirTimeStamps.clear();
+    dirTimeStamps.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString dirPath = pool.idLoadString();
+        FileTime dirTime;
+        pool.stream() >> dirTime;
+        dirTimeStamps.insert(dirPath, dirTime);
+    }
 }
 
 void SourceWildCards::store(PersistentPool &pool) const
@@ -140,6 +151,12 @@ void SourceWildCards::store(PersistentPool &pool) const
     pool.storeStringList(patterns);
     pool.storeStringList(excludePatterns);
     pool.storeContainer(files);
+    pool.stream() << dirTimeStamps.count();
+    for (DirectoryTimeStamps::const_iterator it = dirTimeStamps.constBegin();
+         it != dirTimeStamps.constEnd(); ++it) {
+        pool.storeString(it.key());
+        pool.stream() << it.value();
+    }
 }
 
 /*!
@@ -833,6 +850,34 @@ QString ResolvedProduct::cachedExecutablePath(const QString &origFilePath) const
     return m_executablePathCache.value(origFilePath);
 }
 
+void ResolvedProduct::cacheCommandEnvironment(const QString &key,
+                                              const QProcessEnvironment &environment)
+{
+    QMutexLocker locker(&m_executablePathCacheLock);
+    m_commandEnvironmentCache.insert(key, environment);
+}
+
+/*!
+ * Returns the environment that has been cached for commands with the given additional variables,
+ * or an empty environment, if there is none.
+ */
+QProcessEnvironment ResolvedProduct::cachedCommandEnvironment(const QString &key) const
+{
+    QMutexLocker locker(&m_executablePathCacheLock);
+    return m_commandEnvironmentCache.value(key);
+}
+
+/*!
+ * The executable paths and command environments are only valid for one build, as
+ * the file system might change in between.
+ */
+void ResolvedProduct::clearCommandCaches()
+{
+    QMutexLocker locker(&m_executablePathCacheLock);
+    m_executablePathCache.clear();
+    m_commandEnvironmentCache.clear();
+}
+
 
 ResolvedProject::ResolvedProject() : enabled(true), m_topLevelProject(0)
 {
@@ -1055,55 +1100,74 @@ void TopLevelProject::store(PersistentPool &pool) const
  * \brief The \c SourceArtifacts resulting from the expanded list of matching files.
  */
 
-QSet<QString> SourceWildCards::expandPatterns(const GroupConstPtr &group,
-                                              const QString &baseDir) const
-{
-    QSet<QString> files = expandPatterns(group, patterns, baseDir);
-    files -= expandPatterns(group, excludePatterns, baseDir);
-    return files;
-}
+/*!
+ * \variable SourceWildCards::dirTimeStamps
+ * \brief The modification times of all directories that were looked at when the patterns
+ *        were expanded. Empty if the expansion result cannot be trusted to be up to date
+ *        even if none of these directories changes.
+ */
+
+namespace {
 
-QSet<QString> SourceWildCards::expandPatterns(const GroupConstPtr &group,
-        const QStringList &patterns, const QString &baseDir) const
+// Matches the path patterns of a group against the directory listings of a snapshot,
+// remembering the time stamps of all directories it looks at.
+class WildcardExpander
 {
-    QSet<QString> files;
-    QString expandedPrefix = prefix;
-    if (expandedPrefix.startsWith(QLatin1String("~/")))
-        expandedPrefix.replace(0, 1, QDir::homePath());
-    foreach (QString pattern, patterns) {
-        pattern.prepend(expandedPrefix);
-        pattern.replace(QLatin1Char('\\'), QLatin1Char('/'));
-        QStringList parts = pattern.split(QLatin1Char('/'), QString::SkipEmptyParts);
-        if (FileInfo::isAbsolute(pattern)) {
-            QString rootDir;
-            if (HostOsInfo::isWindowsHost()) {
-                rootDir = parts.takeFirst();
-                if (!rootDir.endsWith(QLatin1Char('/')))
-                    rootDir.append(QLatin1Char('/'));
-            } else {
-                rootDir = QLatin1Char('/');
-            }
-            expandPatterns(files, group, parts, rootDir);
-        } else {
-            expandPatterns(files, group, parts, baseDir);
-        }
+public:
+    WildcardExpander(DirectorySnapshot *snapshot)
+        : m_snapshot(snapshot), m_isReliable(true)
+    {
     }
 
-    return files;
+    void expand(QSet<QString> &result, const QStringList &parts, const QString &baseDir);
+
+    bool isReliable() const { return m_isReliable; }
+    const SourceWildCards::DirectoryTimeStamps &dirTimeStamps() const { return m_dirTimeStamps; }
+
+private:
+    DirectorySnapshot::Listing listing(const QString &dirPath);
+    bool isQbsBuildDir(const QString &dirPath);
+    void collectSubDirectories(const QString &dirPath, bool includeHidden, QStringList &dirPaths);
+
+    DirectorySnapshot * const m_snapshot;
+    SourceWildCards::DirectoryTimeStamps m_dirTimeStamps;
+    bool m_isReliable;
+};
+
+DirectorySnapshot::Listing WildcardExpander::listing(const QString &dirPath)
+{
+    const DirectorySnapshot::Listing listing = m_snapshot->listing(dirPath);
+    m_dirTimeStamps.insert(QDir::cleanPath(dirPath), listing.dirTime);
+    if (!listing.isReliable)
+        m_isReliable = false;
+    return listing;
 }
 
-static bool isQbsBuildDir(const QDir &dir)
+// People might build directly in the project source directory. This is okay, since
+// we keep the build data in a "container" directory. However, we must make sure we don't
+// match any generated files therein as source files.
+bool WildcardExpander::isQbsBuildDir(const QString &dirPath)
 {
-    return dir.exists(dir.dirName() + QLatin1String(".bg"));
+    return listing(dirPath).containsEntry(QFileInfo(QDir::cleanPath(dirPath)).fileName()
+                                          + QLatin1String(".bg"));
 }
 
-void SourceWildCards::expandPatterns(QSet<QString> &result, const GroupConstPtr &group,
-                                     const QStringList &parts,
-                                     const QString &baseDir) const
+// Symbolic links to directories are not followed, as QDirIterator would not follow them.
+void WildcardExpander::collectSubDirectories(const QString &dirPath, bool includeHidden,
+                                             QStringList &dirPaths)
+{
+    foreach (const DirectorySnapshot::Entry &entry, listing(dirPath).entries) {
+        if (!entry.isDir || entry.isSymLink || (entry.isHidden && !includeHidden))
+            continue;
+        const QString subDirPath = dirPath + QLatin1Char('/') + entry.name;
+        dirPaths << subDirPath;
+        collectSubDirectories(subDirPath, includeHidden, dirPaths);
+    }
+}
+
+void WildcardExpander::expand(QSet<QString> &result, const QStringList &parts,
+                              const QString &baseDir)
 {
-    // People might build directly in the project source directory. This is okay, since
-    // we keep the build data in a "container" directory. However, we must make sure we don't
-    // match any generated files therein as source files.
     if (isQbsBuildDir(baseDir))
         return;
 
@@ -1123,31 +1187,115 @@ void SourceWildCards::expandPatterns(QSet<QString> &result, const GroupConstPtr
     }
 
     const bool isDir = !changed_parts.isEmpty();
-
     const QString &filePattern = part;
-    const QDirIterator::IteratorFlags itFlags = recursive
-            ? QDirIterator::Subdirectories
-            : QDirIterator::NoIteratorFlags;
-    QDir::Filters itFilters = isDir
-            ? QDir::Dirs
-            : QDir::Files;
-
-    if (isDir && !FileInfo::isPattern(filePattern))
-        itFilters |= QDir::Hidden;
-    if (filePattern != QLatin1String("..") && filePattern != QLatin1String("."))
-        itFilters |= QDir::NoDotAndDotDot;
-
-    QDirIterator it(baseDir, QStringList(filePattern), itFilters, itFlags);
-    while (it.hasNext()) {
-        const QString filePath = it.next();
-        if (isQbsBuildDir(it.fileInfo().dir()))
+    const bool isPattern = FileInfo::isPattern(filePattern);
+    const bool includeHidden = isDir && !isPattern;
+
+    QStringList dirPaths(baseDir);
+    if (recursive)
+        collectSubDirectories(baseDir, includeHidden, dirPaths);
+
+    if (filePattern == QLatin1String(".") || filePattern == QLatin1String("..")) {
+        if (!isDir)
+            return;
+        foreach (const QString &dirPath, dirPaths) {
+            if (!isQbsBuildDir(dirPath))
+                expand(result, changed_parts, dirPath + QLatin1Char('/') + filePattern);
+        }
+        return;
+    }
+
+    // QDirIterator's name filters, which were used here before, are case-insensitive on all hosts.
+    const Qt::CaseSensitivity cs = Qt::CaseInsensitive;
+    const QRegExp regExp(filePattern, cs, QRegExp::Wildcard);
+    foreach (const QString &dirPath, dirPaths) {
+        if (isQbsBuildDir(dirPath))
             continue; // See above.
-        QBS_ASSERT(FileInfo(filePath).isDir() == isDir, break);
-        if (isDir)
-            expandPatterns(result, group, changed_parts, filePath);
+        foreach (const DirectorySnapshot::Entry &entry, listing(dirPath).entries) {
+            if (isDir ? !entry.isDir : !entry.isFile)
+                continue;
+            if (entry.isHidden && !includeHidden)
+                continue;
+            if (isPattern ? !regExp.exactMatch(entry.name)
+                          : entry.name.compare(filePattern, cs) != 0) {
+                continue;
+            }
+            const QString filePath = dirPath + QLatin1Char('/') + entry.name;
+            if (isDir)
+                expand(result, changed_parts, filePath);
+            else
+                result += QDir::cleanPath(filePath);
+        }
+    }
+}
+
+} // anonymous namespace
+
+static QSet<QString> expandPatternList(WildcardExpander &expander, const QString &prefix,
+                                       const QStringList &patterns, const QString &baseDir)
+{
+    QSet<QString> files;
+    QString expandedPrefix = prefix;
+    if (expandedPrefix.startsWith(QLatin1String("~/")))
+        expandedPrefix.replace(0, 1, QDir::homePath());
+    foreach (QString pattern, patterns) {
+        pattern.prepend(expandedPrefix);
+        pattern.replace(QLatin1Char('\\'), QLatin1Char('/'));
+        QStringList parts = pattern.split(QLatin1Char('/'), QString::SkipEmptyParts);
+        if (FileInfo::isAbsolute(pattern)) {
+            QString rootDir;
+            if (HostOsInfo::isWindowsHost()) {
+                rootDir = parts.takeFirst();
+                if (!rootDir.endsWith(QLatin1Char('/')))
+                    rootDir.append(QLatin1Char('/'));
+            } else {
+                rootDir = QLatin1Char('/');
+            }
+            expander.expand(files, parts, rootDir);
+        } else {
+            expander.expand(files, parts, baseDir);
+        }
+    }
+
+    return files;
+}
+
+/*!
+ * \brief Returns the files matched by the patterns and not matched by the exclude patterns.
+ * Directories are listed via \a snapshot, so that expanding the patterns of several groups
+ * walks every directory only once. If \a dirTimeStamps is given, it receives the data
+ * needed by \c directoriesChanged().
+ */
+QSet<QString> SourceWildCards::expandPatterns(const QString &baseDir, DirectorySnapshot *snapshot,
+                                              DirectoryTimeStamps *dirTimeStamps) const
+{
+    DirectorySnapshot localSnapshot;
+    WildcardExpander expander(snapshot ? snapshot : &localSnapshot);
+    QSet<QString> files = expandPatternList(expander, prefix, patterns, baseDir);
+    files -= expandPatternList(expander, prefix, excludePatterns, baseDir);
+    if (dirTimeStamps) {
+        if (expander.isReliable())
+            *dirTimeStamps = expander.dirTimeStamps();
         else
-            result += QDir::cleanPath(filePath);
+            dirTimeStamps->clear();
     }
+    return files;
+}
+
+/*!
+ * \brief Returns false if the expansion of the patterns is known to yield the same
+ *        files as last time, because none of the directories involved has changed.
+ */
+bool SourceWildCards::directoriesChanged() const
+{
+    if (dirTimeStamps.isEmpty())
+        return true;
+    for (DirectoryTimeStamps::const_iterator it = dirTimeStamps.constBegin();
+         it != dirTimeStamps.constEnd(); ++it) {
+        if (DirectorySnapshot::currentDirectoryTime(it.key()) != it.value())
+            return true;
+    }
+    return false;
 }
 
 void ResolvedTransformer::load(PersistentPool &pool)
@@ -1208,7 +1356,7 @@ bool operator==(const SourceArtifactInternal &sa1, const SourceArtifactInternal
     return sa1.absoluteFilePath == sa2.absoluteFilePath
             && sa1.fileTags == sa2.fileTags
             && sa1.overrideFileTags == sa2.overrideFileTags
-            && sa1.properties->value() == sa2.properties->value();
+            && sa1.properties->equals(*sa2.properties);
 }
 
 bool sourceArtifactSetsAreEqual(const QList<SourceArtifactPtr> &l1,
@@ -66,6 +66,7 @@ namespace Internal {
 class BuildGraphLocker;
 class BuildGraphLoader;
 class BuildGraphVisitor;
+class DirectorySnapshot;
 
 class FileTagger : public PersistentObject
 {
@@ -156,10 +157,13 @@ class SourceWildCards : public PersistentObject
 public:
     typedef QSharedPointer<SourceWildCards> Ptr;
     typedef QSharedPointer<const SourceWildCards> ConstPtr;
+    typedef QHash<QString, FileTime> DirectoryTimeStamps;
 
     static Ptr create() { return Ptr(new SourceWildCards); }
 
-    QSet<QString> expandPatterns(const GroupConstPtr &group, const QString &baseDir) const;
+    QSet<QString> expandPatterns(const QString &baseDir, DirectorySnapshot *snapshot = 0,
+                                 DirectoryTimeStamps *dirTimeStamps = 0) const;
+    bool directoriesChanged() const;
 
     // TODO: Use back pointer to Group instead?
     QString prefix;
@@ -167,15 +171,11 @@ public:
     QStringList patterns;
     QStringList excludePatterns;
     QList<SourceArtifactPtr> files;
+    DirectoryTimeStamps dirTimeStamps;
 
 private:
     SourceWildCards() {}
 
-    QSet<QString> expandPatterns(const GroupConstPtr &group, const QStringList &patterns,
-                                 const QString &baseDir) const;
-    void expandPatterns(QSet<QString> &result, const GroupConstPtr &group,
-                        const QStringList &parts, const QString &baseDir) const;
-
     void load(PersistentPool &pool);
     void store(PersistentPool &pool) const;
 };
@@ -278,16 +278,13 @@ public:
     bool multiplex;
     QList<RuleArtifactPtr> artifacts;           // unused, if outputFileTags/outputArtifactsScript is non-empty
 
-    // members that we don't need to save
-    int ruleGraphId;
-
     QString toString() const;
     bool acceptsAsInput(Artifact *artifact) const;
     FileTags staticOutputFileTags() const;
     FileTags collectedOutputFileTags() const;
     bool isDynamic() const;
 private:
-    Rule() : multiplex(false), ruleGraphId(-1) {}
+    Rule() : multiplex(false) {}
 
     void load(PersistentPool &pool);
     void store(PersistentPool &pool) const;
@@ -407,6 +404,9 @@ public:
 
     void cacheExecutablePath(const QString &origFilePath, const QString &fullFilePath);
     QString cachedExecutablePath(const QString &origFilePath) const;
+    void cacheCommandEnvironment(const QString &key, const QProcessEnvironment &environment);
+    QProcessEnvironment cachedCommandEnvironment(const QString &key) const;
+    void clearCommandCaches();
 
 private:
     ResolvedProduct();
@@ -415,6 +415,7 @@ private:
     void store(PersistentPool &pool) const;
 
     QHash<QString, QString> m_executablePathCache;
+    QHash<QString, QProcessEnvironment> m_commandEnvironmentCache;
     mutable QMutex m_executablePathCacheLock;
 };
 
@@ -465,6 +466,7 @@ public:
     QHash<QString, QString> usedEnvironment; // Environment variables requested by the project while resolving.
     QHash<QString, bool> fileExistsResults; // Results of calls to "File.exists()".
     QHash<QString, FileTime> fileLastModifiedResults; // Results of calls to "File.lastModified()".
+    PropertyMapPool propertyMapPool; // Not saved
     QScopedPointer<ProjectBuildData> buildData;
     BuildGraphLocker *bgLocker; // This holds the system-wide build graph file lock.
     bool locked; // This is the API-level lock for the project instance.
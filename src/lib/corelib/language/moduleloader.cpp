@@ -45,6 +45,7 @@
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
+#include <tools/metricscollector.h>
 #include <tools/profile.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
@@ -938,6 +939,7 @@ Item *ModuleLoader::loadModuleFile(ProductContext *productContext, const QString
         return cacheValue.enabled ? cacheValue.module : 0;
     }
     *cacheHit = false;
+    PhaseTimer phaseTimer(m_logger, Metrics::ModuleLoading);
     Item * const module = m_reader->readFile(filePath);
     if (!isBaseModule) {
         DependsContext dependsContext;
@@ -1251,6 +1253,9 @@ void ModuleLoader::resolveProbe(Item *parent, Item *probe)
     const JSSourceValueConstPtr configureScript = probe->sourceProperty(QLatin1String("configure"));
     if (Q_UNLIKELY(!configureScript))
         throw ErrorInfo(Tr::tr("Probe.configure must be set."), probe->location());
+    PhaseTimer phaseTimer(m_logger, Metrics::ProbeExecution);
+    if (const MetricsCollectorPtr collector = m_logger.metricsCollector())
+        collector->addToCounter(Metrics::ExecutedProbes);
     typedef QPair<QString, QScriptValue> ProbeProperty;
     QList<ProbeProperty> probeBindings;
     for (Item *obj = probe; obj; obj = obj->prototype()) {
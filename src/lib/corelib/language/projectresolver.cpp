@@ -41,6 +41,7 @@
 #include "scriptengine.h"
 #include <jsextensions/moduleproperties.h>
 #include <logging/translator.h>
+#include <tools/directorysnapshot.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/progressobserver.h>
@@ -75,6 +76,7 @@ ProjectResolver::ProjectResolver(ModuleLoader *ldr, const BuiltinDeclarations *b
     , m_engine(m_evaluator->engine())
     , m_progressObserver(0)
     , m_disableCachedEvaluation(false)
+    , m_directorySnapshot(0)
 {
 }
 
@@ -115,11 +117,16 @@ TopLevelProjectPtr ProjectResolver::resolve(ModuleLoaderResult &loadResult,
 
     ProjectContext projectContext;
     projectContext.loadResult = &loadResult;
+    DirectorySnapshot directorySnapshot;
+    m_directorySnapshot = &directorySnapshot;
     m_setupParams = setupParameters;
     m_productContext = 0;
     m_moduleContext = 0;
     m_exportsContext = 0;
+    m_rulesByLocation.clear();
+    m_fileTaggers.clear();
     resolveTopLevelProject(loadResult.root, &projectContext);
+    m_directorySnapshot = 0;
     TopLevelProjectPtr top = projectContext.project.staticCast<TopLevelProject>();
     checkForDuplicateProductNames(top);
     top->buildSystemFiles.unite(loadResult.qbsFiles);
@@ -188,6 +195,24 @@ static void makeSubProjectNamesUniqe(const ResolvedProjectPtr &parentProject)
     }
 }
 
+// Must be done after all products are resolved, because exported properties get inserted
+// into existing maps in resolveProductDependencies().
+static void internPropertyMaps(const TopLevelProjectPtr &project)
+{
+    PropertyMapPool &pool = project->propertyMapPool;
+    foreach (const ResolvedProductPtr &product, project->allProducts()) {
+        product->moduleProperties = pool.intern(product->moduleProperties);
+        foreach (const GroupPtr &group, product->groups) {
+            group->properties = pool.intern(group->properties);
+            foreach (const SourceArtifactPtr &artifact, group->allFiles())
+                artifact->properties = pool.intern(artifact->properties);
+        }
+        foreach (const ArtifactPropertiesPtr &artifactProperties, product->artifactProperties)
+            artifactProperties->setPropertyMapInternal(
+                        pool.intern(artifactProperties->propertyMap()));
+    }
+}
+
 void ProjectResolver::resolveTopLevelProject(Item *item, ProjectContext *projectContext)
 {
     if (m_progressObserver)
@@ -215,11 +240,15 @@ void ProjectResolver::resolveTopLevelProject(Item *item, ProjectContext *project
         matchArtifactProperties(product, product->allEnabledFiles());
 
         // Let a positive value of qbs.install imply the file tag "installable".
+        static const PropertyPath installPath = PropertyPath::get(QLatin1String("qbs"),
+                                                                  QLatin1String("install"));
         foreach (const SourceArtifactPtr &artifact, product->allFiles()) {
-            if (artifact->properties->qbsPropertyValue(QLatin1String("install")).toBool())
+            if (artifact->properties->moduleProperty(installPath).toBool())
                 artifact->fileTags += "installable";
         }
     }
+
+    internPropertyMaps(project);
 }
 
 void ProjectResolver::resolveProject(Item *item, ProjectContext *projectContext)
@@ -564,7 +593,9 @@ void ProjectResolver::resolveGroup(Item *item, ProjectContext *projectContext)
                                                                   QLatin1String("excludeFiles"));
         wildcards->prefix = group->prefix;
         wildcards->patterns = patterns;
-        QSet<QString> files = wildcards->expandPatterns(group, m_productContext->product->sourceDirectory);
+        QSet<QString> files = wildcards->expandPatterns(
+                    m_productContext->product->sourceDirectory, m_directorySnapshot,
+                    &wildcards->dirTimeStamps);
         foreach (const QString &fileName, files)
             createSourceArtifact(m_productContext->product, moduleProperties, fileName,
                                  group->fileTags, group->overrideTags, wildcards->files);
@@ -692,6 +723,7 @@ void ProjectResolver::resolveRule(Item *item, ProjectContext *projectContext)
     rule->explicitlyDependsOn
             = m_evaluator->fileTagsValue(item, QLatin1String("explicitlyDependsOn"));
     rule->module = m_moduleContext ? m_moduleContext->module : projectContext->dummyModule;
+    rule = sharedRule(rule);
     if (m_exportsContext)
         m_exportsContext->rules += rule;
     else if (m_productContext)
@@ -700,6 +732,22 @@ void ProjectResolver::resolveRule(Item *item, ProjectContext *projectContext)
         projectContext->rules += rule;
 }
 
+// Products that instantiate a module with the same rule-relevant property values end up with
+// equal rules. These are represented by one object, which saves memory and build graph size and
+// lets the build data resolver share the rule graphs of such products.
+RulePtr ProjectResolver::sharedRule(const RulePtr &rule)
+{
+    QList<RulePtr> &candidates = m_rulesByLocation[rule->prepareScript->location.toString()];
+    foreach (const RulePtr &candidate, candidates) {
+        if (*candidate == *rule && candidate->name == rule->name
+                && *candidate->module == *rule->module) {
+            return candidate;
+        }
+    }
+    candidates << rule;
+    return rule;
+}
+
 class StringListLess
 {
 public:
@@ -795,7 +843,14 @@ void ProjectResolver::resolveFileTagger(Item *item, ProjectContext *projectConte
         if (pattern.isEmpty())
             throw ErrorInfo(Tr::tr("A FileTagger pattern must not be empty."), item->location());
     }
-    fileTaggers += FileTagger::create(patterns, fileTags);
+    QStringList sortedFileTags = fileTags.toStringList();
+    sortedFileTags.sort();
+    const QString key = patterns.join(QLatin1String("\n")) + QLatin1Char('|')
+            + sortedFileTags.join(QLatin1String(","));
+    FileTaggerConstPtr &fileTagger = m_fileTaggers[key];
+    if (!fileTagger)
+        fileTagger = FileTagger::create(patterns, fileTags);
+    fileTaggers += fileTagger;
 }
 
 void ProjectResolver::resolveTransformer(Item *item, ProjectContext *projectContext)
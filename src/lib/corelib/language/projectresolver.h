@@ -46,6 +46,7 @@ namespace qbs {
 namespace Internal {
 
 class BuiltinDeclarations;
+class DirectorySnapshot;
 class Evaluator;
 class Item;
 class ModuleLoader;
@@ -121,6 +122,7 @@ private:
     void resolveGroup(Item *item, ProjectContext *projectContext);
     void resolveRule(Item *item, ProjectContext *projectContext);
     void resolveRuleArtifact(const RulePtr &rule, Item *item);
+    RulePtr sharedRule(const RulePtr &rule);
     static void resolveRuleArtifactBinding(const RuleArtifactPtr &ruleArtifact, Item *item,
                                            const QStringList &namePrefix,
                                            StringListSet *seenBindings);
@@ -169,10 +171,13 @@ private:
     ModuleContext *m_moduleContext;
     ExportsContext *m_exportsContext;
     bool m_disableCachedEvaluation;
+    DirectorySnapshot *m_directorySnapshot;
     QMap<QString, ResolvedProductPtr> m_productsByName;
     QHash<QString, QList<ResolvedProductPtr> > m_productsByType;
     QHash<ResolvedProductPtr, Item *> m_productItemMap;
     mutable QHash<FileContextConstPtr, ResolvedFileContextPtr> m_fileContextMap;
+    QHash<QString, QList<RulePtr> > m_rulesByLocation;
+    QHash<QString, FileTaggerConstPtr> m_fileTaggers;
     QMap<QString, ExportsContext> m_exports;
     SetupProjectParameters m_setupParams;
 
@@ -32,11 +32,50 @@
 
 #include <tools/persistence.h>
 #include <tools/propertyfinder.h>
+#include <tools/qbsassert.h>
 #include <tools/scripttools.h>
 
+#include <QSet>
+
 namespace qbs {
 namespace Internal {
 
+static uint combineHash(uint seed, uint value)
+{
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+// Values that compare equal via QVariant::operator==() must get the same hash, which is why
+// scalars are hashed via their string representation and lists regardless of their exact type.
+static uint variantHash(const QVariant &v)
+{
+    uint h = 0;
+    switch (v.type()) {
+    case QVariant::Invalid:
+        break;
+    case QVariant::Map: {
+        const QVariantMap map = v.toMap();
+        for (QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it) {
+            h = combineHash(h, qHash(it.key()));
+            h = combineHash(h, variantHash(it.value()));
+        }
+        break;
+    }
+    case QVariant::List:
+        foreach (const QVariant &elem, v.toList())
+            h = combineHash(h, variantHash(elem));
+        break;
+    case QVariant::StringList:
+        foreach (const QString &elem, v.toStringList())
+            h = combineHash(h, qHash(elem));
+        break;
+    default:
+        h = qHash(v.toString());
+        break;
+    }
+    return h;
+}
+
 /*!
  * \class PropertyMapInternal
  * \brief The \c PropertyMapInternal class contains a set of properties and their values.
@@ -50,22 +89,93 @@ namespace Internal {
  * \sa SourceArtifact
  */
 PropertyMapInternal::PropertyMapInternal()
+    : m_hash(variantHash(m_value)), m_hasPropertyTable(false)
 {
 }
 
 PropertyMapInternal::PropertyMapInternal(const PropertyMapInternal &other)
-    : PersistentObject(other), m_value(other.m_value)
+    : PersistentObject(other), m_value(other.m_value), m_hash(other.m_hash),
+      m_propertyTable(other.m_propertyTable), m_hasPropertyTable(other.m_hasPropertyTable)
+{
+}
+
+QVariant PropertyMapInternal::moduleProperty(const PropertyPath &path) const
 {
+    QBS_CHECK(path.isValid());
+    if (m_hasPropertyTable) {
+        const QHash<int, QVariant>::ConstIterator it = m_propertyTable.constFind(path.index());
+        if (it != m_propertyTable.constEnd())
+            return it.value();
+        return path.lookupMode() == PropertyPath::ScalarValue
+                ? QVariant() : QVariant(QVariantList());
+    }
+
+    PropertyFinder finder;
+    return path.lookupMode() == PropertyPath::ScalarValue
+            ? finder.propertyValue(m_value, path.moduleName(), path.propertyName())
+            : finder.propertyValues(m_value, path.moduleName(), path.propertyName());
 }
 
 QVariant PropertyMapInternal::qbsPropertyValue(const QString &key) const
 {
-    return PropertyFinder().propertyValue(value(), QLatin1String("qbs"), key);
+    return moduleProperty(PropertyPath::get(QLatin1String("qbs"), key));
+}
+
+static void collectModuleNames(const QVariantMap &modules, QSet<QString> *moduleNames)
+{
+    for (QVariantMap::ConstIterator it = modules.constBegin(); it != modules.constEnd(); ++it) {
+        if (it.key().startsWith(QLatin1Char('@')))
+            continue;
+        *moduleNames << it.key();
+        collectModuleNames(it.value().toMap().value(QLatin1String("modules")).toMap(),
+                           moduleNames);
+    }
+}
+
+/*
+ * Resolves all module properties in one go, so that moduleProperty() becomes a plain lookup
+ * in a table that is not modified anymore and can therefore be read without locking.
+ */
+void PropertyMapInternal::buildPropertyTable()
+{
+    m_propertyTable.clear();
+    QSet<QString> moduleNames;
+    collectModuleNames(m_value.value(QLatin1String("modules")).toMap(), &moduleNames);
+    PropertyFinder finder;
+    foreach (const QString &moduleName, moduleNames) {
+        QVariantMap scalarValues;
+        QVariantMap listValues;
+        finder.moduleValues(m_value, moduleName, &scalarValues, &listValues);
+        for (QVariantMap::ConstIterator it = scalarValues.constBegin();
+             it != scalarValues.constEnd(); ++it) {
+            m_propertyTable.insert(PropertyPath::get(moduleName, it.key(),
+                    PropertyPath::ScalarValue).index(), it.value());
+        }
+        for (QVariantMap::ConstIterator it = listValues.constBegin();
+             it != listValues.constEnd(); ++it) {
+            m_propertyTable.insert(PropertyPath::get(moduleName, it.key(),
+                    PropertyPath::MergedListValue).index(), it.value());
+        }
+    }
+    m_hasPropertyTable = true;
 }
 
 void PropertyMapInternal::setValue(const QVariantMap &map)
 {
     m_value = map;
+    m_hash = variantHash(m_value);
+    m_propertyTable.clear();
+    m_hasPropertyTable = false;
+}
+
+uint PropertyMapInternal::hash() const
+{
+    return m_hash;
+}
+
+bool PropertyMapInternal::equals(const PropertyMapInternal &other) const
+{
+    return this == &other || (hash() == other.hash() && m_value == other.m_value);
 }
 
 static QString toJSLiteral_impl(const QVariantMap &vm, int level = 0)
@@ -95,6 +205,10 @@ QString PropertyMapInternal::toJSLiteral() const
 void PropertyMapInternal::load(PersistentPool &pool)
 {
     m_value = pool.loadVariantMap();
+    m_hash = variantHash(m_value);
+
+    // Loaded maps are shared between artifacts and never modified.
+    buildPropertyTable();
 }
 
 void PropertyMapInternal::store(PersistentPool &pool) const
@@ -102,5 +216,122 @@ void PropertyMapInternal::store(PersistentPool &pool) const
     pool.store(m_value);
 }
 
+/*!
+ * \class PropertyMapPool
+ * \brief The \c PropertyMapPool class makes sure equal property maps are represented by only
+ * one \c PropertyMapInternal object.
+ * Besides saving memory, this means the build graph stores the map only once, and comparing two
+ * interned maps is usually a pointer comparison. In addition, the entries of the "modules"
+ * sub-map are shared between all interned maps, so that maps differing only in the properties
+ * of one module share the data of all the other modules, and comparing these entries
+ * short-circuits on the shared data.
+ * Interned maps are immutable: Code that needs to modify such a map must clone() it first.
+ * The pool only holds weak references to the maps, and module data that is not referenced
+ * by any map anymore gets dropped regularly, so the pool does not grow without bound when rules
+ * are re-applied in a long-running session.
+ */
+PropertyMapPtr PropertyMapPool::intern(const PropertyMapPtr &map)
+{
+    if (!map)
+        return map;
+
+    const uint hash = map->hash();
+    QList<QWeakPointer<PropertyMapInternal> > &candidates = m_maps[hash];
+    for (int i = candidates.count() - 1; i >= 0; --i) {
+        const PropertyMapPtr candidate = candidates.at(i).toStrongRef();
+        if (!candidate) {
+            candidates.removeAt(i);
+            continue;
+        }
+        if (candidate == map || candidate->value() == map->value())
+            return candidate;
+    }
+
+    const QString modulesKey = QLatin1String("modules");
+    QVariantMap value = map->value();
+    const QVariantMap::iterator modulesIt = value.find(modulesKey);
+    if (modulesIt != value.end() && modulesIt.value().type() == QVariant::Map) {
+        QVariantMap modules = modulesIt.value().toMap();
+        for (QVariantMap::iterator it = modules.begin(); it != modules.end(); ++it)
+            it.value() = internModuleValue(it.value());
+        modulesIt.value() = modules;
+
+        // The value is still equal, so the hash stays valid.
+        map->m_value = value;
+    }
+    map->buildPropertyTable();
+
+    candidates << map.toWeakRef();
+
+    // Amortized: The work done by purging is proportional to the number of entries.
+    if (++m_insertionsSinceLastPurge > qMax(1024, m_maps.count()))
+        purge();
+    return map;
+}
+
+QVariant PropertyMapPool::internModuleValue(const QVariant &moduleValue)
+{
+    if (moduleValue.type() != QVariant::Map)
+        return moduleValue;
+    const QVariantMap moduleMap = moduleValue.toMap();
+    QList<QVariantMap> &candidates = m_moduleMaps[variantHash(moduleValue)];
+    foreach (const QVariantMap &candidate, candidates) {
+        if (candidate == moduleMap)
+            return candidate;
+    }
+    candidates << moduleMap;
+    return moduleValue;
+}
+
+void PropertyMapPool::purge()
+{
+    m_insertionsSinceLastPurge = 0;
+    for (QHash<uint, QList<QWeakPointer<PropertyMapInternal> > >::iterator it = m_maps.begin();
+         it != m_maps.end();) {
+        QList<QWeakPointer<PropertyMapInternal> > &maps = it.value();
+        for (int i = maps.count() - 1; i >= 0; --i) {
+            if (maps.at(i).isNull())
+                maps.removeAt(i);
+        }
+        if (maps.isEmpty())
+            it = m_maps.erase(it);
+        else
+            ++it;
+    }
+
+    // A module map that is not detached is still shared with the value of some map.
+    for (QHash<uint, QList<QVariantMap> >::iterator it = m_moduleMaps.begin();
+         it != m_moduleMaps.end();) {
+        QList<QVariantMap> &moduleMaps = it.value();
+        for (int i = moduleMaps.count() - 1; i >= 0; --i) {
+            if (moduleMaps[i].isDetached())
+                moduleMaps.removeAt(i);
+        }
+        if (moduleMaps.isEmpty())
+            it = m_moduleMaps.erase(it);
+        else
+            ++it;
+    }
+}
+
+void PropertyMapPool::clear()
+{
+    m_maps.clear();
+    m_moduleMaps.clear();
+    m_insertionsSinceLastPurge = 0;
+}
+
+int PropertyMapPool::count() const
+{
+    int liveCount = 0;
+    foreach (const QList<QWeakPointer<PropertyMapInternal> > &maps, m_maps) {
+        foreach (const QWeakPointer<PropertyMapInternal> &map, maps) {
+            if (!map.isNull())
+                ++liveCount;
+        }
+    }
+    return liveCount;
+}
+
 } // namespace Internal
 } // namespace qbs
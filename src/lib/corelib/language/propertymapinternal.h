@@ -33,22 +33,31 @@
 
 #include "forward_decls.h"
 #include <tools/persistentobject.h>
+#include <tools/propertypath.h>
+#include <QHash>
+#include <QList>
 #include <QVariantMap>
+#include <QWeakPointer>
 
 namespace qbs {
 namespace Internal {
 
 class PropertyMapInternal : public PersistentObject
 {
+    friend class PropertyMapPool;
 public:
     static PropertyMapPtr create() { return PropertyMapPtr(new PropertyMapInternal); }
     PropertyMapPtr clone() const { return PropertyMapPtr(new PropertyMapInternal(*this)); }
 
     const QVariantMap &value() const { return m_value; }
+    QVariant moduleProperty(const PropertyPath &path) const;
     QVariant qbsPropertyValue(const QString &key) const; // Convenience function.
     void setValue(const QVariantMap &value);
     QString toJSLiteral() const;
 
+    uint hash() const;
+    bool equals(const PropertyMapInternal &other) const;
+
 private:
     PropertyMapInternal();
     PropertyMapInternal(const PropertyMapInternal &other);
@@ -56,7 +65,33 @@ private:
     void load(PersistentPool &);
     void store(PersistentPool &) const;
 
+    void buildPropertyTable();
+
     QVariantMap m_value;
+    uint m_hash; // Computed whenever the value is set, so reading it needs no synchronization.
+
+    // Built when the map becomes immutable, i.e. when it gets interned or loaded. Interned maps
+    // are shared between threads, which is fine, because the table is never modified afterwards.
+    QHash<int, QVariant> m_propertyTable; // Keyed by PropertyPath::index().
+    bool m_hasPropertyTable;
+};
+
+class PropertyMapPool
+{
+public:
+    PropertyMapPool() : m_insertionsSinceLastPurge(0) {}
+
+    PropertyMapPtr intern(const PropertyMapPtr &map);
+    void clear();
+    int count() const;
+
+private:
+    QVariant internModuleValue(const QVariant &moduleValue);
+    void purge();
+
+    QHash<uint, QList<QWeakPointer<PropertyMapInternal> > > m_maps;
+    QHash<uint, QList<QVariantMap> > m_moduleMaps;
+    int m_insertionsSinceLastPurge;
 };
 
 } // namespace Internal
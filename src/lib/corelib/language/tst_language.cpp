@@ -41,12 +41,14 @@
 #include <parser/qmljslexer_p.h>
 #include <parser/qmljsparser_p.h>
 #include <tools/scripttools.h>
+#include <tools/directorysnapshot.h>
 #include <tools/error.h>
 #include <tools/hostosinfo.h>
 #include <tools/profile.h>
 #include <tools/propertyfinder.h>
 
 #include <QProcessEnvironment>
+#include <QTemporaryDir>
 
 Q_DECLARE_METATYPE(QList<bool>)
 
@@ -863,6 +865,41 @@ void TestLanguage::itemScope()
     QCOMPARE(evaluator.property(item, "z").toVariant().toInt(), 3);
 }
 
+void TestLanguage::itemPropertyNameIndex()
+{
+    FileContextPtr fileContext = FileContext::create();
+    JSSourceValueCreator sourceValueCreator(fileContext);
+    ItemPool pool;
+    Item *item = Item::create(&pool);
+    const int xId = Item::propertyNameId("x");
+    const int yId = Item::propertyNameId("y");
+    QCOMPARE(Item::propertyNameId("x"), xId);
+    QVERIFY(xId != yId);
+
+    const ValuePtr x = sourceValueCreator.create("1");
+    item->setProperty("x", x);
+    QCOMPARE(item->ownProperty(xId), x);
+    QVERIFY(!item->ownProperty(yId));
+
+    // The index must follow changes made after it was built.
+    const ValuePtr y = sourceValueCreator.create("x + 1");
+    item->setProperty("y", y);
+    PropertyDeclaration decl("y", PropertyDeclaration::Integer);
+    item->setPropertyDeclaration("y", decl);
+    QCOMPARE(item->ownProperty(yId), y);
+    QCOMPARE(item->ownPropertyDeclaration(yId).type(), PropertyDeclaration::Integer);
+    item->removeProperty("x");
+    QVERIFY(!item->ownProperty(xId));
+
+    Item * const clone = item->clone(&pool);
+    QVERIFY(clone->ownProperty(yId));
+    QCOMPARE(clone->ownPropertyDeclaration(yId).type(), PropertyDeclaration::Integer);
+
+    Evaluator evaluator(m_engine, m_logger);
+    item->setProperty("x", sourceValueCreator.create("\"1\""));
+    QCOMPARE(evaluator.property(item, "y").toVariant().toInt(), 11);
+}
+
 void TestLanguage::jsExtensions()
 {
     QFile file(testProject("jsextensions.js"));
@@ -1151,6 +1188,22 @@ void TestLanguage::profileValuesAndOverriddenValues()
     QCOMPARE(exceptionCaught, false);
 }
 
+void TestLanguage::productCommandCaches()
+{
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->cacheExecutablePath("gcc", "/usr/bin/gcc");
+    QProcessEnvironment env;
+    env.insert("PATH", "/usr/bin");
+    product->cacheCommandEnvironment(QString(), env);
+    QCOMPARE(product->cachedExecutablePath("gcc"), QString("/usr/bin/gcc"));
+    QCOMPARE(product->cachedCommandEnvironment(QString()), env);
+    QVERIFY(product->cachedCommandEnvironment("FOO=bar").isEmpty());
+
+    product->clearCommandCaches();
+    QVERIFY(product->cachedExecutablePath("gcc").isEmpty());
+    QVERIFY(product->cachedCommandEnvironment(QString()).isEmpty());
+}
+
 void TestLanguage::productConditions()
 {
     bool exceptionCaught = false;
@@ -1309,6 +1362,103 @@ void TestLanguage::propertiesBlocks()
     }
 }
 
+void TestLanguage::propertyMapPool()
+{
+    QVariantMap cppModule;
+    cppModule.insert("defines", QStringList() << "A" << "B");
+    QVariantMap qbsModule;
+    qbsModule.insert("install", false);
+    QVariantMap modules;
+    modules.insert("cpp", cppModule);
+    modules.insert("qbs", qbsModule);
+    QVariantMap value;
+    value.insert("modules", modules);
+
+    const PropertyMapPtr map1 = PropertyMapInternal::create();
+    map1->setValue(value);
+    const PropertyMapPtr map2 = PropertyMapInternal::create();
+    map2->setValue(value);
+    QVERIFY(map1->equals(*map2));
+    QCOMPARE(map1->hash(), map2->hash());
+
+    PropertyMapPool pool;
+    QCOMPARE(pool.intern(map1), map1);
+    QCOMPARE(pool.intern(map2), map1);
+    QCOMPARE(pool.count(), 1);
+
+    qbsModule.insert("install", true);
+    modules.insert("qbs", qbsModule);
+    value.insert("modules", modules);
+    const PropertyMapPtr map3 = PropertyMapInternal::create();
+    map3->setValue(value);
+    QVERIFY(!map3->equals(*map1));
+    QCOMPARE(pool.intern(map3), map3);
+    QCOMPARE(pool.count(), 2);
+    QCOMPARE(map3->value().value("modules").toMap().value("cpp").toMap(), cppModule);
+    QCOMPARE(map3->qbsPropertyValue("install"), QVariant(true));
+
+    // The pool must not keep maps alive that nobody else refers to.
+    {
+        const PropertyMapPtr map4 = PropertyMapInternal::create();
+        map4->setValue(QVariantMap());
+        QCOMPARE(pool.intern(map4), map4);
+        QCOMPARE(pool.count(), 3);
+    }
+    QCOMPARE(pool.count(), 2);
+}
+
+void TestLanguage::propertyPaths()
+{
+    const PropertyPath definesPath = PropertyPath::get("cpp", "defines");
+    QVERIFY(definesPath.isValid());
+    QVERIFY(definesPath == PropertyPath::get("cpp", "defines"));
+    QVERIFY(definesPath != PropertyPath::get("cpp", "defines", PropertyPath::MergedListValue));
+    QVERIFY(definesPath != PropertyPath::get("cpp", "includePaths"));
+
+    QVariantMap cppModule;
+    cppModule.insert("defines", QStringList() << "A");
+    QVariantMap modules;
+    modules.insert("cpp", cppModule);
+    QVariantMap value;
+    value.insert("modules", modules);
+    const PropertyMapPtr map = PropertyMapInternal::create();
+    map->setValue(value);
+    QCOMPARE(map->moduleProperty(definesPath).toStringList(), QStringList() << "A");
+    QCOMPARE(map->moduleProperty(definesPath).toStringList(), QStringList() << "A");
+    QVERIFY(!map->moduleProperty(PropertyPath::get("cpp", "includePaths")).isValid());
+
+    cppModule.insert("defines", QStringList() << "B");
+    modules.insert("cpp", cppModule);
+    value.insert("modules", modules);
+    map->setValue(value);
+    QCOMPARE(map->moduleProperty(definesPath).toStringList(), QStringList() << "B");
+
+    // Interned maps answer from their flattened table, which must agree with the finder.
+    QVariantMap qbsModule;
+    qbsModule.insert("install", true);
+    QVariantMap cppModules;
+    cppModules.insert("qbs", qbsModule);
+    cppModule.insert("modules", cppModules);
+    modules.insert("cpp", cppModule);
+    qbsModule.insert("install", false);
+    qbsModule.insert("installDir", "bin");
+    modules.insert("qbs", qbsModule);
+    value.insert("modules", modules);
+    map->setValue(value);
+    PropertyMapPool pool;
+    QCOMPARE(pool.intern(map), map);
+    PropertyFinder finder;
+    const QStringList qbsProperties = QStringList() << "install" << "installDir" << "unknown";
+    foreach (const QString &propertyName, qbsProperties) {
+        QCOMPARE(map->moduleProperty(PropertyPath::get("qbs", propertyName)),
+                 finder.propertyValue(value, "qbs", propertyName));
+        QCOMPARE(map->moduleProperty(PropertyPath::get("qbs", propertyName,
+                                                       PropertyPath::MergedListValue)),
+                 QVariant(finder.propertyValues(value, "qbs", propertyName)));
+    }
+    QCOMPARE(map->moduleProperty(definesPath).toStringList(), QStringList() << "B");
+}
+
 void TestLanguage::fileTags_data()
 {
     QTest::addColumn<int>("numberOfGroups");
@@ -1344,6 +1494,52 @@ void TestLanguage::fileTags()
     QCOMPARE(fileTags, expectedFileTags);
 }
 
+void TestLanguage::wildcardExpansion()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString baseDir = QDir(tempDir.path()).canonicalPath();
+    foreach (const QString &fileName, QStringList() << "a.cpp" << "B.CPP" << "other.h"
+             << "sub/c.cpp" << "sub/.hidden.cpp" << "sub/deeper/d.cpp") {
+        const QString filePath = baseDir + '/' + fileName;
+        QVERIFY(QDir().mkpath(QFileInfo(filePath).path()));
+        QFile file(filePath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    // Patterns match case-insensitively on all hosts, like QDirIterator's name filters did.
+    SourceWildCards::Ptr wildcards = SourceWildCards::create();
+    wildcards->patterns << "*.cpp" << "sub/**/*.cpp";
+    wildcards->excludePatterns << "sub/deeper/*";
+    QSet<QString> expected;
+    expected << baseDir + "/a.cpp" << baseDir + "/B.CPP" << baseDir + "/sub/c.cpp";
+    QCOMPARE(wildcards->expandPatterns(baseDir, 0, &wildcards->dirTimeStamps), expected);
+    wildcards->patterns = QStringList("SUB/C.cpp");
+    wildcards->excludePatterns.clear();
+    QCOMPARE(wildcards->expandPatterns(baseDir, 0, &wildcards->dirTimeStamps),
+             QSet<QString>() << baseDir + "/sub/c.cpp");
+
+    // Unchanged directories let the caller skip the re-expansion.
+    wildcards->patterns = QStringList("**/*.cpp");
+    DirectorySnapshot snapshot;
+    QCOMPARE(wildcards->expandPatterns(baseDir, &snapshot, &wildcards->dirTimeStamps).count(), 4);
+    QVERIFY(wildcards->dirTimeStamps.contains(baseDir + "/sub/deeper"));
+    QVERIFY(!wildcards->directoriesChanged());
+
+    // Wait for a new time stamp, as the file times have a resolution of one second.
+    QTest::qWait(1100);
+    QFile newFile(baseDir + "/sub/deeper/e.cpp");
+    QVERIFY(newFile.open(QIODevice::WriteOnly));
+    newFile.close();
+    QVERIFY(wildcards->directoriesChanged());
+    QCOMPARE(wildcards->expandPatterns(baseDir, 0, &wildcards->dirTimeStamps).count(), 5);
+    QVERIFY(!wildcards->directoriesChanged());
+
+    // Without any recorded time stamps, nothing is known about the directories.
+    wildcards->dirTimeStamps.clear();
+    QVERIFY(wildcards->directoriesChanged());
+}
+
 void TestLanguage::wildcards_data()
 {
     QTest::addColumn<bool>("useGroup");
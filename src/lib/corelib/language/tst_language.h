@@ -89,6 +89,7 @@ private slots:
     void invalidBindingInDisabledItem();
     void itemPrototype();
     void itemScope();
+    void itemPropertyNameIndex();
     void jsExtensions();
     void jsImportUsedInMultipleScopes_data();
     void jsImportUsedInMultipleScopes();
@@ -100,12 +101,16 @@ private slots:
     void outerInGroup();
     void pathProperties();
     void profileValuesAndOverriddenValues();
+    void productCommandCaches();
     void productConditions();
     void productDirectories();
     void propertiesBlocks_data();
     void propertiesBlocks();
+    void propertyMapPool();
+    void propertyPaths();
     void fileTags_data();
     void fileTags();
+    void wildcardExpansion();
     void wildcards_data();
     void wildcards();
 };
@@ -34,6 +34,7 @@
 #include "ilogsink.h"
 
 #include <QByteArray>
+#include <QSharedPointer>
 #include <QString>
 #include <QStringList>
 
@@ -43,6 +44,7 @@ QT_END_NAMESPACE
 
 namespace qbs {
 namespace Internal {
+class MetricsCollector;
 
 // Note that while these classes are not part of the API, we export some stuff for use by
 // our command line tools for the sake of a uniform logging approach.
@@ -113,8 +115,15 @@ public:
     LogWriter qbsDebug() const { return qbsLog(LoggerDebug); }
     LogWriter qbsTrace() const { return qbsLog(LoggerTrace); }
 
+    QSharedPointer<MetricsCollector> metricsCollector() const { return m_metricsCollector; }
+    void setMetricsCollector(const QSharedPointer<MetricsCollector> &collector)
+    {
+        m_metricsCollector = collector;
+    }
+
 private:
     ILogSink *m_logSink;
+    QSharedPointer<MetricsCollector> m_metricsCollector;
 };
 
 
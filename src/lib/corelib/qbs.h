@@ -42,6 +42,8 @@
 #include "tools/error.h"
 #include "tools/generateoptions.h"
 #include "tools/installoptions.h"
+#include "tools/metrics.h"
+#include "tools/nodetreedumpoptions.h"
 #include "tools/preferences.h"
 #include "tools/profile.h"
 #include "tools/processresult.h"
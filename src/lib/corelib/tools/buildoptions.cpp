@@ -41,7 +41,8 @@ public:
     BuildOptionsPrivate()
         : maxJobCount(0), dryRun(false), keepGoing(false), forceTimestampCheck(false),
           logElapsedTime(false), echoMode(defaultCommandEchoMode()), install(true),
-          removeExistingInstallation(false)
+          removeExistingInstallation(false), streamProcessOutput(false),
+          processOutputSpillThreshold(0)
     {
     }
 
@@ -56,6 +57,8 @@ public:
     CommandEchoMode echoMode;
     bool install;
     bool removeExistingInstallation;
+    bool streamProcessOutput;
+    int processOutputSpillThreshold;
 };
 
 } // namespace Internal
@@ -308,6 +311,54 @@ void BuildOptions::setRemoveExistingInstallation(bool removeExisting)
     d->removeExistingInstallation = removeExisting;
 }
 
+/*!
+ * \brief Returns true iff the output of external processes is reported while they are running.
+ * The default is \c false.
+ * \sa setStreamProcessOutput
+ */
+bool BuildOptions::streamProcessOutput() const
+{
+    return d->streamProcessOutput;
+}
+
+/*!
+ * \brief Controls whether the output of external processes is reported while they are running.
+ * If enabled, the output is reported in chunks of complete lines via
+ * \c BuildJob::reportProcessOutput() and the \c ProcessResult of a command does not contain any
+ * output. Channels that have an output filter function are not streamed, as the filter needs
+ * to see the complete output; their filtered output goes into the \c ProcessResult.
+ * Otherwise, the output is collected until the process has finished.
+ */
+void BuildOptions::setStreamProcessOutput(bool stream)
+{
+    d->streamProcessOutput = stream;
+}
+
+/*!
+ * \brief Returns the number of bytes of output per channel that are kept in memory for a process.
+ * A value <= 0 means there is no limit. The default is 0.
+ * \sa setProcessOutputSpillThreshold
+ */
+int BuildOptions::processOutputSpillThreshold() const
+{
+    return d->processOutputSpillThreshold;
+}
+
+/*!
+ * \brief Limits the amount of process output that is kept in memory.
+ * If a process writes more than \a byteCount bytes to one of its output channels, the rest of
+ * that output is written to a temporary file while the process is running. When the process
+ * has finished, the complete output of that channel is reported in chunks of bounded size via
+ * \c BuildJob::reportProcessOutput() instead of being put into the \c ProcessResult, and the
+ * file is removed. This way, large output is never held in memory as a whole.
+ * This setting has no effect if the output is streamed, nor for channels that have an output
+ * filter function, as the filter needs to see the complete output.
+ */
+void BuildOptions::setProcessOutputSpillThreshold(int byteCount)
+{
+    d->processOutputSpillThreshold = byteCount;
+}
+
 
 bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
 {
@@ -318,7 +369,9 @@ bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
             && bo1.echoMode() == bo2.echoMode()
             && bo1.maxJobCount() == bo2.maxJobCount()
             && bo1.install() == bo2.install()
-            && bo1.removeExistingInstallation() == bo2.removeExistingInstallation();
+            && bo1.removeExistingInstallation() == bo2.removeExistingInstallation()
+            && bo1.streamProcessOutput() == bo2.streamProcessOutput()
+            && bo1.processOutputSpillThreshold() == bo2.processOutputSpillThreshold();
 }
 
 } // namespace qbs
@@ -82,6 +82,12 @@ public:
     bool removeExistingInstallation() const;
     void setRemoveExistingInstallation(bool removeExisting);
 
+    bool streamProcessOutput() const;
+    void setStreamProcessOutput(bool stream);
+
+    int processOutputSpillThreshold() const;
+    void setProcessOutputSpillThreshold(int byteCount);
+
 private:
     QSharedDataPointer<Internal::BuildOptionsPrivate> d;
 };
@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "directorylistingcache.h"
+
+#include "fileinfo.h"
+#include "hostosinfo.h"
+
+#include <QDir>
+#include <QMutexLocker>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class DirectoryListingCache
+ * \brief The \c DirectoryListingCache class answers file existence queries from directory
+ * listings.
+ * It is meant for directories that get queried for many file names that mostly do not exist,
+ * such as include paths. Every directory is listed once and its listing is kept across builds.
+ * A listing is re-validated against the directory's modification time once per generation;
+ * call startNewGeneration() when the file system might have changed, e.g. at the start of
+ * a build. Within a generation, queries do not cause any system calls.
+ */
+
+DirectoryListingCache::DirectoryListingCache() : m_generation(0)
+{
+}
+
+DirectoryListingCache *DirectoryListingCache::instance()
+{
+    static DirectoryListingCache cache;
+    return &cache;
+}
+
+void DirectoryListingCache::startNewGeneration()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+}
+
+static QString normalizedFileName(const QString &fileName)
+{
+    return HostOsInfo::fileNameCaseSensitivity() == Qt::CaseInsensitive
+            ? fileName.toLower() : fileName;
+}
+
+bool DirectoryListingCache::fileExists(const QString &dirPath, const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    Listing &listing = m_listings[dirPath];
+    if (listing.generation != m_generation) {
+        updateListing(dirPath, listing);
+        listing.generation = m_generation;
+    }
+    return listing.entries.contains(normalizedFileName(fileName));
+}
+
+void DirectoryListingCache::updateListing(const QString &dirPath, Listing &listing)
+{
+    const FileInfo dirInfo(dirPath);
+    const bool dirExists = dirInfo.exists() && dirInfo.isDir();
+    const FileTime dirTime = dirExists ? dirInfo.lastModified() : FileTime();
+
+    // A listing taken in the same time stamp granularity interval as the last modification
+    // of the directory might have missed changes done later in that interval.
+    if (listing.generation != -1 && listing.dirExists == dirExists && listing.dirTime == dirTime
+            && (!dirExists || dirTime < listing.listingTime)) {
+        return;
+    }
+
+    listing.dirExists = dirExists;
+    listing.dirTime = dirTime;
+    listing.listingTime = FileTime::currentTime();
+    listing.entries.clear();
+    if (!dirExists)
+        return;
+
+    // Broken symbolic links are not listed, as they do not count as existing files either.
+    const QStringList entries = QDir(dirPath).entryList(QDir::AllEntries | QDir::Hidden
+                                                        | QDir::NoDotAndDotDot);
+    foreach (const QString &entry, entries)
+        listing.entries << normalizedFileName(entry);
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "directorysnapshot.h"
+
+#include "fileinfo.h"
+#include "hostosinfo.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class DirectorySnapshot
+ * \brief The \c DirectorySnapshot class lists every directory at most once.
+ * It is meant to be shared by all users that walk the same directory trees during one
+ * operation, such as the expansion of the wildcards of all groups during a project load.
+ * A snapshot never updates itself, so it should not outlive that operation.
+ */
+
+/*!
+ * \brief Returns true iff the listing has an entry with the given name.
+ */
+bool DirectorySnapshot::Listing::containsEntry(const QString &name) const
+{
+    foreach (const Entry &entry, entries) {
+        if (entry.name.compare(name, HostOsInfo::fileNameCaseSensitivity()) == 0)
+            return true;
+    }
+    return false;
+}
+
+/*!
+ * \brief Returns the listing of the given directory, reading it from disk on first access.
+ * The listing is not reliable if the directory was modified in the same time stamp
+ * granularity interval as it was read, because later changes in that interval would not be
+ * visible in the directory's time stamp.
+ */
+DirectorySnapshot::Listing DirectorySnapshot::listing(const QString &dirPath)
+{
+    const QString cleanDirPath = QDir::cleanPath(dirPath);
+    QHash<QString, Listing>::const_iterator it = m_listings.constFind(cleanDirPath);
+    if (it != m_listings.constEnd())
+        return it.value();
+
+    Listing listing;
+    const FileTime listingTime = FileTime::currentTime();
+    const FileInfo dirInfo(cleanDirPath);
+    listing.exists = dirInfo.exists() && dirInfo.isDir();
+    listing.dirTime = listing.exists ? dirInfo.lastModified() : FileTime();
+    listing.isReliable = !listing.exists || listing.dirTime < listingTime;
+    if (!listing.exists) {
+        m_listings.insert(cleanDirPath, listing);
+        return listing;
+    }
+
+    // Broken symbolic links are not listed, just like QDirIterator does not report them.
+    const QFileInfoList entryInfos = QDir(cleanDirPath).entryInfoList(
+                QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot, QDir::Unsorted);
+    foreach (const QFileInfo &entryInfo, entryInfos) {
+        Entry entry;
+        entry.name = entryInfo.fileName();
+        entry.isDir = entryInfo.isDir();
+        entry.isFile = entryInfo.isFile();
+        entry.isHidden = entryInfo.isHidden();
+        entry.isSymLink = entryInfo.isSymLink();
+        listing.entries << entry;
+    }
+    m_listings.insert(cleanDirPath, listing);
+    return listing;
+}
+
+/*!
+ * \brief Returns the modification time of the given directory, or an invalid time if it
+ * does not exist.
+ */
+FileTime DirectorySnapshot::currentDirectoryTime(const QString &dirPath)
+{
+    const FileInfo dirInfo(dirPath);
+    return dirInfo.exists() && dirInfo.isDir() ? dirInfo.lastModified() : FileTime();
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_DIRECTORYSNAPSHOT_H
+#define QBS_DIRECTORYSNAPSHOT_H
+
+#include "filetime.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+namespace qbs {
+namespace Internal {
+
+class DirectorySnapshot
+{
+public:
+    class Entry
+    {
+    public:
+        Entry() : isDir(false), isFile(false), isHidden(false), isSymLink(false) {}
+
+        QString name;
+        bool isDir;
+        bool isFile;
+        bool isHidden;
+        bool isSymLink;
+    };
+
+    class Listing
+    {
+    public:
+        Listing() : exists(false), isReliable(false) {}
+
+        bool containsEntry(const QString &name) const;
+
+        bool exists;
+        FileTime dirTime;
+        bool isReliable;
+        QList<Entry> entries;
+    };
+
+    Listing listing(const QString &dirPath);
+
+    static FileTime currentDirectoryTime(const QString &dirPath);
+
+private:
+    QHash<QString, Listing> m_listings;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_DIRECTORYSNAPSHOT_H
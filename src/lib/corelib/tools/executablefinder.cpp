@@ -104,7 +104,9 @@ bool ExecutableFinder::candidateCheck(const QString &directory, const QString &p
 
 QString ExecutableFinder::findInPath(const QString &filePath, const QString &workingDirPath) const
 {
-    QString fullProgramPath = cachedFilePath(filePath);
+    // The result depends on the working directory if PATH contains ".".
+    const QString cacheKey = filePath + QLatin1Char('\n') + workingDirPath;
+    QString fullProgramPath = cachedFilePath(cacheKey);
     if (!fullProgramPath.isEmpty())
         return fullProgramPath;
 
@@ -127,7 +129,7 @@ QString ExecutableFinder::findInPath(const QString &filePath, const QString &wor
         if (candidateCheck(directory, fullProgramPath, fullProgramPath))
             break;
     }
-    cacheFilePath(filePath, fullProgramPath);
+    cacheFilePath(cacheKey, fullProgramPath);
     return fullProgramPath;
 }
 
@@ -0,0 +1,310 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "jobserver.h"
+
+#include "qbsassert.h"
+
+#include <QList>
+#include <QMutexLocker>
+#include <QProcessEnvironment>
+#include <QStringList>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class JobServer
+ * \brief The \c JobServer class hands out the tokens that limit the number of commands running
+ * in parallel across all builds in this process.
+ * Every executor has to acquire a token before it starts a command and give it back once the
+ * command has finished, so that building several configurations at once does not multiply the
+ * number of processes. The pool grows to the largest job count requested via
+ * ensureTokenCount(); it never shrinks.
+ * On Unix, the tokens live in a pipe that is exported to child processes via the GNU make
+ * jobserver protocol, so that tools like make or ninja that are run by rules draw from the same
+ * pool. Like with make, the process itself owns one implicit token that is not in the pipe.
+ * If qbs itself is run by make with a jobserver, the parent's pipe is used instead and the
+ * job count given on our side has no effect. On other platforms, the tokens are just counted.
+ * The file status flags of the pipe are never changed, as the open file description is shared
+ * with make and all other processes using the pipe. Instead, tokens are read from a private,
+ * non-blocking description of the read end where the system allows reopening it.
+ * Our descriptors of the pipe are close-on-exec, so that compilers and other tools that know
+ * nothing about the protocol cannot mess up the token count. Only commands that opt in
+ * via \c ProcessCommand::usesJobServer() inherit them and get \c MAKEFLAGS set up.
+ */
+
+JobServer::JobServer(const QByteArray &makeFlags)
+    : m_readFd(-1)
+    , m_writeFd(-1)
+    , m_tokenFd(-1)
+    , m_isClient(false)
+    , m_implicitTokenTaken(false)
+    , m_tokenCount(1)
+    , m_heldCountedTokens(0)
+{
+    m_isClient = takeClientFds(makeFlags);
+    if (!m_isClient)
+        createPipe();
+    openTokenFd();
+}
+
+JobServer::~JobServer()
+{
+#if defined(Q_OS_UNIX)
+    if (m_tokenFd != -1)
+        ::close(m_tokenFd);
+    if (!m_isClient && hasPipe()) {
+        ::close(m_readFd);
+        ::close(m_writeFd);
+    }
+#endif
+}
+
+JobServer *JobServer::instance()
+{
+    static JobServer server(qgetenv("MAKEFLAGS"));
+    return &server;
+}
+
+void JobServer::ensureTokenCount(int count)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_isClient || count <= m_tokenCount)
+            return;
+        if (hasPipe())
+            writeTokens(QByteArray(count - m_tokenCount, '+'));
+        m_tokenCount = count;
+    }
+    emit tokenReleased();
+}
+
+bool JobServer::tryAcquireToken()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_implicitTokenTaken) {
+        m_implicitTokenTaken = true;
+        return true;
+    }
+#if defined(Q_OS_UNIX)
+    if (hasPipe()) {
+        if (m_tokenFd == -1) {
+            // The shared read end may be blocking. Another process can still take the token
+            // between the check and the read, in which case we wait for the next one.
+            struct pollfd pfd;
+            pfd.fd = m_readFd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, 0) != 1 || !(pfd.revents & POLLIN))
+                return false;
+        }
+        const int fd = m_tokenFd != -1 ? m_tokenFd : m_readFd;
+        char token;
+        ssize_t bytesRead;
+        do {
+            bytesRead = ::read(fd, &token, 1);
+        } while (bytesRead == -1 && errno == EINTR);
+        if (bytesRead != 1)
+            return false;
+        m_heldPipeTokens += token;
+        return true;
+    }
+#endif
+    if (m_heldCountedTokens >= m_tokenCount - 1)
+        return false;
+    ++m_heldCountedTokens;
+    return true;
+}
+
+void JobServer::releaseToken()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_heldPipeTokens.isEmpty()) {
+            // Tokens must be given back as they were read, make uses their value.
+            writeTokens(m_heldPipeTokens.right(1));
+            m_heldPipeTokens.chop(1);
+        } else if (m_heldCountedTokens > 0) {
+            --m_heldCountedTokens;
+        } else {
+            QBS_ASSERT(m_implicitTokenTaken, return);
+            m_implicitTokenTaken = false;
+        }
+    }
+    emit tokenReleased();
+}
+
+static QStringList makeFlagsWithoutJobServer(const QProcessEnvironment &env)
+{
+    QStringList flags = env.value(QLatin1String("MAKEFLAGS"))
+            .split(QLatin1Char(' '), QString::SkipEmptyParts);
+    for (QStringList::Iterator it = flags.begin(); it != flags.end();) {
+        if (it->startsWith(QLatin1String("--jobserver-")) || it->startsWith(QLatin1String("-j")))
+            it = flags.erase(it);
+        else
+            ++it;
+    }
+    return flags;
+}
+
+void JobServer::exportToEnvironment(QProcessEnvironment &env) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!hasPipe())
+        return;
+    QStringList flags = makeFlagsWithoutJobServer(env);
+    const QString fds = QString::fromLatin1("%1,%2").arg(m_readFd).arg(m_writeFd);
+
+    // make < 4.2 only understands the old option name, newer tools only the new one.
+    flags << QLatin1String("-j") << QLatin1String("--jobserver-fds=") + fds
+          << QLatin1String("--jobserver-auth=") + fds;
+    env.insert(QLatin1String("MAKEFLAGS"), flags.join(QLatin1Char(' ')));
+}
+
+// The descriptors mentioned in an inherited MAKEFLAGS are not available to the process anymore.
+void JobServer::removeFromEnvironment(QProcessEnvironment &env) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!hasPipe() || !env.contains(QLatin1String("MAKEFLAGS")))
+        return;
+    const QStringList flags = makeFlagsWithoutJobServer(env);
+    if (flags.isEmpty())
+        env.remove(QLatin1String("MAKEFLAGS"));
+    else
+        env.insert(QLatin1String("MAKEFLAGS"), flags.join(QLatin1Char(' ')));
+}
+
+QList<int> JobServer::fileDescriptors() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!hasPipe())
+        return QList<int>();
+    return QList<int>() << m_readFd << m_writeFd;
+}
+
+bool JobServer::takeClientFds(const QByteArray &makeFlags)
+{
+#if defined(Q_OS_UNIX)
+    QByteArray fdsString;
+    foreach (const QByteArray &flag, makeFlags.split(' ')) {
+        if (flag.startsWith("--jobserver-auth="))
+            fdsString = flag.mid(17);
+        else if (flag.startsWith("--jobserver-fds="))
+            fdsString = flag.mid(16);
+    }
+    const QList<QByteArray> fds = fdsString.split(',');
+    if (fds.count() != 2)
+        return false;
+    bool readFdOk;
+    bool writeFdOk;
+    const int readFd = fds.first().toInt(&readFdOk);
+    const int writeFd = fds.last().toInt(&writeFdOk);
+
+    // make closes the pipe for commands that it does not consider to be sub-makes.
+    const int readFdFlags = readFdOk ? ::fcntl(readFd, F_GETFD) : -1;
+    const int writeFdFlags = writeFdOk ? ::fcntl(writeFd, F_GETFD) : -1;
+    if (readFdFlags == -1 || writeFdFlags == -1)
+        return false;
+
+    // The descriptor flags, unlike the file status flags, are not shared with make.
+    ::fcntl(readFd, F_SETFD, readFdFlags | FD_CLOEXEC);
+    ::fcntl(writeFd, F_SETFD, writeFdFlags | FD_CLOEXEC);
+    m_readFd = readFd;
+    m_writeFd = writeFd;
+    return true;
+#else
+    Q_UNUSED(makeFlags);
+    return false;
+#endif
+}
+
+void JobServer::createPipe()
+{
+#if defined(Q_OS_UNIX)
+    // Commands using the jobserver inherit the descriptors explicitly, see SpawnedProcess.
+    int fds[2];
+#if defined(Q_OS_LINUX)
+    if (::pipe2(fds, O_CLOEXEC) != 0)
+        return; // Fall back to counting.
+#else
+    if (::pipe(fds) != 0)
+        return; // Fall back to counting.
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+    m_readFd = fds[0];
+    m_writeFd = fds[1];
+#endif
+}
+
+void JobServer::openTokenFd()
+{
+#if defined(Q_OS_LINUX)
+    // Opening the /proc entry of a pipe yields a new open file description, so that it
+    // can be made non-blocking without affecting anyone else.
+    if (!hasPipe())
+        return;
+    const QByteArray fdPath = "/proc/self/fd/" + QByteArray::number(m_readFd);
+    do {
+        m_tokenFd = ::open(fdPath.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    } while (m_tokenFd == -1 && errno == EINTR);
+#endif
+}
+
+void JobServer::writeTokens(const QByteArray &tokens)
+{
+#if defined(Q_OS_UNIX)
+    const char *data = tokens.constData();
+    int bytesLeft = tokens.size();
+    while (bytesLeft > 0) {
+        const ssize_t bytesWritten = ::write(m_writeFd, data, bytesLeft);
+        if (bytesWritten == -1) {
+            if (errno == EINTR)
+                continue;
+            QBS_ASSERT(!"cannot write to jobserver pipe", return);
+        }
+        data += bytesWritten;
+        bytesLeft -= bytesWritten;
+    }
+#else
+    Q_UNUSED(tokens);
+#endif
+}
+
+} // namespace Internal
+} // namespace qbs
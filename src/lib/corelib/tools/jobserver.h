@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#ifndef QBS_JOBSERVER_H
+#define QBS_JOBSERVER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+
+QT_BEGIN_NAMESPACE
+class QProcessEnvironment;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+class JobServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit JobServer(const QByteArray &makeFlags);
+    ~JobServer();
+
+    static JobServer *instance();
+
+    void ensureTokenCount(int count);
+    bool tryAcquireToken();
+    void releaseToken();
+
+    bool isClient() const { return m_isClient; }
+
+    // Only for processes that take part in the protocol; they must also inherit fileDescriptors().
+    void exportToEnvironment(QProcessEnvironment &env) const;
+    void removeFromEnvironment(QProcessEnvironment &env) const;
+    QList<int> fileDescriptors() const;
+
+    // Becomes readable when the pipe has tokens; -1 if there is no pipe. Meant for a
+    // QSocketNotifier, as tokens given back by other processes do not emit tokenReleased().
+    int tokenNotificationFd() const { return m_tokenFd != -1 ? m_tokenFd : m_readFd; }
+
+signals:
+    void tokenReleased();
+
+private:
+    bool hasPipe() const { return m_readFd != -1; }
+    bool takeClientFds(const QByteArray &makeFlags);
+    void createPipe();
+    void openTokenFd();
+    void writeTokens(const QByteArray &tokens);
+
+    mutable QMutex m_mutex;
+    int m_readFd;
+    int m_writeFd;
+    int m_tokenFd;
+    bool m_isClient;
+    bool m_implicitTokenTaken;
+    int m_tokenCount;
+    int m_heldCountedTokens;
+    QByteArray m_heldPipeTokens;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_JOBSERVER_H
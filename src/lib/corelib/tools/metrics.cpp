@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "metrics.h"
+#include "metrics_p.h"
+
+#include <logging/translator.h>
+
+#include <QStringList>
+
+/*!
+ * \class Metrics
+ * \brief The \c Metrics class holds timing and counting data collected while a job was running.
+ * The data is split into per-phase durations, plain event counters and duration histograms.
+ * It is available from \c AbstractJob::metrics() once a job has finished.
+ * Phases can contain each other; for instance, module loading includes the parsing of module
+ * files. Commands run in parallel, so the command execution phase can take longer in total
+ * than the build itself.
+ */
+
+namespace qbs {
+
+Metrics::Metrics() : d(new Internal::MetricsData)
+{
+}
+
+Metrics::Metrics(const Metrics &other) : d(other.d)
+{
+}
+
+Metrics &Metrics::operator=(const Metrics &other)
+{
+    d = other.d;
+    return *this;
+}
+
+Metrics::~Metrics()
+{
+}
+
+/*!
+ * \brief Returns true iff no data at all has been recorded.
+ */
+bool Metrics::isEmpty() const
+{
+    for (int i = 0; i < PhaseCount; ++i) {
+        if (d->phaseOccurrences[i] > 0)
+            return false;
+    }
+    for (int i = 0; i < CounterCount; ++i) {
+        if (d->counters[i] > 0)
+            return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Returns the accumulated time in nanoseconds that was spent in the given phase.
+ */
+qint64 Metrics::phaseDuration(Phase phase) const
+{
+    return d->phaseDurations[phase];
+}
+
+/*!
+ * \brief Returns the number of times the given phase was entered.
+ */
+int Metrics::phaseOccurrences(Phase phase) const
+{
+    return d->phaseOccurrences[phase];
+}
+
+/*!
+ * \brief Returns the value of the given counter.
+ */
+qint64 Metrics::counterValue(Counter counter) const
+{
+    return d->counters[counter];
+}
+
+/*!
+ * \brief Returns the buckets of the given histogram.
+ * The list always has \c HistogramBucketCount entries. The entry at index \c i holds the
+ * number of samples that were shorter than \c bucketUpperBound(i), but not shorter than
+ * the upper bound of the preceding bucket.
+ */
+QList<qint64> Metrics::histogramBuckets(Histogram histogram) const
+{
+    QList<qint64> buckets;
+    for (int i = 0; i < HistogramBucketCount; ++i)
+        buckets << d->histograms[histogram][i];
+    return buckets;
+}
+
+static QString formatDuration(qint64 nsecs)
+{
+    return Internal::Tr::tr("%1 ms").arg(QString::number(nsecs / 1000000.0, 'f', 3));
+}
+
+/*!
+ * \brief Returns a human-readable report of all non-empty entries.
+ */
+QString Metrics::toString() const
+{
+    QStringList lines;
+    const QString indent = QLatin1String("  ");
+    for (int i = 0; i < PhaseCount; ++i) {
+        const Phase phase = static_cast<Phase>(i);
+        if (phaseOccurrences(phase) == 0)
+            continue;
+        lines << indent + Internal::Tr::tr("%1: %2 (%n time(s))", 0, phaseOccurrences(phase))
+                 .arg(phaseName(phase), formatDuration(phaseDuration(phase)));
+    }
+    for (int i = 0; i < CounterCount; ++i) {
+        const Counter counter = static_cast<Counter>(i);
+        if (counterValue(counter) == 0)
+            continue;
+        lines << indent + Internal::Tr::tr("%1: %2").arg(counterName(counter))
+                 .arg(counterValue(counter));
+    }
+    for (int i = 0; i < HistogramCount; ++i) {
+        const Histogram histogram = static_cast<Histogram>(i);
+        const QList<qint64> buckets = histogramBuckets(histogram);
+        QStringList entries;
+        for (int j = 0; j < buckets.count(); ++j) {
+            if (buckets.at(j) == 0)
+                continue;
+            const QString bound = j == HistogramBucketCount - 1
+                    ? Internal::Tr::tr("longer")
+                    : Internal::Tr::tr("< %1 us").arg(bucketUpperBound(j));
+            entries << Internal::Tr::tr("%1: %2").arg(bound).arg(buckets.at(j));
+        }
+        if (entries.isEmpty())
+            continue;
+        lines << indent + Internal::Tr::tr("%1: %2").arg(histogramName(histogram),
+                                                        entries.join(QLatin1String(", ")));
+    }
+    return lines.join(QLatin1String("\n"));
+}
+
+/*!
+ * \brief Returns a human-readable name for the given phase.
+ */
+QString Metrics::phaseName(Phase phase)
+{
+    switch (phase) {
+    case Parsing: return Internal::Tr::tr("Parsing");
+    case ModuleLoading: return Internal::Tr::tr("Module loading");
+    case ProbeExecution: return Internal::Tr::tr("Probe execution");
+    case PropertyEvaluation: return Internal::Tr::tr("Property evaluation");
+    case BuildGraphLoading: return Internal::Tr::tr("Build graph loading");
+    case BuildGraphStoring: return Internal::Tr::tr("Build graph storing");
+    case Scanning: return Internal::Tr::tr("Scanning");
+    case RuleApplication: return Internal::Tr::tr("Rule application");
+    case CommandExecution: return Internal::Tr::tr("Command execution");
+    case PhaseCount: break;
+    }
+    return QString();
+}
+
+/*!
+ * \brief Returns a human-readable name for the given counter.
+ */
+QString Metrics::counterName(Counter counter)
+{
+    switch (counter) {
+    case ParsedFiles: return Internal::Tr::tr("Parsed files");
+    case EvaluatedProperties: return Internal::Tr::tr("Evaluated properties");
+    case ExecutedProbes: return Internal::Tr::tr("Executed probes");
+    case ScannedFiles: return Internal::Tr::tr("Scanned files");
+    case AppliedRules: return Internal::Tr::tr("Applied rules");
+    case ExecutedCommands: return Internal::Tr::tr("Executed commands");
+    case CounterCount: break;
+    }
+    return QString();
+}
+
+/*!
+ * \brief Returns a human-readable name for the given histogram.
+ */
+QString Metrics::histogramName(Histogram histogram)
+{
+    switch (histogram) {
+    case CommandDuration: return Internal::Tr::tr("Command durations");
+    case ScanDuration: return Internal::Tr::tr("Scan durations");
+    case HistogramCount: break;
+    }
+    return QString();
+}
+
+/*!
+ * \brief Returns the exclusive upper bound in microseconds of the given histogram bucket.
+ * The buckets grow in powers of two, so that bucket \c i covers the range [2^(i-1), 2^i).
+ * The last bucket has no upper bound; -1 is returned for it.
+ */
+qint64 Metrics::bucketUpperBound(int bucket)
+{
+    if (bucket >= HistogramBucketCount - 1)
+        return -1;
+    return Q_INT64_C(1) << bucket;
+}
+
+} // namespace qbs
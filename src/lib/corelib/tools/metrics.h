@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_METRICS_H
+#define QBS_METRICS_H
+
+#include "qbs_export.h"
+
+#include <QExplicitlySharedDataPointer>
+#include <QList>
+#include <QString>
+
+namespace qbs {
+namespace Internal {
+class MetricsCollector;
+class MetricsData;
+}
+
+class QBS_EXPORT Metrics
+{
+    friend class Internal::MetricsCollector;
+public:
+    enum Phase {
+        Parsing,
+        ModuleLoading,
+        ProbeExecution,
+        PropertyEvaluation,
+        BuildGraphLoading,
+        BuildGraphStoring,
+        Scanning,
+        RuleApplication,
+        CommandExecution,
+        PhaseCount
+    };
+
+    enum Counter {
+        ParsedFiles,
+        EvaluatedProperties,
+        ExecutedProbes,
+        ScannedFiles,
+        AppliedRules,
+        ExecutedCommands,
+        CounterCount
+    };
+
+    enum Histogram {
+        CommandDuration,
+        ScanDuration,
+        HistogramCount
+    };
+
+    enum { HistogramBucketCount = 32 };
+
+    Metrics();
+    Metrics(const Metrics &other);
+    Metrics &operator=(const Metrics &other);
+    ~Metrics();
+
+    bool isEmpty() const;
+
+    qint64 phaseDuration(Phase phase) const;
+    int phaseOccurrences(Phase phase) const;
+    qint64 counterValue(Counter counter) const;
+    QList<qint64> histogramBuckets(Histogram histogram) const;
+
+    QString toString() const;
+
+    static QString phaseName(Phase phase);
+    static QString counterName(Counter counter);
+    static QString histogramName(Histogram histogram);
+    static qint64 bucketUpperBound(int bucket);
+
+private:
+    QExplicitlySharedDataPointer<Internal::MetricsData> d;
+};
+
+} // namespace qbs
+
+#endif // QBS_METRICS_H
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "metricscollector.h"
+
+#include <logging/logger.h>
+
+#include <QMutexLocker>
+#include <QThreadStorage>
+#include <QVector>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class MetricsCollector
+ * \brief The \c MetricsCollector class accumulates the data reported by a \c Metrics object.
+ * All functions are thread-safe. Callers in hot paths should accumulate locally and report
+ * the sum, rather than calling into the collector for every single event.
+ */
+
+MetricsCollector::MetricsCollector()
+{
+}
+
+void MetricsCollector::addPhaseDuration(Metrics::Phase phase, qint64 nsecs, int occurrences)
+{
+    QMutexLocker locker(&m_mutex);
+    m_data.phaseDurations[phase] += nsecs;
+    m_data.phaseOccurrences[phase] += occurrences;
+}
+
+void MetricsCollector::addToCounter(Metrics::Counter counter, qint64 value)
+{
+    QMutexLocker locker(&m_mutex);
+    m_data.counters[counter] += value;
+}
+
+void MetricsCollector::addHistogramSample(Metrics::Histogram histogram, qint64 nsecs)
+{
+    qint64 usecs = nsecs / 1000;
+    int bucket = 0;
+    while (usecs > 0 && bucket < Metrics::HistogramBucketCount - 1) {
+        usecs >>= 1;
+        ++bucket;
+    }
+    QMutexLocker locker(&m_mutex);
+    ++m_data.histograms[histogram][bucket];
+}
+
+/*!
+ * \brief Returns a snapshot of the data collected so far.
+ */
+Metrics MetricsCollector::metrics() const
+{
+    Metrics metrics;
+    QMutexLocker locker(&m_mutex);
+    metrics.d = new MetricsData(m_data);
+    return metrics;
+}
+
+
+static QThreadStorage<QVector<int> > phaseDepths;
+
+static int &phaseDepth(Metrics::Phase phase)
+{
+    QVector<int> &depths = phaseDepths.localData();
+    if (depths.isEmpty())
+        depths.resize(Metrics::PhaseCount);
+    return depths[phase];
+}
+
+/*!
+ * \class PhaseTimer
+ * \brief The \c PhaseTimer class reports the time of its own lifetime as a phase duration.
+ * If timers for the same phase are nested in one thread, only the outermost one reports,
+ * so that recursive code paths are not counted more than once.
+ * Nothing is recorded if the logger does not carry a collector.
+ */
+
+PhaseTimer::PhaseTimer(const Logger &logger, Metrics::Phase phase)
+    : m_collector(logger.metricsCollector()), m_phase(phase)
+{
+    m_timer.invalidate();
+    if (m_collector && phaseDepth(m_phase)++ == 0)
+        m_timer.start();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    if (!m_collector)
+        return;
+    --phaseDepth(m_phase);
+    if (m_timer.isValid())
+        m_collector->addPhaseDuration(m_phase, m_timer.nsecsElapsed());
+}
+
+} // namespace Internal
+} // namespace qbs
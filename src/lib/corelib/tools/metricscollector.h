@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_METRICSCOLLECTOR_H
+#define QBS_METRICSCOLLECTOR_H
+
+#include "metrics.h"
+#include "metrics_p.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSharedPointer>
+
+namespace qbs {
+namespace Internal {
+class Logger;
+
+class MetricsCollector
+{
+public:
+    MetricsCollector();
+
+    void addPhaseDuration(Metrics::Phase phase, qint64 nsecs, int occurrences = 1);
+    void addToCounter(Metrics::Counter counter, qint64 value = 1);
+    void addHistogramSample(Metrics::Histogram histogram, qint64 nsecs);
+
+    Metrics metrics() const;
+
+private:
+    mutable QMutex m_mutex;
+    MetricsData m_data;
+};
+
+typedef QSharedPointer<MetricsCollector> MetricsCollectorPtr;
+
+class PhaseTimer
+{
+public:
+    PhaseTimer(const Logger &logger, Metrics::Phase phase);
+    ~PhaseTimer();
+
+private:
+    MetricsCollectorPtr m_collector;
+    Metrics::Phase m_phase;
+    QElapsedTimer m_timer;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_METRICSCOLLECTOR_H
@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "nodetreedumpoptions.h"
+
+#include <QSharedData>
+
+namespace qbs {
+namespace Internal {
+
+class NodeTreeDumpOptionsPrivate : public QSharedData
+{
+public:
+    NodeTreeDumpOptionsPrivate() : format(NodeTreeDumpOptions::TreeFormat), maxDepth(-1)
+    { }
+
+    NodeTreeDumpOptions::Format format;
+    QStringList fileTags;
+    int maxDepth;
+};
+
+}
+
+/*!
+ * \class NodeTreeDumpOptions
+ * \brief The \c NodeTreeDumpOptions class comprises parameters that influence how the nodes
+ * of the build graph are dumped.
+ */
+
+/*!
+ * \enum NodeTreeDumpOptions::Format
+ * This enum type specifies the output format.
+ * \value TreeFormat An indented, human-readable tree. Nodes reachable via several paths
+ *        appear several times. The file tag and depth filters do not apply to this format.
+ * \value JsonLinesFormat One JSON object per line. Every node is described once, followed
+ *        by the edges to its children, which refer to nodes by id.
+ * \value BinaryFormat The same information as with \c JsonLinesFormat, serialized
+ *        via \c QDataStream.
+ */
+
+NodeTreeDumpOptions::NodeTreeDumpOptions() : d(new Internal::NodeTreeDumpOptionsPrivate)
+{
+}
+
+NodeTreeDumpOptions::NodeTreeDumpOptions(const NodeTreeDumpOptions &other) : d(other.d)
+{
+}
+
+NodeTreeDumpOptions &NodeTreeDumpOptions::operator=(const NodeTreeDumpOptions &other)
+{
+    d = other.d;
+    return *this;
+}
+
+NodeTreeDumpOptions::~NodeTreeDumpOptions()
+{
+}
+
+/*!
+ * \brief Returns the output format. The default is \c TreeFormat.
+ */
+NodeTreeDumpOptions::Format NodeTreeDumpOptions::format() const
+{
+    return d->format;
+}
+
+/*!
+ * \brief Sets the output format.
+ * \sa NodeTreeDumpOptions::Format
+ */
+void NodeTreeDumpOptions::setFormat(NodeTreeDumpOptions::Format format)
+{
+    d->format = format;
+}
+
+/*!
+ * \brief Returns the file tags that restrict the set of dumped nodes.
+ * The default is an empty list, which means that all nodes are dumped.
+ */
+QStringList NodeTreeDumpOptions::fileTags() const
+{
+    return d->fileTags;
+}
+
+/*!
+ * \brief Restricts the dump to artifacts with at least one of the given file tags and
+ * to rules producing such artifacts.
+ * Nodes that do not match are still traversed, but neither they nor their edges are emitted.
+ */
+void NodeTreeDumpOptions::setFileTags(const QStringList &fileTags)
+{
+    d->fileTags = fileTags;
+}
+
+/*!
+ * \brief Returns the maximum distance of dumped nodes from the products' root nodes.
+ * The default is -1, which means that the depth is not limited.
+ */
+int NodeTreeDumpOptions::maxDepth() const
+{
+    return d->maxDepth;
+}
+
+/*!
+ * \brief Limits the dump to nodes whose distance from the products' root nodes is at most
+ * \a maxDepth. The root nodes have a depth of zero. A negative value means no limit.
+ */
+void NodeTreeDumpOptions::setMaxDepth(int maxDepth)
+{
+    d->maxDepth = maxDepth;
+}
+
+} // namespace qbs
@@ -225,6 +225,24 @@ QStringList Profile::allKeysInternal(Profile::KeySelection selection,
     return keys;
 }
 
+// Inserts the values of this profile and its base profiles into \a values. Keys that are
+// already present take precedence, i.e. values from derived profiles win.
+void Profile::collectValues(QVariantMap &values, QStringList profileChain) const
+{
+    extendAndCheckProfileChain(profileChain);
+    foreach (const QString &key, m_settings->allKeysWithPrefix(profileKey())) {
+        if (key == baseProfileKey() || values.contains(key))
+            continue;
+        values.insert(key, localValue(key));
+    }
+    const QString baseProfileName = baseProfile();
+    if (baseProfileName.isEmpty())
+        return;
+    Profile parentProfile(baseProfileName, m_settings);
+    checkBaseProfileExistence(parentProfile);
+    parentProfile.collectValues(values, profileChain);
+}
+
 void Profile::extendAndCheckProfileChain(QStringList &chain) const
 {
     chain << m_name;
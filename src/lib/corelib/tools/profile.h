@@ -39,9 +39,11 @@
 namespace qbs {
 class ErrorInfo;
 class Settings;
+namespace Internal { class ProfileSnapshot; }
 
 class QBS_EXPORT Profile
 {
+    friend class Internal::ProfileSnapshot;
 public:
     explicit Profile(const QString &name, Settings *settings);
 
@@ -73,6 +75,7 @@ private:
     QVariant possiblyInheritedValue(const QString &key, const QVariant &defaultValue,
                                     QStringList profileChain) const;
     QStringList allKeysInternal(KeySelection selection, QStringList profileChain) const;
+    void collectValues(QVariantMap &values, QStringList profileChain) const;
     void extendAndCheckProfileChain(QStringList &chain) const;
 
     QString m_name;
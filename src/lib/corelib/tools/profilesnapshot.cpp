@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "profilesnapshot.h"
+
+#include "profile.h"
+#include "settings.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class ProfileSnapshot
+ * \brief The \c ProfileSnapshot class holds the values of a profile with everything inherited
+ * from its base profiles merged in.
+ * Snapshots are cached per settings directory and profile, so that reading a profile during
+ * project setup consists of hash lookups rather than walks of the base profile chain through
+ * \c QSettings. A cached snapshot is dropped when the settings file's size or timestamp changes
+ * or when this process modifies the settings.
+ */
+
+namespace {
+struct SettingsFileState
+{
+    SettingsFileState() : size(-1), lastModified(-1) { }
+    SettingsFileState(const QString &filePath)
+    {
+        const QFileInfo fi(filePath);
+        size = fi.exists() ? fi.size() : -1;
+        lastModified = fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+    }
+
+    bool operator==(const SettingsFileState &other) const
+    {
+        return size == other.size && lastModified == other.lastModified;
+    }
+
+    qint64 size;
+    qint64 lastModified;
+};
+
+struct CacheEntry
+{
+    CacheEntry() : snapshotTime(0) { }
+
+    // The file system may store the time stamp with a resolution of just one second, so
+    // a write in the same second as the snapshot can go unnoticed. Such a snapshot is not
+    // trusted, just like git treats "racily clean" index entries.
+    bool isUpToDate() const
+    {
+        return settingsFileState.lastModified / 1000 < snapshotTime / 1000
+                && SettingsFileState(settingsFilePath) == settingsFileState;
+    }
+
+    QString settingsFilePath;
+    SettingsFileState settingsFileState;
+    qint64 snapshotTime;
+    ProfileSnapshot snapshot;
+};
+
+struct SnapshotCache
+{
+    QMutex mutex;
+    QHash<QString, CacheEntry> entries;
+};
+} // anonymous namespace
+
+static SnapshotCache &snapshotCache()
+{
+    static SnapshotCache cache;
+    return cache;
+}
+
+/*!
+ * Returns the snapshot of the profile \a profileName in the settings at \a settingsBaseDir.
+ * Throws an \c ErrorInfo if the profile's base profile chain is broken.
+ */
+ProfileSnapshot ProfileSnapshot::get(const QString &settingsBaseDir, const QString &profileName)
+{
+    const QString cacheKey = settingsBaseDir + QLatin1Char('\n') + profileName;
+    SnapshotCache &cache = snapshotCache();
+    {
+        QMutexLocker locker(&cache.mutex);
+        const QHash<QString, CacheEntry>::ConstIterator it = cache.entries.constFind(cacheKey);
+        if (it != cache.entries.constEnd() && it->isUpToDate())
+            return it->snapshot;
+    }
+
+    Settings settings(settingsBaseDir);
+    CacheEntry entry;
+    entry.snapshotTime = QDateTime::currentMSecsSinceEpoch();
+    entry.settingsFilePath = settings.fileName();
+    entry.settingsFileState = SettingsFileState(entry.settingsFilePath);
+    Profile(profileName, &settings).collectValues(entry.snapshot.m_values, QStringList());
+
+    QMutexLocker locker(&cache.mutex);
+    cache.entries.insert(cacheKey, entry);
+    return entry.snapshot;
+}
+
+/*!
+ * Drops all cached snapshots. Called whenever this process writes to the settings, as such
+ * changes do not necessarily reach the settings file right away.
+ */
+void ProfileSnapshot::invalidateAll()
+{
+    SnapshotCache &cache = snapshotCache();
+    QMutexLocker locker(&cache.mutex);
+    cache.entries.clear();
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -32,6 +32,7 @@
 #include "qbsassert.h"
 
 #include <QQueue>
+#include <QSet>
 #include <QStringList>
 
 namespace qbs {
@@ -40,10 +41,11 @@ namespace Internal {
 QVariantList PropertyFinder::propertyValues(const QVariantMap &properties,
         const QString &moduleName, const QString &key, MergeType mergeType)
 {
-    m_moduleName = moduleName;
-    m_key = key;
+    QList<QVariantMap> moduleMaps;
+    collectModuleMaps(properties, moduleName, &moduleMaps);
     m_values.clear();
-    findModuleValues(properties);
+    foreach (const QVariantMap &moduleMap, moduleMaps)
+        addToList(moduleMap.value(key));
     if (mergeType == DoMergeLists)
         mergeLists(&m_values);
     return m_values;
@@ -52,55 +54,74 @@ QVariantList PropertyFinder::propertyValues(const QVariantMap &properties,
 QVariant PropertyFinder::propertyValue(const QVariantMap &properties, const QString &moduleName,
                                        const QString &key)
 {
-    m_moduleName = moduleName;
-    m_key = key;
-    m_values.clear();
-    findScalarModuleValue(properties);
+    QList<QVariantMap> moduleMaps;
+    QList<QStringList> ownProperties;
+    collectScalarModuleMaps(properties, moduleName, &moduleMaps, &ownProperties);
+    return scalarValue(moduleMaps, ownProperties, key);
+}
+
+void PropertyFinder::moduleValues(const QVariantMap &properties, const QString &moduleName,
+                                  QVariantMap *scalarValues, QVariantMap *listValues)
+{
+    QList<QVariantMap> moduleMaps;
+    collectModuleMaps(properties, moduleName, &moduleMaps);
+    QSet<QString> keys;
+    foreach (const QVariantMap &moduleMap, moduleMaps) {
+        for (QVariantMap::ConstIterator it = moduleMap.constBegin(); it != moduleMap.constEnd();
+             ++it) {
+            keys << it.key();
+        }
+    }
+    foreach (const QString &key, keys) {
+        m_values.clear();
+        foreach (const QVariantMap &moduleMap, moduleMaps)
+            addToList(moduleMap.value(key));
+        mergeLists(&m_values);
+        listValues->insert(key, m_values);
+    }
 
-    return m_values.isEmpty() ? QVariant() : m_values.first();
+    // Both traversals find the same module maps, just in a different order.
+    QList<QStringList> ownProperties;
+    moduleMaps.clear();
+    collectScalarModuleMaps(properties, moduleName, &moduleMaps, &ownProperties);
+    foreach (const QString &key, keys)
+        scalarValues->insert(key, scalarValue(moduleMaps, ownProperties, key));
 }
 
-void PropertyFinder::findModuleValues(const QVariantMap &properties)
+// Depth-first, with direct hits coming first.
+void PropertyFinder::collectModuleMaps(const QVariantMap &properties, const QString &moduleName,
+                                       QList<QVariantMap> *moduleMaps)
 {
     QVariantMap moduleProperties = properties.value(QLatin1String("modules")).toMap();
 
-    // Direct hits come first.
-    const QVariantMap::Iterator modIt = moduleProperties.find(m_moduleName);
+    const QVariantMap::Iterator modIt = moduleProperties.find(moduleName);
     if (modIt != moduleProperties.end()) {
-        const QVariantMap moduleMap = modIt->toMap();
-        const QVariant property = moduleMap.value(m_key);
-        addToList(property);
+        *moduleMaps << modIt->toMap();
         moduleProperties.erase(modIt);
     }
 
     // These are the non-matching modules.
     for (QVariantMap::ConstIterator it = moduleProperties.constBegin();
          it != moduleProperties.constEnd(); ++it) {
-        findModuleValues(it->toMap());
+        collectModuleMaps(it->toMap(), moduleName, moduleMaps);
     }
 }
 
-void PropertyFinder::findScalarModuleValue(const QVariantMap &properties)
+// Breadth-first, so that the values closest to the top level come first.
+void PropertyFinder::collectScalarModuleMaps(const QVariantMap &properties,
+        const QString &moduleName, QList<QVariantMap> *moduleMaps,
+        QList<QStringList> *ownProperties)
 {
     QQueue<QVariantMap> q;
     q.enqueue(properties.value(QLatin1String("modules")).toMap());
 
     while (!q.isEmpty()) {
         QVariantMap moduleProperties = q.takeFirst();
-        const QVariantMap::Iterator modIt = moduleProperties.find(m_moduleName);
+        const QVariantMap::Iterator modIt = moduleProperties.find(moduleName);
         if (modIt != moduleProperties.end()) {
-            const QVariantMap moduleMap = modIt->toMap();
-            const QVariant property = moduleMap.value(m_key);
-            const QStringList ownPropertiesSet
-                    = moduleProperties.value(QLatin1Char('@') + m_moduleName).toStringList();
-            if (std::binary_search(ownPropertiesSet.constBegin(), ownPropertiesSet.constEnd(),
-                                   m_key)) {
-                // this is the one!
-                m_values.clear();
-                addToList(property);
-                return;
-            }
-            addToList(property);
+            *moduleMaps << modIt->toMap();
+            *ownProperties
+                    << moduleProperties.value(QLatin1Char('@') + moduleName).toStringList();
             moduleProperties.erase(modIt);
         }
 
@@ -113,6 +134,21 @@ void PropertyFinder::findScalarModuleValue(const QVariantMap &properties)
     }
 }
 
+QVariant PropertyFinder::scalarValue(const QList<QVariantMap> &moduleMaps,
+        const QList<QStringList> &ownProperties, const QString &key)
+{
+    QVariant firstValue;
+    for (int i = 0; i < moduleMaps.count(); ++i) {
+        const QVariant property = moduleMaps.at(i).value(key);
+        const QStringList &ownPropertiesSet = ownProperties.at(i);
+        if (std::binary_search(ownPropertiesSet.constBegin(), ownPropertiesSet.constEnd(), key))
+            return property.isNull() ? QVariant() : property; // this is the one!
+        if (!firstValue.isValid() && !property.isNull())
+            firstValue = property;
+    }
+    return firstValue;
+}
+
 void PropertyFinder::addToList(const QVariant &value)
 {
     if (!value.isNull() && !m_values.contains(value))
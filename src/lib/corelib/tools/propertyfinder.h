@@ -30,6 +30,8 @@
 #ifndef QBS_PROPERTY_FINDER_H
 #define QBS_PROPERTY_FINDER_H
 
+#include <QList>
+#include <QStringList>
 #include <QVariantList>
 #include <QVariantMap>
 
@@ -47,14 +49,22 @@ public:
     QVariant propertyValue(const QVariantMap &properties, const QString &moduleName,
                          const QString &key);
 
+    // Determines the results of propertyValue() and propertyValues() for all properties
+    // of the given module at once.
+    void moduleValues(const QVariantMap &properties, const QString &moduleName,
+                      QVariantMap *scalarValues, QVariantMap *listValues);
+
 private:
-    void findModuleValues(const QVariantMap &properties);
-    void findScalarModuleValue(const QVariantMap &properties);
+    static void collectModuleMaps(const QVariantMap &properties, const QString &moduleName,
+                                  QList<QVariantMap> *moduleMaps);
+    static void collectScalarModuleMaps(const QVariantMap &properties, const QString &moduleName,
+                                        QList<QVariantMap> *moduleMaps,
+                                        QList<QStringList> *ownProperties);
+    static QVariant scalarValue(const QList<QVariantMap> &moduleMaps,
+                                const QList<QStringList> &ownProperties, const QString &key);
     void addToList(const QVariant &value);
     static void mergeLists(QVariantList *values);
 
-    QString m_moduleName;
-    QString m_key;
     QVariantList m_values;
 };
 
@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "propertypath.h"
+
+#include <QHash>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QThreadStorage>
+#include <QWriteLocker>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class PropertyPath
+ * \brief The \c PropertyPath class is a handle for a module property lookup.
+ * Handles are interned, so that each combination of module name, property name and lookup mode
+ * is represented by exactly one index. \c PropertyMapInternal uses that index to address the
+ * slot in its flattened property table that holds the result of the lookup.
+ * Obtaining a handle requires a hash lookup, so code on hot paths should get the handles it
+ * needs once, e.g. in a function-local static, and pass them around.
+ */
+
+namespace {
+struct RegistryKey
+{
+    RegistryKey(const QString &moduleName, const QString &propertyName, int mode)
+        : moduleName(moduleName), propertyName(propertyName), mode(mode) {}
+
+    bool operator==(const RegistryKey &other) const
+    {
+        return mode == other.mode && propertyName == other.propertyName
+                && moduleName == other.moduleName;
+    }
+
+    QString moduleName;
+    QString propertyName;
+    int mode;
+};
+
+inline uint qHash(const RegistryKey &key)
+{
+    return QT_PREPEND_NAMESPACE(qHash)(key.moduleName)
+            ^ (QT_PREPEND_NAMESPACE(qHash)(key.propertyName) << 1) ^ key.mode;
+}
+} // anonymous namespace
+
+static QReadWriteLock &registryLock()
+{
+    static QReadWriteLock lock;
+    return lock;
+}
+
+PropertyPath PropertyPath::get(const QString &moduleName, const QString &propertyName,
+                               LookupMode mode)
+{
+    // The data objects are never deleted, so the handles stay valid for the life time
+    // of the process. Every thread has its own copy of the entries it has used already,
+    // so that it only has to take the global lock when it encounters a path for the first time.
+    typedef QHash<RegistryKey, const Data *> Registry;
+    static Registry registry;
+    static QThreadStorage<Registry *> threadRegistries;
+
+    const RegistryKey key(moduleName, propertyName, mode);
+    if (!threadRegistries.hasLocalData())
+        threadRegistries.setLocalData(new Registry);
+    const Data *&threadData = (*threadRegistries.localData())[key];
+    if (threadData)
+        return PropertyPath(threadData);
+
+    {
+        QReadLocker locker(&registryLock());
+        threadData = registry.value(key);
+        if (threadData)
+            return PropertyPath(threadData);
+    }
+
+    QWriteLocker locker(&registryLock());
+    const Data *&data = registry[key];
+    if (!data) {
+        Data * const newData = new Data;
+        newData->index = registry.count() - 1;
+        newData->moduleName = moduleName;
+        newData->propertyName = propertyName;
+        newData->mode = mode;
+        data = newData;
+    }
+    threadData = data;
+    return PropertyPath(data);
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#ifndef QBS_PROPERTYPATH_H
+#define QBS_PROPERTYPATH_H
+
+#include <QString>
+
+namespace qbs {
+namespace Internal {
+
+class PropertyPath
+{
+public:
+    enum LookupMode { ScalarValue, MergedListValue };
+
+    PropertyPath() : m_data(0) {}
+
+    static PropertyPath get(const QString &moduleName, const QString &propertyName,
+                            LookupMode mode = ScalarValue);
+
+    bool isValid() const { return m_data; }
+    int index() const { return m_data->index; }
+    const QString &moduleName() const { return m_data->moduleName; }
+    const QString &propertyName() const { return m_data->propertyName; }
+    LookupMode lookupMode() const { return m_data->mode; }
+
+    bool operator==(const PropertyPath &other) const { return m_data == other.m_data; }
+    bool operator!=(const PropertyPath &other) const { return m_data != other.m_data; }
+
+private:
+    struct Data
+    {
+        int index;
+        QString moduleName;
+        QString propertyName;
+        LookupMode mode;
+    };
+
+    PropertyPath(const Data *data) : m_data(data) {}
+
+    const Data *m_data;
+};
+
+inline uint qHash(const PropertyPath &path) { return path.isValid() ? path.index() + 1 : 0; }
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
@@ -64,6 +64,15 @@ QList<ScannerPlugin *> ScannerPluginManager::scannersForFileTag(const FileTag &f
     return instance()->m_scannerPlugins.value(fileTag);
 }
 
+/*!
+ * Returns the version 2 interface of the given scanner, or null if its plugin only
+ * implements version 1.
+ */
+ScannerPluginV2 *ScannerPluginManager::batchScanner(const ScannerPlugin *plugin)
+{
+    return instance()->m_batchScanners.value(plugin);
+}
+
 void ScannerPluginManager::loadPlugins(const QStringList &pluginPaths, const Logger &logger)
 {
     QStringList filters;
@@ -107,6 +116,20 @@ void ScannerPluginManager::loadPlugins(const QStringList &pluginPaths, const Log
 
             for (int i = 0; plugins[i] != 0; ++i)
                 m_scannerPlugins[FileTag(plugins[i]->fileTag)] += plugins[i];
+
+            getScannersV2_f getScannersV2
+                    = reinterpret_cast<getScannersV2_f>(lib->resolve("getScannersV2"));
+            ScannerPluginV2 **pluginsV2 = getScannersV2 ? getScannersV2() : 0;
+            for (int i = 0; pluginsV2 && pluginsV2[i] != 0; ++i) {
+                ScannerPluginV2 * const pluginV2 = pluginsV2[i];
+                if (pluginV2->abiVersion != SC_SCANNER_ABI_VERSION_2 || !pluginV2->plugin
+                        || !pluginV2->scanBatch || !pluginV2->freeBatch) {
+                    logger.qbsWarning() << Tr::tr("Pluginmanager: Ignoring invalid batch "
+                            "scanner in '%1'.").arg(QDir::toNativeSeparators(fileName));
+                    continue;
+                }
+                m_batchScanners.insert(pluginV2->plugin, pluginV2);
+            }
             m_libs.append(lib.take());
         }
     }
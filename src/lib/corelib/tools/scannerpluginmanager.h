@@ -51,6 +51,7 @@ public:
     ~ScannerPluginManager();
     static ScannerPluginManager *instance();
     static QList<ScannerPlugin *> scannersForFileTag(const FileTag &fileTag);
+    static ScannerPluginV2 *batchScanner(const ScannerPlugin *plugin);
     void loadPlugins(const QStringList &paths, const Logger &logger);
 
 private:
@@ -59,6 +60,7 @@ private:
 private:
     QList<QLibrary *> m_libs;
     QHash<FileTag, QList<ScannerPlugin*> > m_scannerPlugins;
+    QHash<const ScannerPlugin *, ScannerPluginV2 *> m_batchScanners;
 };
 
 } // namespace Internal
@@ -31,6 +31,7 @@
 #include "settings.h"
 
 #include "error.h"
+#include "profilesnapshot.h"
 #include <logging/translator.h>
 #include <tools/hostosinfo.h>
 
@@ -101,16 +102,19 @@ QStringList Settings::allKeysWithPrefix(const QString &group) const
 void Settings::setValue(const QString &key, const QVariant &value)
 {
     m_settings->setValue(internalRepresentation(key), value);
+    ProfileSnapshot::invalidateAll();
 }
 
 void Settings::remove(const QString &key)
 {
     m_settings->remove(internalRepresentation(key));
+    ProfileSnapshot::invalidateAll();
 }
 
 void Settings::clear()
 {
     m_settings->clear();
+    ProfileSnapshot::invalidateAll();
 }
 
 void Settings::sync()
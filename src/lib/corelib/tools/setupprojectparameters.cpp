@@ -31,10 +31,9 @@
 
 #include <logging/translator.h>
 #include <tools/installoptions.h>
-#include <tools/profile.h>
+#include <tools/profilesnapshot.h>
 #include <tools/qbsassert.h>
 #include <tools/scripttools.h>
-#include <tools/settings.h>
 
 namespace qbs {
 namespace Internal {
@@ -293,23 +292,13 @@ QVariantMap SetupProjectParameters::buildConfigurationTree() const
 static QVariantMap expandedBuildConfigurationInternal(const QString &settingsBaseDir,
         const QString &profileName, const QString &buildVariant)
 {
-    Settings settings(settingsBaseDir);
     QVariantMap buildConfig;
 
     // (1) Values from profile, if given.
     if (!profileName.isEmpty()) {
-        ErrorInfo err;
-        const Profile profile(profileName, &settings);
-        const QStringList profileKeys = profile.allKeys(Profile::KeySelectionRecursive, &err);
-        if (err.hasError())
-            throw err;
-        if (profileKeys.isEmpty())
+        buildConfig = ProfileSnapshot::get(settingsBaseDir, profileName).values();
+        if (buildConfig.isEmpty())
             throw ErrorInfo(Internal::Tr::tr("Unknown or empty profile '%1'.").arg(profileName));
-        foreach (const QString &profileKey, profileKeys) {
-            buildConfig.insert(profileKey, profile.value(profileKey, QVariant(), &err));
-                if (err.hasError())
-                    throw err;
-        }
     }
 
     // (2) Build Variant.
@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#include "stringtable.h"
+
+#include "qbsassert.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class StringTable
+ * \brief The \c StringTable class interns strings, so that they can be compared and hashed
+ * as integers. Ids are never reused and stay valid for the lifetime of the table.
+ * Mapping an id back to its string does not take the lock, as that happens on hot paths
+ * such as \c FileResourceBase::dirPath(). The strings live in chunks that are never moved
+ * or freed while the table exists, and the number of valid ids is published only after the
+ * string has been stored.
+ */
+
+StringTable::StringTable() : m_count(0)
+{
+}
+
+StringTable::~StringTable()
+{
+    for (int i = 0; i < MaxChunkCount; ++i)
+        delete[] m_chunks[i].load();
+}
+
+int StringTable::id(const QString &str)
+{
+    {
+        QReadLocker locker(&m_lock);
+        const int id = m_ids.value(str, InvalidId);
+        if (id != InvalidId)
+            return id;
+    }
+    QWriteLocker locker(&m_lock);
+    int &id = m_ids[str];
+    const int count = m_count.load();
+    if (count < m_ids.count()) {
+        int chunk;
+        int offset;
+        locate(count, &chunk, &offset);
+        QString *strings = m_chunks[chunk].load();
+        if (!strings) {
+            strings = new QString[FirstChunkSize << chunk];
+            m_chunks[chunk].storeRelease(strings);
+        }
+        strings[offset] = str;
+        id = count;
+        m_count.storeRelease(count + 1);
+    }
+    return id;
+}
+
+int StringTable::find(const QString &str) const
+{
+    QReadLocker locker(&m_lock);
+    return m_ids.value(str, InvalidId);
+}
+
+QString StringTable::string(int id) const
+{
+    if (id == InvalidId)
+        return QString();
+    QBS_CHECK(id >= 0 && id < m_count.loadAcquire());
+    int chunk;
+    int offset;
+    locate(id, &chunk, &offset);
+    return m_chunks[chunk].loadAcquire()[offset];
+}
+
+void StringTable::locate(int id, int *chunk, int *offset)
+{
+    int chunkStart = 0;
+    int chunkSize = FirstChunkSize;
+    int n = 0;
+    while (id - chunkStart >= chunkSize) {
+        chunkStart += chunkSize;
+        chunkSize <<= 1;
+        ++n;
+    }
+    QBS_CHECK(n < MaxChunkCount);
+    *chunk = n;
+    *offset = id - chunkStart;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+
+#ifndef QBS_STRINGTABLE_H
+#define QBS_STRINGTABLE_H
+
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+namespace qbs {
+namespace Internal {
+
+// Thread-safe table assigning small, stable integer ids to strings.
+class StringTable
+{
+public:
+    enum { InvalidId = -1 };
+
+    StringTable();
+    ~StringTable();
+
+    int id(const QString &str);
+    int find(const QString &str) const;
+    QString string(int id) const;
+
+private:
+    // Chunk n holds FirstChunkSize << n strings. Chunks never move once allocated.
+    enum { FirstChunkSize = 64, MaxChunkCount = 25 };
+    static void locate(int id, int *chunk, int *offset);
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, int> m_ids;
+    QAtomicPointer<QString> m_chunks[MaxChunkCount];
+    QAtomicInt m_count;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_STRINGTABLE_H
@@ -7,12 +7,19 @@ HEADERS += \
     $$PWD/buildgraphlocker.h \
     $$PWD/codelocation.h \
     $$PWD/commandechomode.h \
+    $$PWD/directorylistingcache.h \
+    $$PWD/directorysnapshot.h \
     $$PWD/error.h \
     $$PWD/executablefinder.h \
     $$PWD/fileinfo.h \
     $$PWD/filetime.h \
     $$PWD/generateoptions.h \
     $$PWD/id.h \
+    $$PWD/jobserver.h \
+    $$PWD/metrics.h \
+    $$PWD/metrics_p.h \
+    $$PWD/metricscollector.h \
+    $$PWD/nodetreedumpoptions.h \
     $$PWD/persistence.h \
     $$PWD/scannerpluginmanager.h \
     $$PWD/scripttools.h \
@@ -23,10 +30,13 @@ HEADERS += \
     $$PWD/processresult.h \
     $$PWD/processresult_p.h \
     $$PWD/processutils.h \
+    $$PWD/profilesnapshot.h \
     $$PWD/progressobserver.h \
     $$PWD/projectgeneratormanager.h \
     $$PWD/propertyfinder.h \
+    $$PWD/propertypath.h \
     $$PWD/shellutils.h \
+    $$PWD/stringtable.h \
     $$PWD/hostosinfo.h \
     $$PWD/buildoptions.h \
     $$PWD/installoptions.h \
@@ -44,11 +54,17 @@ SOURCES += \
     $$PWD/buildgraphlocker.cpp \
     $$PWD/codelocation.cpp \
     $$PWD/commandechomode.cpp \
+    $$PWD/directorylistingcache.cpp \
+    $$PWD/directorysnapshot.cpp \
     $$PWD/error.cpp \
     $$PWD/executablefinder.cpp \
     $$PWD/fileinfo.cpp \
     $$PWD/generateoptions.cpp \
     $$PWD/id.cpp \
+    $$PWD/jobserver.cpp \
+    $$PWD/metrics.cpp \
+    $$PWD/metricscollector.cpp \
+    $$PWD/nodetreedumpoptions.cpp \
     $$PWD/persistence.cpp \
     $$PWD/scannerpluginmanager.cpp \
     $$PWD/scripttools.cpp \
@@ -58,10 +74,13 @@ SOURCES += \
     $$PWD/processresult.cpp \
     $$PWD/processutils.cpp \
     $$PWD/profile.cpp \
+    $$PWD/profilesnapshot.cpp \
     $$PWD/progressobserver.cpp \
     $$PWD/projectgeneratormanager.cpp \
     $$PWD/propertyfinder.cpp \
+    $$PWD/propertypath.cpp \
     $$PWD/shellutils.cpp \
+    $$PWD/stringtable.cpp \
     $$PWD/buildoptions.cpp \
     $$PWD/installoptions.cpp \
     $$PWD/cleanoptions.cpp \
@@ -90,6 +109,8 @@ qbs_enable_unit_tests {
         $$PWD/codelocation.h \
         $$PWD/commandechomode.h \
         $$PWD/error.h \
+        $$PWD/metrics.h \
+        $$PWD/nodetreedumpoptions.h \
         $$PWD/settings.h \
         $$PWD/settingsmodel.h \
         $$PWD/preferences.h \
@@ -33,18 +33,34 @@
 #include "tst_tools.h"
 
 #include "buildoptions.h"
+#include "directorylistingcache.h"
+#include "directorysnapshot.h"
 #include "error.h"
 #include "fileinfo.h"
 #include "hostosinfo.h"
+#include "jobserver.h"
+#include "metricscollector.h"
 #include "processutils.h"
 #include "profile.h"
+#include "profilesnapshot.h"
 #include "settings.h"
 #include "setupprojectparameters.h"
+#include "stringtable.h"
 
+#include <logging/logger.h>
+
+#include <QDir>
 #include <QFileInfo>
+#include <QProcessEnvironment>
+#include <QSettings>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QTest>
 
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#endif
+
 namespace qbs {
 namespace Internal {
 
@@ -73,6 +89,121 @@ void TestTools::testFileInfo()
     QCOMPARE(FileInfo("/does/not/exist").lastModified(), FileTime());
 }
 
+void TestTools::testDirectoryListingCache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    DirectoryListingCache * const cache = DirectoryListingCache::instance();
+    cache->startNewGeneration();
+    QVERIFY(!cache->fileExists(tempDir.path(), "file.h"));
+    QVERIFY(!cache->fileExists(tempDir.path() + "/nosuchdir", "file.h"));
+
+    QFile file(tempDir.path() + "/file.h");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    // The listing is not re-validated within a generation.
+    QVERIFY(!cache->fileExists(tempDir.path(), "file.h"));
+    cache->startNewGeneration();
+    QVERIFY(cache->fileExists(tempDir.path(), "file.h"));
+    QVERIFY(!cache->fileExists(tempDir.path(), "other.h"));
+}
+
+void TestTools::testDirectorySnapshot()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(QDir(tempDir.path()).mkdir("subdir"));
+    QFile file(tempDir.path() + "/file.cpp");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    DirectorySnapshot snapshot;
+    const DirectorySnapshot::Listing listing = snapshot.listing(tempDir.path() + "/subdir/..");
+    QVERIFY(listing.exists);
+    QCOMPARE(listing.entries.count(), 2);
+    QVERIFY(listing.containsEntry("file.cpp"));
+    QVERIFY(listing.containsEntry("subdir"));
+    QVERIFY(!listing.containsEntry("other.cpp"));
+    foreach (const DirectorySnapshot::Entry &entry, listing.entries)
+        QCOMPARE(entry.isDir, entry.name == QLatin1String("subdir"));
+    QVERIFY(listing.dirTime == DirectorySnapshot::currentDirectoryTime(tempDir.path()));
+
+    // A snapshot does not pick up changes.
+    QFile otherFile(tempDir.path() + "/other.cpp");
+    QVERIFY(otherFile.open(QIODevice::WriteOnly));
+    otherFile.close();
+    QVERIFY(!snapshot.listing(tempDir.path()).containsEntry("other.cpp"));
+    QVERIFY(DirectorySnapshot().listing(tempDir.path()).containsEntry("other.cpp"));
+
+    const DirectorySnapshot::Listing missingListing = snapshot.listing(tempDir.path() + "/nope");
+    QVERIFY(!missingListing.exists);
+    QVERIFY(missingListing.isReliable);
+    QVERIFY(!DirectorySnapshot::currentDirectoryTime(tempDir.path() + "/nope").isValid());
+}
+
+void TestTools::testJobServer()
+{
+    JobServer server((QByteArray()));
+    QVERIFY(!server.isClient());
+    server.ensureTokenCount(2);
+    QVERIFY(server.tryAcquireToken());
+    QVERIFY(server.tryAcquireToken());
+    QVERIFY(!server.tryAcquireToken());
+    server.releaseToken();
+    QVERIFY(server.tryAcquireToken());
+    QVERIFY(!server.tryAcquireToken());
+    server.ensureTokenCount(1); // Never shrinks.
+    server.ensureTokenCount(3);
+    QVERIFY(server.tryAcquireToken());
+    QVERIFY(!server.tryAcquireToken());
+    server.releaseToken();
+    server.releaseToken();
+    server.releaseToken();
+
+    QProcessEnvironment env;
+    env.insert("MAKEFLAGS", "k -j4 --jobserver-auth=98,99");
+    server.exportToEnvironment(env);
+    if (HostOsInfo::isAnyUnixHost()) {
+        const QString makeFlags = env.value("MAKEFLAGS");
+        QVERIFY(makeFlags.startsWith("k -j --jobserver-fds="));
+        QVERIFY(!makeFlags.contains("98,99"));
+
+        // A server that takes over the pipe shares the tokens.
+        const int fdsStart = makeFlags.indexOf("--jobserver-auth=");
+        JobServer client(makeFlags.mid(fdsStart).toLatin1());
+        QVERIFY(client.isClient());
+        QVERIFY(client.tokenNotificationFd() != -1);
+        QVERIFY(client.tryAcquireToken()); // The implicit one.
+        QVERIFY(client.tryAcquireToken());
+        QVERIFY(server.tryAcquireToken());
+        QVERIFY(client.tryAcquireToken());
+        QVERIFY(!server.tryAcquireToken());
+        QVERIFY(!client.tryAcquireToken());
+        client.releaseToken();
+        QVERIFY(server.tryAcquireToken());
+
+#if defined(Q_OS_UNIX)
+        // The pipe is shared with other processes, so its flags must stay as they were.
+        const int readFd = makeFlags.mid(fdsStart + 17).section(' ', 0, 0).section(',', 0, 0)
+                .toInt();
+        QVERIFY(!(::fcntl(readFd, F_GETFL) & O_NONBLOCK));
+
+        // Only commands that use the jobserver may inherit the pipe.
+        QCOMPARE(server.fileDescriptors().count(), 2);
+        foreach (const int fd, server.fileDescriptors())
+            QVERIFY(::fcntl(fd, F_GETFD) & FD_CLOEXEC);
+#endif
+        server.removeFromEnvironment(env);
+        QCOMPARE(env.value("MAKEFLAGS"), QString("k"));
+        env.insert("MAKEFLAGS", "-j4 --jobserver-auth=98,99");
+        server.removeFromEnvironment(env);
+        QVERIFY(!env.contains("MAKEFLAGS"));
+    } else {
+        QCOMPARE(env.value("MAKEFLAGS"), QString("k -j4 --jobserver-auth=98,99"));
+    }
+}
+
 void TestTools::fileCaseCheck()
 {
     QTemporaryFile tempFile(QLatin1String("CamelCase"));
@@ -132,6 +263,59 @@ void TestTools::testProfiles()
     QVERIFY(errorInfo.hasError());
 }
 
+void TestTools::testProfileSnapshot()
+{
+    Settings settings((QString()));
+    TemporaryProfile tpp("snapshotParent", &settings);
+    Profile parentProfile = tpp.p;
+    parentProfile.setValue("qbs.toolchain", "gcc");
+    parentProfile.setValue("qbs.architecture", "x86");
+    TemporaryProfile tpc("snapshotChild", &settings);
+    Profile childProfile = tpc.p;
+    childProfile.setValue("qbs.architecture", "arm");
+    childProfile.setBaseProfile(parentProfile.name());
+
+    ProfileSnapshot snapshot = ProfileSnapshot::get(QString(), childProfile.name());
+    QCOMPARE(snapshot.values().count(), 2);
+    QCOMPARE(snapshot.value("qbs.toolchain").toString(), QLatin1String("gcc"));
+    QCOMPARE(snapshot.value("qbs.architecture").toString(), QLatin1String("arm"));
+
+    // Changes made through the settings must not be hidden by the cache.
+    parentProfile.setValue("cpp.cxxLanguageVersion", "c++11");
+    snapshot = ProfileSnapshot::get(QString(), childProfile.name());
+    QCOMPARE(snapshot.values().count(), 3);
+    QCOMPARE(snapshot.value("cpp.cxxLanguageVersion").toString(), QLatin1String("c++11"));
+
+    parentProfile.setBaseProfile(childProfile.name());
+    bool exceptionCaught = false;
+    try {
+        ProfileSnapshot::get(QString(), childProfile.name());
+    } catch (const ErrorInfo &) {
+        exceptionCaught = true;
+    }
+    QVERIFY(exceptionCaught);
+    parentProfile.removeBaseProfile();
+
+    // Writes by other processes are noticed, even if they happen within the same second
+    // and do not change the size of the settings file.
+    QTemporaryDir settingsDir;
+    QVERIFY(settingsDir.isValid());
+    {
+        Settings otherSettings(settingsDir.path());
+        Profile(QLatin1String("external"), &otherSettings).setValue("qbs.toolchain", "gcc");
+    }
+    snapshot = ProfileSnapshot::get(settingsDir.path(), QLatin1String("external"));
+    QCOMPARE(snapshot.value("qbs.toolchain").toString(), QLatin1String("gcc"));
+    {
+        QSettings otherProcessSettings(settingsDir.path() + "/qbs.conf",
+                HostOsInfo::isWindowsHost() ? QSettings::IniFormat : QSettings::NativeFormat);
+        otherProcessSettings.setValue("org/qt-project/qbs/profiles/external/qbs/toolchain",
+                                      "icc");
+    }
+    snapshot = ProfileSnapshot::get(settingsDir.path(), QLatin1String("external"));
+    QCOMPARE(snapshot.value("qbs.toolchain").toString(), QLatin1String("icc"));
+}
+
 void TestTools::testBuildConfigMerging()
 {
     Settings settings((QString()));
@@ -174,5 +358,64 @@ void TestTools::testProcessNameByPid()
     QCOMPARE(qAppName(), processNameByPid(QCoreApplication::applicationPid()));
 }
 
+void TestTools::testMetrics()
+{
+    Logger logger;
+    {
+        PhaseTimer phaseTimer(logger, Metrics::Parsing); // No collector, must not crash.
+    }
+
+    const MetricsCollectorPtr collector(new MetricsCollector);
+    logger.setMetricsCollector(collector);
+    QVERIFY(collector->metrics().isEmpty());
+    {
+        PhaseTimer outerTimer(logger, Metrics::ModuleLoading);
+        PhaseTimer innerTimer(logger, Metrics::ModuleLoading);
+        PhaseTimer otherTimer(logger, Metrics::Parsing);
+    }
+    collector->addToCounter(Metrics::ParsedFiles);
+    collector->addToCounter(Metrics::ParsedFiles, 2);
+    collector->addHistogramSample(Metrics::CommandDuration, 500);
+    collector->addHistogramSample(Metrics::CommandDuration, 3000);
+    collector->addHistogramSample(Metrics::CommandDuration, 3999);
+
+    const Metrics metrics = collector->metrics();
+    QVERIFY(!metrics.isEmpty());
+    QCOMPARE(metrics.phaseOccurrences(Metrics::ModuleLoading), 1);
+    QCOMPARE(metrics.phaseOccurrences(Metrics::Parsing), 1);
+    QCOMPARE(metrics.phaseOccurrences(Metrics::CommandExecution), 0);
+    QCOMPARE(metrics.counterValue(Metrics::ParsedFiles), Q_INT64_C(3));
+    const QList<qint64> buckets = metrics.histogramBuckets(Metrics::CommandDuration);
+    QCOMPARE(buckets.count(), int(Metrics::HistogramBucketCount));
+    QCOMPARE(buckets.at(0), Q_INT64_C(1));
+    QCOMPARE(buckets.at(2), Q_INT64_C(2));
+    QCOMPARE(Metrics::bucketUpperBound(2), Q_INT64_C(4));
+    QVERIFY(metrics.toString().contains(Metrics::counterName(Metrics::ParsedFiles)));
+
+    // The returned object is a snapshot.
+    collector->addToCounter(Metrics::ParsedFiles);
+    QCOMPARE(metrics.counterValue(Metrics::ParsedFiles), Q_INT64_C(3));
+    QCOMPARE(collector->metrics().counterValue(Metrics::ParsedFiles), Q_INT64_C(4));
+}
+
+void TestTools::testStringTable()
+{
+    StringTable table;
+    QCOMPARE(table.find("a"), int(StringTable::InvalidId));
+    QVERIFY(table.string(StringTable::InvalidId).isNull());
+
+    // Enough strings to fill several chunks.
+    QList<int> ids;
+    for (int i = 0; i < 1000; ++i)
+        ids << table.id(QString::number(i));
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(ids.at(i), i);
+        QCOMPARE(table.id(QString::number(i)), i);
+        QCOMPARE(table.find(QString::number(i)), i);
+        QCOMPARE(table.string(i), QString::number(i));
+    }
+    QCOMPARE(table.find("a"), int(StringTable::InvalidId));
+}
+
 } // namespace Internal
 } // namespace qbs
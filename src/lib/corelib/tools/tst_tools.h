@@ -45,10 +45,16 @@ public:
 
 private slots:
     void testFileInfo();
+    void testDirectoryListingCache();
+    void testDirectorySnapshot();
+    void testJobServer();
     void fileCaseCheck();
     void testProfiles();
+    void testProfileSnapshot();
     void testBuildConfigMerging();
     void testProcessNameByPid();
+    void testMetrics();
+    void testStringTable();
 
 private:
     Settings * const m_settings;
@@ -40,15 +40,15 @@ using namespace CPlusPlus;
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
-#else
-#include <QtCore/QFile>
 #endif
 
 #include <QtCore/QByteArray>
+#include <QtCore/QFile>
 #include <QtCore/QList>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QString>
 #include <QtCore/QLatin1Literal>
+#include <QtCore/QVector>
 
 struct ScanResult
 {
@@ -184,17 +184,15 @@ static void scanCppFile(void *opaq, Lexer &yylex, bool scanForFileTags, bool sca
     }
 }
 
-static Opaq *openScanner(const unsigned short *filePath, Opaq::FileType fileType, int flags)
+static Opaq *openScanner(const QString &filePath, Opaq::FileType fileType, int flags)
 {
     QScopedPointer<Opaq> opaque(new Opaq);
-    opaque->fileName = QString::fromUtf16(filePath);
+    opaque->fileName = filePath;
     opaque->fileType = fileType;
 
     size_t mapl = 0;
 #ifdef Q_OS_UNIX
-    QString filePathS = opaque->fileName;
-
-    opaque->fd = open(qPrintable(filePathS), O_RDONLY);
+    opaque->fd = open(QFile::encodeName(filePath).constData(), O_RDONLY);
     if (opaque->fd == -1) {
         opaque->fd = 0;
         return 0;
@@ -230,7 +228,51 @@ static Opaq *openScanner(const unsigned short *filePath, Opaq::FileType fileType
 template <typename Opaq::FileType t>
 static void *openScannerT(const unsigned short *filePath, int flags)
 {
-    return openScanner(filePath, t, flags);
+    return openScanner(QString::fromUtf16(filePath), t, flags);
+}
+
+struct BatchResult
+{
+    QByteArray buffer;
+    QVector<ScanDependency> dependencies;
+    QVector<int> fileOffsets;
+    QByteArray fileScanned;
+};
+
+template <typename Opaq::FileType t>
+static void *scanBatchT(const char * const *filePaths, int fileCount, int flags,
+                        ScanBatchResult *result)
+{
+    BatchResult * const batch = new BatchResult;
+    batch->fileOffsets.reserve(fileCount + 1);
+    batch->fileScanned.fill(0, fileCount);
+    for (int i = 0; i < fileCount; ++i) {
+        batch->fileOffsets << batch->dependencies.count();
+        const QScopedPointer<Opaq> opaque(openScanner(QString::fromUtf8(filePaths[i]), t, flags));
+        if (!opaque)
+            continue;
+        batch->fileScanned[i] = 1;
+        foreach (const ScanResult &include, opaque->includedFiles) {
+            ScanDependency dependency;
+            dependency.offset = batch->buffer.size();
+            dependency.size = include.size;
+            dependency.flags = include.flags;
+            batch->buffer.append(include.fileName, include.size);
+            batch->dependencies << dependency;
+        }
+    }
+    batch->fileOffsets << batch->dependencies.count();
+
+    result->buffer = batch->buffer.constData();
+    result->dependencies = batch->dependencies.constData();
+    result->fileOffsets = batch->fileOffsets.constData();
+    result->fileScanned = batch->fileScanned.constData();
+    return batch;
+}
+
+static void freeBatch(void *batchHandle)
+{
+    delete static_cast<BatchResult *>(batchHandle);
 }
 
 static void closeScanner(void *ptr)
@@ -351,4 +393,25 @@ CPPSCANNER_EXPORT ScannerPlugin **getScanners()
     return theScanners;
 }
 
+ScannerPluginV2 hppScannerV2 = { SC_SCANNER_ABI_VERSION_2, &hppScanner,
+                                 scanBatchT<Opaq::FT_HPP>, freeBatch };
+ScannerPluginV2 cppScannerV2 = { SC_SCANNER_ABI_VERSION_2, &cppScanner,
+                                 scanBatchT<Opaq::FT_CPP>, freeBatch };
+ScannerPluginV2 cScannerV2 = { SC_SCANNER_ABI_VERSION_2, &cScanner,
+                               scanBatchT<Opaq::FT_C>, freeBatch };
+ScannerPluginV2 objcppScannerV2 = { SC_SCANNER_ABI_VERSION_2, &objcppScanner,
+                                    scanBatchT<Opaq::FT_OBJCPP>, freeBatch };
+ScannerPluginV2 objcScannerV2 = { SC_SCANNER_ABI_VERSION_2, &objcScanner,
+                                  scanBatchT<Opaq::FT_OBJC>, freeBatch };
+ScannerPluginV2 rcScannerV2 = { SC_SCANNER_ABI_VERSION_2, &rcScanner,
+                                scanBatchT<Opaq::FT_RC>, freeBatch };
+
+ScannerPluginV2 *theScannersV2[] = {&hppScannerV2, &cppScannerV2, &cScannerV2, &objcppScannerV2,
+                                    &objcScannerV2, &rcScannerV2, NULL};
+
+CPPSCANNER_EXPORT ScannerPluginV2 **getScannersV2()
+{
+    return theScannersV2;
+}
+
 } // extern "C"
@@ -92,6 +92,67 @@ public:
 
 typedef ScannerPlugin **(*getScanners_f)();
 
+/*
+ * Version 2 of the scanner interface adds batch scanning of dependencies.
+ * A plugin supporting it exports getScannersV2() in addition to getScanners().
+ * For plugins that do not, qbs falls back to the open/next/close functions.
+ */
+#define SC_SCANNER_ABI_VERSION_2 2
+
+/**
+  * A dependency found by scanBatch_f.
+  * The file name is located in ScanBatchResult::buffer at the given offset.
+  * It is encoded like the results of scanNext_f, i.e. in the local 8-bit encoding,
+  * and not null-terminated.
+  */
+struct ScanDependency
+{
+    int offset;
+    int size;
+    int flags;
+};
+
+/**
+  * The results of a batch scan.
+  * fileOffsets has one entry more than the number of scanned files. The dependencies
+  * of the i-th file are dependencies[fileOffsets[i]] up to, but not including,
+  * dependencies[fileOffsets[i + 1]]. fileScanned has one entry per file, which is zero
+  * if the file could not be read; such files have no dependencies.
+  * The memory is owned by the plugin and stays valid until scanBatchFree_f is called.
+  */
+struct ScanBatchResult
+{
+    const char *buffer;
+    const ScanDependency *dependencies;
+    const int *fileOffsets;
+    const char *fileScanned;
+};
+
+/**
+  * Scans the given files for dependencies.
+  * The file paths are UTF-8 encoded and null-terminated.
+  *
+  * Returns a handle to be passed to scanBatchFree_f, or null if scanning failed.
+  */
+typedef void *(*scanBatch_f)(const char * const *filePaths, int fileCount, int flags,
+                             ScanBatchResult *result);
+
+/**
+  * Releases the results of a batch scan.
+  */
+typedef void (*scanBatchFree_f)(void *batchHandle);
+
+class ScannerPluginV2
+{
+public:
+    int abiVersion; // SC_SCANNER_ABI_VERSION_2
+    ScannerPlugin *plugin; // The entry in the list returned by getScanners().
+    scanBatch_f scanBatch;
+    scanBatchFree_f freeBatch;
+};
+
+typedef ScannerPluginV2 **(*getScannersV2_f)();
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,14 @@
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    for (int i = 0; i < 5000; ++i) {
+        std::printf("stdout line %d\n", i);
+        std::fprintf(stderr, "stderr line %d\n", i);
+    }
+    if (argc > 1) {
+        if (FILE * const f = std::fopen(argv[1], "w"))
+            std::fclose(f);
+    }
+    return 0;
+}
@@ -36,14 +36,19 @@
 #include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
 
+#include <QBuffer>
 #include <QCoreApplication>
 #include <QDir>
 #include <QEventLoop>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QScopedPointer>
+#include <QSet>
 #include <QStringList>
 #include <QTest>
+#include <QThread>
 #include <QTimer>
 
 #define VERIFY_NO_ERROR(errorInfo) \
@@ -79,12 +84,20 @@ class ProcessResultReceiver : public QObject
     Q_OBJECT
 public:
     QString output;
+    QStringList reportedStdOut;
+    QStringList reportedStdErr;
 
 private slots:
     void handleProcessResult(const qbs::ProcessResult &result) {
         output += result.stdErr().join(QLatin1Char('\n'));
         output += result.stdOut().join(QLatin1Char('\n'));
     }
+
+    void handleProcessOutput(const QString &, const QString &, const QStringList &stdOut,
+                             const QStringList &stdErr) {
+        reportedStdOut += stdOut;
+        reportedStdErr += stdErr;
+    }
 };
 
 class TaskReceiver : public QObject
@@ -97,6 +110,25 @@ private slots:
     void handleTaskStart(const QString &task) { taskDescriptions += task; }
 };
 
+class GroupReader : public QThread
+{
+public:
+    GroupReader(const qbs::ProductData &product) : m_product(product) {}
+
+    QStringList fileNames;
+
+private:
+    void run()
+    {
+        foreach (const qbs::GroupData &group, m_product.groups()) {
+            foreach (const QString &filePath, group.allFilePaths())
+                fileNames << group.name() + QLatin1Char(':') + QFileInfo(filePath).fileName();
+        }
+    }
+
+    const qbs::ProductData m_product;
+};
+
 
 static void removeBuildDir(const qbs::SetupProjectParameters &params)
 {
@@ -416,6 +448,7 @@ void TestApi::changeContent()
     QCOMPARE(projectData.allProducts().count(), 1);
     qbs::ProductData product = projectData.allProducts().first();
     QCOMPARE(product.groups().count(), 8);
+    QVERIFY(project.changedProducts().isEmpty());
 
     // Error handling: Invalid product.
     qbs::ErrorInfo errorInfo = project.addGroup(qbs::ProductData(), "blubb");
@@ -469,6 +502,13 @@ void TestApi::changeContent()
     errorInfo = project.removeFiles(product, group, QStringList("file.h"));
     VERIFY_NO_ERROR(errorInfo);
 
+    // The edited product is reported as changed exactly once.
+    QList<qbs::ProductData> changedProducts = project.changedProducts();
+    QCOMPARE(changedProducts.count(), 1);
+    QCOMPARE(changedProducts.first().name(), product.name());
+    QCOMPARE(findGroup(changedProducts.first(), "New Group 1").allFilePaths().count(), 1);
+    QVERIFY(project.changedProducts().isEmpty());
+
     // Error handling: Try to remove the same file again.
     projectData = project.projectData();
     QVERIFY(projectData.products().count() == 1);
@@ -853,6 +893,68 @@ void TestApi::duplicateProductNames_data()
 
 }
 
+void TestApi::dumpNodesGraph()
+{
+    qbs::ErrorInfo errorInfo = doBuildProject("explicitly-depends-on/project.qbs");
+    VERIFY_NO_ERROR(errorInfo);
+    const qbs::SetupProjectParameters setupParams
+            = defaultSetupParameters("explicitly-depends-on/project.qbs");
+    QScopedPointer<qbs::SetupProjectJob> job(qbs::Project().setupProject(setupParams,
+                                                                        m_logSink, 0));
+    waitForFinished(job.data());
+    QVERIFY2(!job->error().hasError(), qPrintable(job->error().toString()));
+    qbs::Project project = job->project();
+    const QList<qbs::ProductData> products = project.projectData().allProducts();
+
+    qbs::NodeTreeDumpOptions options;
+    options.setFormat(qbs::NodeTreeDumpOptions::JsonLinesFormat);
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    errorInfo = project.dumpNodesTree(buffer, products, options);
+    VERIFY_NO_ERROR(errorInfo);
+    QSet<int> nodeIds;
+    QStringList filePaths;
+    int edgeCount = 0;
+    foreach (const QByteArray &line, buffer.data().split('\n')) {
+        if (line.isEmpty())
+            continue;
+        const QJsonObject object = QJsonDocument::fromJson(line).object();
+        const QString type = object.value("type").toString();
+        if (type == "edge") {
+            ++edgeCount;
+            QVERIFY(nodeIds.contains(int(object.value("parent").toDouble())));
+            QVERIFY(nodeIds.contains(int(object.value("child").toDouble())));
+            continue;
+        }
+        const int id = int(object.value("id").toDouble());
+        QVERIFY2(!nodeIds.contains(id), line.constData());
+        nodeIds += id;
+        if (type == "artifact")
+            filePaths << QFileInfo(object.value("filePath").toString()).fileName();
+    }
+    QVERIFY(filePaths.contains("test.mytype"));
+    QVERIFY(filePaths.contains("dependency.txt"));
+    QVERIFY(edgeCount > 0);
+
+    options.setFileTags(QStringList("mytype"));
+    buffer.close();
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    errorInfo = project.dumpNodesTree(buffer, products, options);
+    VERIFY_NO_ERROR(errorInfo);
+    const QList<QByteArray> lines = buffer.data().trimmed().split('\n');
+    QCOMPARE(lines.count(), 1);
+    QCOMPARE(QJsonDocument::fromJson(lines.first()).object().value("type").toString(),
+             QString("artifact"));
+
+    options.setFileTags(QStringList());
+    options.setMaxDepth(0);
+    buffer.close();
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    errorInfo = project.dumpNodesTree(buffer, products, options);
+    VERIFY_NO_ERROR(errorInfo);
+    QVERIFY(!buffer.data().contains("\"edge\""));
+}
+
 void TestApi::dynamicLibs()
 {
     const qbs::ErrorInfo errorInfo = doBuildProject("dynamic-libs/link_dynamiclib.qbs");
@@ -1266,6 +1368,100 @@ void TestApi::objC()
     VERIFY_NO_ERROR(errorInfo);
 }
 
+void TestApi::processOutputSpilling()
+{
+    const QDir tempDir(QDir::tempPath());
+    const QStringList spillFileFilter(QLatin1String("qbsoutput-*"));
+    const QSet<QString> spillFilesBefore = tempDir.entryList(spillFileFilter, QDir::Files).toSet();
+
+    qbs::BuildOptions options;
+    options.setProcessOutputSpillThreshold(1000);
+    ProcessResultReceiver receiver;
+    const qbs::ErrorInfo errorInfo
+            = doBuildProject("process-output-spilling/project.qbs", 0, &receiver, 0, options);
+    VERIFY_NO_ERROR(errorInfo);
+
+    // Output beyond the threshold is reported in chunks from the spill files, in the right
+    // order, rather than being put into the process result.
+    QStringList expectedStdErr;
+    QStringList expectedStdOut;
+    for (int i = 0; i < 5000; ++i) {
+        expectedStdErr << QString::fromLatin1("stderr line %1").arg(i);
+        expectedStdOut << QString::fromLatin1("stdout line %1").arg(i);
+    }
+    const QString reportedStdErr = receiver.reportedStdErr.join(QLatin1Char('\n'));
+    const QString reportedStdOut = receiver.reportedStdOut.join(QLatin1Char('\n'));
+    QCOMPARE(reportedStdErr.count(expectedStdErr.join(QLatin1Char('\n'))), 1);
+    QCOMPARE(reportedStdOut.count(expectedStdOut.join(QLatin1Char('\n'))), 2);
+    QVERIFY(!receiver.output.contains(QLatin1String("stdout line 4999")));
+
+    // A filter function sees the complete output of its channel, which is not spilled.
+    QVERIFY2(receiver.output.contains(QLatin1String("filtered stderr line count: 5001")),
+             qPrintable(receiver.output));
+
+    // The spill files are gone.
+    const QSet<QString> spillFilesAfter = tempDir.entryList(spillFileFilter, QDir::Files).toSet();
+    QVERIFY2(spillFilesBefore.contains(spillFilesAfter),
+             qPrintable(QStringList((spillFilesAfter - spillFilesBefore).toList())
+                        .join(QLatin1String(", "))));
+}
+
+void TestApi::projectDataSharing()
+{
+    const qbs::SetupProjectParameters setupParams
+            = defaultSetupParameters("project-data-sharing/project.qbs");
+    QScopedPointer<qbs::SetupProjectJob> job(qbs::Project().setupProject(setupParams,
+                                                                        m_logSink, 0));
+    waitForFinished(job.data());
+    QVERIFY2(!job->error().hasError(), qPrintable(job->error().toString()));
+    qbs::Project project = job->project();
+
+    // Products that did not change are handed out again and are not reported as changed.
+    const qbs::ProjectData projectData = project.projectData();
+    QCOMPARE(projectData.products().count(), 2);
+    QVERIFY(project.projectData().products() == projectData.products());
+    QVERIFY(project.changedProducts().isEmpty());
+
+    QHash<QString, QStringList> expectedFileNames;
+    expectedFileNames.insert("p1", QStringList() << "p1:a.txt" << "wildcards:d.txt");
+    expectedFileNames.insert("p2", QStringList() << "g:b.txt" << "g:c.txt");
+
+#ifdef QBS_ENABLE_PROJECT_FILE_UPDATES
+    // Data handed out before a change must not be created from the changed project later on.
+    qbs::ProductData p2;
+    foreach (const qbs::ProductData &product, projectData.products()) {
+        if (product.name() == "p2")
+            p2 = product;
+    }
+    QVERIFY(p2.isValid());
+    const qbs::ErrorInfo errorInfo
+            = project.addFiles(p2, findGroup(p2, "g"), QStringList("e.txt"));
+    VERIFY_NO_ERROR(errorInfo);
+    expectedFileNames["p2"] << "g:e.txt";
+    const QList<qbs::ProductData> changedProducts = project.changedProducts();
+    QCOMPARE(changedProducts.count(), 1);
+    QCOMPARE(changedProducts.first().name(), QString("p2"));
+    foreach (const qbs::ProductData &product, projectData.products()) {
+        if (product.name() == "p1")
+            QVERIFY(project.projectData().products().contains(product));
+    }
+#endif
+
+    // Groups and files are created on first access, which may happen in several threads at once.
+    foreach (const qbs::ProductData &product, project.projectData().products()) {
+        QList<GroupReader *> readers;
+        for (int i = 0; i < 4; ++i)
+            readers << new GroupReader(product);
+        foreach (GroupReader * const reader, readers)
+            reader->start();
+        foreach (GroupReader * const reader, readers) {
+            QVERIFY(reader->wait(10000));
+            QCOMPARE(reader->fileNames, expectedFileNames.value(product.name()));
+        }
+        qDeleteAll(readers);
+    }
+}
+
 void TestApi::projectInvalidation()
 {
     qbs::SetupProjectParameters setupParams
@@ -1668,6 +1864,10 @@ qbs::ErrorInfo TestApi::doBuildProject(const QString &projectFilePath,
     if (procResultReceiver) {
         connect(buildJob.data(), SIGNAL(reportProcessResult(qbs::ProcessResult)),
                 procResultReceiver, SLOT(handleProcessResult(qbs::ProcessResult)));
+        connect(buildJob.data(),
+                SIGNAL(reportProcessOutput(QString,QString,QStringList,QStringList)),
+                procResultReceiver,
+                SLOT(handleProcessOutput(QString,QString,QStringList,QStringList)));
     }
     waitForFinished(buildJob.data());
     return buildJob->error();
@@ -73,6 +73,7 @@ private slots:
     void disabledProject();
     void duplicateProductNames();
     void duplicateProductNames_data();
+    void dumpNodesGraph();
     void dynamicLibs();
     void emptyFileTagList();
     void emptySubmodulesList();
@@ -95,6 +96,8 @@ private slots:
     void nonexistingProjectPropertyFromProduct();
     void nonexistingProjectPropertyFromCommandLine();
     void objC();
+    void processOutputSpilling();
+    void projectDataSharing();
     void projectInvalidation();
     void projectLocking();
     void projectWithPropertiesItem();
@@ -0,0 +1,5 @@
+int main()
+{
+    std::cout << "Hello from a precompiled header." << std::endl;
+    return 0;
+}
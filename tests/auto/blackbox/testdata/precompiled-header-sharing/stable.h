@@ -0,0 +1,3 @@
+#if defined __cplusplus
+# include <iostream>
+#endif
@@ -0,0 +1,23 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2 || argv[1][0] != '@') {
+        std::cerr << "Expected exactly one response file argument." << std::endl;
+        return 1;
+    }
+    const char * const responseFilePath = argv[1] + 1;
+    std::ifstream responseFile(responseFilePath);
+    std::string outputFilePath;
+    if (!std::getline(responseFile, outputFilePath)) {
+        std::cerr << "Cannot read response file '" << responseFilePath << "'." << std::endl;
+        return 1;
+    }
+    std::ofstream outputFile(outputFilePath.c_str(), std::ios::binary);
+    std::string argument;
+    while (std::getline(responseFile, argument))
+        outputFile << argument << '\n';
+    return outputFile ? 0 : 1;
+}
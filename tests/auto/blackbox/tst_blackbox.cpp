@@ -329,6 +329,20 @@ void TestBlackbox::android_data()
                                    << (QList<int>() << 15 << 10);
 }
 
+void TestBlackbox::batchedCommands()
+{
+    if (HostOsInfo::isWindowsHost())
+        QSKIP("Uses the touch tool.");
+    QDir::setCurrent(testDataDir + QLatin1String("/batched-commands"));
+    QCOMPARE(runQbs(QStringList() << "--command-echo-mode" << "command-line"), 0);
+    const QString buildDir = relativeProductBuildDir("batched-commands");
+    foreach (const QString &baseName, QStringList() << "a" << "b" << "c" << "d" << "e")
+        QVERIFY2(regularFileExists(buildDir + '/' + baseName + ".out"), qPrintable(baseName));
+
+    // Five ready transformers with a batch size of three: Two processes.
+    QCOMPARE(m_qbsStdout.count("touch "), 2);
+}
+
 void TestBlackbox::buildDirectories()
 {
     const QString projectDir
@@ -526,6 +540,7 @@ void TestBlackbox::clean()
     QVERIFY(!QFile(depLibFilePath).exists());
     foreach (const QString &symLink, symlinks)
         QVERIFY2(!symlinkExists(symLink), qPrintable(symLink));
+    QVERIFY(!QFileInfo(relativeProductBuildDir("app")).exists());
 
     // Dry run.
     QCOMPARE(runQbs(), 0);
@@ -533,6 +548,11 @@ void TestBlackbox::clean()
     QVERIFY(regularFileExists(appExeFilePath));
     QCOMPARE(runQbs(QbsRunParameters(QLatin1String("clean"),
                                      QStringList("--all-artifacts") << "-n")), 0);
+    const QByteArray appObjectDir = QString(relativeProductBuildDir("app") + "/.obj").toLocal8Bit();
+    QVERIFY2(m_qbsStdout.contains("Would remove '"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains(appObjectFilePath.toLocal8Bit() + "'."),
+             m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains(appObjectDir + "'."), m_qbsStdout.constData());
     QVERIFY(regularFileExists(appObjectFilePath));
     QVERIFY(regularFileExists(appExeFilePath));
     QVERIFY(regularFileExists(depObjectFilePath));
@@ -1014,6 +1034,19 @@ void TestBlackbox::recursiveWildcards()
     QVERIFY(QFileInfo(defaultInstallRoot + "/dir/file2.txt").exists());
 }
 
+void TestBlackbox::responseFiles()
+{
+    QDir::setCurrent(testDataDir + "/response-files");
+    QCOMPARE(runQbs(), 0);
+
+    // The in-memory variant falls back to a normal file on platforms that do not support it.
+    foreach (const QString &productName, QStringList() << "on-disk" << "in-memory") {
+        QFile outputFile(relativeProductBuildDir(productName) + '/' + productName + ".txt");
+        QVERIFY2(outputFile.open(QIODevice::ReadOnly), qPrintable(outputFile.fileName()));
+        QCOMPARE(outputFile.readAll(), QByteArray("first argument\nsecond\n"));
+    }
+}
+
 void TestBlackbox::ruleConditions()
 {
     QDir::setCurrent(testDataDir + "/ruleConditions");
@@ -1059,6 +1092,19 @@ void TestBlackbox::overrideProjectProperties()
     QCOMPARE(runQbs(params), 0);
 }
 
+void TestBlackbox::precompiledHeaderSharing()
+{
+    if (HostOsInfo::isWindowsHost())
+        QSKIP("Precompiled headers are only shared with GCC-like compilers.");
+    QDir::setCurrent(testDataDir + QLatin1String("/precompiled-header-sharing"));
+    QCOMPARE(runQbs(), 0);
+    QCOMPARE(m_qbsStdout.count("precompiling stable.h (cpp)"), 1);
+    QVERIFY(regularFileExists(relativeProductBuildDir("app1") + "/app1_cpp.gch"));
+    QVERIFY(regularFileExists(relativeProductBuildDir("app2") + "/app2_cpp.gch"));
+    QVERIFY(regularFileExists(relativeExecutableFilePath("app1")));
+    QVERIFY(regularFileExists(relativeExecutableFilePath("app2")));
+}
+
 void TestBlackbox::productProperties()
 {
     QDir::setCurrent(testDataDir + "/productproperties");
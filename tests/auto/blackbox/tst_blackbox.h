@@ -95,6 +95,7 @@ public slots:
 private slots:
     void android();
     void android_data();
+    void batchedCommands();
     void buildDirectories();
     void changedFiles_data();
     void changedFiles();
@@ -148,9 +149,11 @@ private slots:
     void wildcardRenaming();
     void recursiveRenaming();
     void recursiveWildcards();
+    void responseFiles();
     void ruleConditions();
     void ruleCycle();
     void overrideProjectProperties();
+    void precompiledHeaderSharing();
     void productProperties();
     void propertyChanges();
     void qobjectInObjectiveCpp();
@@ -34,6 +34,7 @@
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
+#include <tools/nodetreedumpoptions.h>
 
 #include <QDir>
 #include <QTemporaryFile>
@@ -157,6 +158,34 @@ private slots:
         QVERIFY(!parser.parseCommandLine(QStringList() << "--log-level" << "blubb" << fileArgs)); // Wrong argument.
     }
 
+    void testDumpNodesTreeOptions()
+    {
+        QTemporaryFile projectFile;
+        QVERIFY(projectFile.open());
+        const QStringList fileArgs = QStringList() << "-f" << projectFile.fileName();
+        CommandLineParser parser;
+        QVERIFY(parser.parseCommandLine(QStringList() << "dump-nodes-tree" << fileArgs));
+        NodeTreeDumpOptions options = parser.nodeTreeDumpOptions();
+        QCOMPARE(options.format(), NodeTreeDumpOptions::TreeFormat);
+        QVERIFY(options.fileTags().isEmpty());
+        QCOMPARE(options.maxDepth(), -1);
+
+        QVERIFY(parser.parseCommandLine(QStringList() << "dump-nodes-tree" << fileArgs
+                                        << "--format" << "json-lines"
+                                        << "--file-tags" << "obj,cpp" << "--max-depth" << "2"));
+        options = parser.nodeTreeDumpOptions();
+        QCOMPARE(options.format(), NodeTreeDumpOptions::JsonLinesFormat);
+        QCOMPARE(options.fileTags(), QStringList() << "obj" << "cpp");
+        QCOMPARE(options.maxDepth(), 2);
+
+        QVERIFY(!parser.parseCommandLine(QStringList() << "dump-nodes-tree" << fileArgs
+                                         << "--format" << "xml"));
+        QVERIFY(!parser.parseCommandLine(QStringList() << "dump-nodes-tree" << fileArgs
+                                         << "--max-depth" << "-1"));
+        QVERIFY(!parser.parseCommandLine(QStringList() << "build" << fileArgs
+                                         << "--format" << "binary"));
+    }
+
     void testProjectFileLookup()
     {
         const QString srcDir = QLatin1String(SRCDIR);
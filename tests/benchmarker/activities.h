@@ -31,13 +31,33 @@
 #define QBS_BENCHMARKER_ACTIVITY_H
 
 #include <QFlags>
+#include <QString>
 
 namespace qbsBenchmarker {
 
-enum Activity { ActivityResolving = 1, ActivityRuleExecution = 2, ActivityNullBuild = 4 };
+enum Activity {
+    ActivityResolving = 1,
+    ActivityRuleExecution = 2,
+    ActivityNullBuild = 4,
+    ActivitySourceChange = 8,
+    ActivityHeaderChange = 16,
+    ActivityProductFileChange = 32,
+    ActivityWildcardFileAdded = 64
+};
 Q_DECLARE_FLAGS(Activities, Activity)
 Q_DECLARE_OPERATORS_FOR_FLAGS(Activities)
 
+// The files touched by the incremental build activities, relative to the directory of
+// the test project file.
+class ChangedFiles
+{
+public:
+    QString sourceFile;
+    QString headerFile;
+    QString productFile;
+    QString addedFile;
+};
+
 } // namespace qbsBenchmarker
 
 #endif // Include guard.
@@ -64,6 +64,18 @@ static void printResults(Activity activity, const BenchmarkResults &results)
     case ActivityNullBuild:
         std::cout << "Null Build";
         break;
+    case ActivitySourceChange:
+        std::cout << "Build After Source Change";
+        break;
+    case ActivityHeaderChange:
+        std::cout << "Build After Header Change";
+        break;
+    case ActivityProductFileChange:
+        std::cout << "Build After Product File Change";
+        break;
+    case ActivityWildcardFileAdded:
+        std::cout << "Build After Adding File To Wildcard Directory";
+        break;
     }
     std::cout << " ==========" << std::endl;
     const BenchmarkResult result = results.value(activity);
@@ -90,6 +102,14 @@ static void printResults(Activities activities, const BenchmarkResults &results)
         printResults(ActivityRuleExecution, results);
     if (activities & ActivityNullBuild)
         printResults(ActivityNullBuild, results);
+    if (activities & ActivitySourceChange)
+        printResults(ActivitySourceChange, results);
+    if (activities & ActivityHeaderChange)
+        printResults(ActivityHeaderChange, results);
+    if (activities & ActivityProductFileChange)
+        printResults(ActivityProductFileChange, results);
+    if (activities & ActivityWildcardFileAdded)
+        printResults(ActivityWildcardFileAdded, results);
 }
 
 int main(int argc, char *argv[])
@@ -99,7 +119,8 @@ int main(int argc, char *argv[])
         CommandLineParser clParser;
         clParser.parse();
         Benchmarker benchmarker(clParser.activies(), clParser.oldCommit(), clParser.newCommit(),
-                                clParser.testProjectFilePath(), clParser.qbsRepoDirPath());
+                                clParser.testProjectFilePath(), clParser.qbsRepoDirPath(),
+                                clParser.changedFiles());
         benchmarker.benchmark();
         printResults(clParser.activies(), benchmarker.results());
     } catch (const Exception &e) {
@@ -40,12 +40,14 @@
 namespace qbsBenchmarker {
 
 Benchmarker::Benchmarker(Activities activities, const QString &oldCommit, const QString &newCommit,
-                         const QString &testProject, const QString &qbsRepo)
+                         const QString &testProject, const QString &qbsRepo,
+                         const ChangedFiles &changedFiles)
     : m_activities(activities)
     , m_oldCommit(oldCommit)
     , m_newCommit(newCommit)
     , m_testProject(testProject)
     , m_qbsRepo(qbsRepo)
+    , m_changedFiles(changedFiles)
 {
 }
 
@@ -75,9 +77,9 @@ void Benchmarker::benchmark()
     std::cout << "Now running valgrind. This can take a while." << std::endl;
 
     ValgrindRunner oldDataRetriever(m_activities, m_testProject, oldQbsBuildDir,
-                                    m_baseOutputDir.path() + "/old-stuff");
+                                    m_baseOutputDir.path() + "/old-stuff", m_changedFiles);
     ValgrindRunner newDataRetriever(m_activities, m_testProject, newQbsBuildDir,
-                                    m_baseOutputDir.path() + "/new-stuff");
+                                    m_baseOutputDir.path() + "/new-stuff", m_changedFiles);
     QFuture<void> oldFuture = QtConcurrent::run(&oldDataRetriever, &ValgrindRunner::run);
     QFuture<void> newFuture = QtConcurrent::run(&newDataRetriever, &ValgrindRunner::run);
     oldFuture.waitForFinished();
@@ -56,7 +56,8 @@ class Benchmarker
 {
 public:
     Benchmarker(Activities activities, const QString &oldCommit, const QString &newCommit,
-                const QString &testProject, const QString &qbsRepo);
+                const QString &testProject, const QString &qbsRepo,
+                const ChangedFiles &changedFiles);
     ~Benchmarker();
 
     void benchmark();
@@ -72,6 +73,7 @@ private:
     const QString m_newCommit;
     const QString m_testProject;
     const QString m_qbsRepo;
+    const ChangedFiles m_changedFiles;
     QString m_commitToRestore;
     QTemporaryDir m_baseOutputDir;
     BenchmarkResults m_results;
@@ -41,6 +41,10 @@ namespace qbsBenchmarker {
 static QString resolveActivity() { return "resolving"; }
 static QString ruleExecutionActivity() { return "rule-execution"; }
 static QString nullBuildActivity() { return "null-build"; }
+static QString sourceChangeActivity() { return "source-change"; }
+static QString headerChangeActivity() { return "header-change"; }
+static QString productFileChangeActivity() { return "product-file-change"; }
+static QString wildcardFileAddedActivity() { return "wildcard-file-added"; }
 static QString allActivities() { return "all"; }
 
 CommandLineParser::CommandLineParser()
@@ -63,10 +67,34 @@ void CommandLineParser::parse()
     QCommandLineOption qbsRepoOption("qbs-repo", "The qbs repository.", "repo path");
     parser.addOption(qbsRepoOption);
     QCommandLineOption activitiesOption("activities",
-            QString::fromLatin1("The activities to benchmark. Possible values (CSV): %1,%2,%3,%4")
+            QString::fromLatin1("The activities to benchmark. Possible values (CSV): "
+                                "%1,%2,%3,%4,%5,%6,%7,%8. The incremental build activities "
+                                "are part of %8 only if their file option is given.")
                     .arg(resolveActivity(), ruleExecutionActivity(), nullBuildActivity(),
+                         sourceChangeActivity(), headerChangeActivity(),
+                         productFileChangeActivity(), wildcardFileAddedActivity(),
                          allActivities()), "activities", allActivities());
     parser.addOption(activitiesOption);
+    QCommandLineOption changedSourceOption("changed-source",
+            QString::fromLatin1("The source file to modify for the %1 activity, relative to "
+                                "the test project's directory.").arg(sourceChangeActivity()),
+            "file path");
+    parser.addOption(changedSourceOption);
+    QCommandLineOption changedHeaderOption("changed-header",
+            QString::fromLatin1("The widely included header to modify for the %1 activity, "
+                                "relative to the test project's directory.")
+                    .arg(headerChangeActivity()), "file path");
+    parser.addOption(changedHeaderOption);
+    QCommandLineOption changedProductFileOption("changed-product-file",
+            QString::fromLatin1("The project or product file to modify for the %1 activity, "
+                                "relative to the test project's directory.")
+                    .arg(productFileChangeActivity()), "file path");
+    parser.addOption(changedProductFileOption);
+    QCommandLineOption addedFileOption("added-file",
+            QString::fromLatin1("The file to create for the %1 activity, relative to the test "
+                                "project's directory. It must match a wildcard pattern of the "
+                                "project.").arg(wildcardFileAddedActivity()), "file path");
+    parser.addOption(addedFileOption);
     parser.process(*QCoreApplication::instance());
     QList<QCommandLineOption> mandatoryOptions = QList<QCommandLineOption>()
             << oldCommitOption << newCommitOption << testProjectOption << qbsRepoOption;
@@ -80,11 +108,23 @@ void CommandLineParser::parse()
     m_newCommit = parser.value(newCommitOption);
     m_testProjectFilePath = parser.value(testProjectOption);
     m_qbsRepoDirPath = parser.value(qbsRepoOption);
+    m_changedFiles.sourceFile = parser.value(changedSourceOption);
+    m_changedFiles.headerFile = parser.value(changedHeaderOption);
+    m_changedFiles.productFile = parser.value(changedProductFileOption);
+    m_changedFiles.addedFile = parser.value(addedFileOption);
     const QStringList activitiesList = parser.value(activitiesOption).split(',');
     m_activities = 0;
     foreach (const QString &activityString, activitiesList) {
         if (activityString == allActivities()) {
             m_activities = ActivityResolving | ActivityRuleExecution | ActivityNullBuild;
+            if (!m_changedFiles.sourceFile.isEmpty())
+                m_activities |= ActivitySourceChange;
+            if (!m_changedFiles.headerFile.isEmpty())
+                m_activities |= ActivityHeaderChange;
+            if (!m_changedFiles.productFile.isEmpty())
+                m_activities |= ActivityProductFileChange;
+            if (!m_changedFiles.addedFile.isEmpty())
+                m_activities |= ActivityWildcardFileAdded;
             break;
         } else if (activityString == resolveActivity()) {
             m_activities = ActivityResolving;
@@ -92,6 +132,22 @@ void CommandLineParser::parse()
             m_activities |= ActivityRuleExecution;
         } else if (activityString == nullBuildActivity()) {
             m_activities |= ActivityNullBuild;
+        } else if (activityString == sourceChangeActivity()) {
+            if (m_changedFiles.sourceFile.isEmpty())
+                throwException(changedSourceOption.names().first(), parser.helpText());
+            m_activities |= ActivitySourceChange;
+        } else if (activityString == headerChangeActivity()) {
+            if (m_changedFiles.headerFile.isEmpty())
+                throwException(changedHeaderOption.names().first(), parser.helpText());
+            m_activities |= ActivityHeaderChange;
+        } else if (activityString == productFileChangeActivity()) {
+            if (m_changedFiles.productFile.isEmpty())
+                throwException(changedProductFileOption.names().first(), parser.helpText());
+            m_activities |= ActivityProductFileChange;
+        } else if (activityString == wildcardFileAddedActivity()) {
+            if (m_changedFiles.addedFile.isEmpty())
+                throwException(addedFileOption.names().first(), parser.helpText());
+            m_activities |= ActivityWildcardFileAdded;
         } else {
             throwException(activitiesOption.names().first(), activityString, parser.helpText());
         }
@@ -48,6 +48,7 @@ public:
     QString newCommit() const { return m_newCommit; }
     QString testProjectFilePath() const { return m_testProjectFilePath; }
     QString qbsRepoDirPath() const { return m_qbsRepoDirPath; }
+    ChangedFiles changedFiles() const { return m_changedFiles; }
 
 private:
     Q_NORETURN void throwException(const QString &optionName, const QString &illegalValue,
@@ -59,6 +60,7 @@ private:
     QString m_newCommit;
     QString m_testProjectFilePath;
     QString m_qbsRepoDirPath;
+    ChangedFiles m_changedFiles;
 };
 
 } // namespace qbsBenchmarker
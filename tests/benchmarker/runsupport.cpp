@@ -32,6 +32,9 @@
 #include "exception.h"
 
 #include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QProcess>
 #include <QString>
 #include <QStringList>
@@ -67,4 +70,22 @@ void runProcess(const QStringList &commandLine, const QString &workingDir, QByte
         *output = p.readAllStandardOutput().trimmed();
 }
 
+void copyDirectory(const QString &sourceDir, const QString &targetDir)
+{
+    if (!QDir::root().mkpath(targetDir))
+        throw Exception(QString::fromLatin1("Failed to create directory '%1'.").arg(targetDir));
+    const QFileInfoList entries = QDir(sourceDir).entryInfoList(QDir::AllEntries | QDir::Hidden
+                                                                | QDir::NoDotAndDotDot);
+    foreach (const QFileInfo &entry, entries) {
+        const QString targetPath = targetDir + '/' + entry.fileName();
+        if (entry.isDir()) {
+            if (entry.fileName() != ".git")
+                copyDirectory(entry.filePath(), targetPath);
+        } else if (!QFile::copy(entry.filePath(), targetPath)) {
+            throw Exception(QString::fromLatin1("Failed to copy '%1' to '%2'.")
+                            .arg(entry.filePath(), targetPath));
+        }
+    }
+}
+
 } // namespace qbsBenchmarker
@@ -42,6 +42,7 @@ namespace qbsBenchmarker {
 
 void runProcess(const QStringList &commandLine, const QString& workingDir = QString(),
                 QByteArray *output = 0);
+void copyDirectory(const QString &sourceDir, const QString &targetDir);
 
 } // namespace qbsBenchmarker
 
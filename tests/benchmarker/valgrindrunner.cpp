@@ -35,18 +35,38 @@
 #include <QBuffer>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QMutexLocker>
 #include <QStringList>
+#include <QThread>
 #include <QtConcurrent>
 
 namespace qbsBenchmarker {
 
+static QString incrementalActivityName(Activity activity)
+{
+    switch (activity) {
+    case ActivitySourceChange:
+        return "source-change";
+    case ActivityHeaderChange:
+        return "header-change";
+    case ActivityProductFileChange:
+        return "product-file-change";
+    case ActivityWildcardFileAdded:
+        return "wildcard-file-added";
+    default:
+        return QString();
+    }
+}
+
 ValgrindRunner::ValgrindRunner(Activities activities, const QString &testProject,
-                               const QString &qbsBuildDir, const QString &baseOutputDir)
+                               const QString &qbsBuildDir, const QString &baseOutputDir,
+                               const ChangedFiles &changedFiles)
     : m_activities(activities)
     , m_testProject(testProject)
     , m_qbsBinary(qbsBuildDir + "/bin/qbs")
     , m_baseOutputDir(baseOutputDir)
+    , m_changedFiles(changedFiles)
 {
     if (!QDir::root().mkpath(m_baseOutputDir))
         throw Exception(QString::fromLatin1("Failed to create directory '%1'.").arg(baseOutputDir));
@@ -61,6 +81,12 @@ void ValgrindRunner::run()
         futures << QtConcurrent::run(this, &ValgrindRunner::traceRuleExecution);
     if (m_activities & ActivityNullBuild)
         futures << QtConcurrent::run(this, &ValgrindRunner::traceNullBuild);
+    const QList<Activity> incrementalActivities = QList<Activity>() << ActivitySourceChange
+            << ActivityHeaderChange << ActivityProductFileChange << ActivityWildcardFileAdded;
+    foreach (const Activity activity, incrementalActivities) {
+        if (m_activities & activity)
+            futures << QtConcurrent::run(this, &ValgrindRunner::traceIncrementalBuild, activity);
+    }
     while (!futures.isEmpty())
         futures.takeFirst().waitForFinished();
 }
@@ -69,29 +95,83 @@ void ValgrindRunner::traceResolving()
 {
     const QString buildDirCallgrind = m_baseOutputDir + "/build-dir.resolving.callgrind";
     const QString buildDirMassif = m_baseOutputDir + "/build-dir.resolving.massif";
-    traceActivity(ActivityResolving, buildDirCallgrind, buildDirMassif);
+    traceActivity(ActivityResolving, buildDirCallgrind, buildDirMassif, m_testProject);
 }
 
 void ValgrindRunner::traceRuleExecution()
 {
     const QString buildDirCallgrind = m_baseOutputDir + "/build-dir.rule-execution.callgrind";
     const QString buildDirMassif = m_baseOutputDir + "/build-dir.rule-execution.massif";
-    runProcess(qbsCommandLine("resolve", buildDirCallgrind, false));
-    runProcess(qbsCommandLine("resolve", buildDirMassif, false));
-    traceActivity(ActivityRuleExecution, buildDirCallgrind, buildDirMassif);
+    runProcess(qbsCommandLine("resolve", buildDirCallgrind, false, m_testProject));
+    runProcess(qbsCommandLine("resolve", buildDirMassif, false, m_testProject));
+    traceActivity(ActivityRuleExecution, buildDirCallgrind, buildDirMassif, m_testProject);
 }
 
 void ValgrindRunner::traceNullBuild()
 {
     const QString buildDirCallgrind = m_baseOutputDir + "/build-dir.null-build.callgrind";
     const QString buildDirMassif = m_baseOutputDir + "/build-dir.null-build.massif";
-    runProcess(qbsCommandLine("build", buildDirCallgrind, false));
-    runProcess(qbsCommandLine("build", buildDirMassif, false));
-    traceActivity(ActivityNullBuild, buildDirCallgrind, buildDirMassif);
+    runProcess(qbsCommandLine("build", buildDirCallgrind, false, m_testProject));
+    runProcess(qbsCommandLine("build", buildDirMassif, false, m_testProject));
+    traceActivity(ActivityNullBuild, buildDirCallgrind, buildDirMassif, m_testProject);
+}
+
+// The change is done in a private copy of the project, so that activities running in parallel
+// and the old and new qbs do not see each other's modifications.
+void ValgrindRunner::traceIncrementalBuild(Activity activity)
+{
+    const QString activityString = incrementalActivityName(activity);
+    const QString projectDir = m_baseOutputDir + "/project." + activityString;
+    copyDirectory(QFileInfo(m_testProject).absolutePath(), projectDir);
+    const QString projectFile = projectDir + '/' + QFileInfo(m_testProject).fileName();
+    const QString buildDirCallgrind = m_baseOutputDir + "/build-dir." + activityString
+            + ".callgrind";
+    const QString buildDirMassif = m_baseOutputDir + "/build-dir." + activityString + ".massif";
+    runProcess(qbsCommandLine("build", buildDirCallgrind, false, projectFile));
+    runProcess(qbsCommandLine("build", buildDirMassif, false, projectFile));
+    applyChange(activity, projectDir);
+    traceActivity(activity, buildDirCallgrind, buildDirMassif, projectFile);
+}
+
+void ValgrindRunner::applyChange(Activity activity, const QString &projectDir) const
+{
+    // Make sure the change gets a newer timestamp than the artifacts of the initial build,
+    // even on file systems with coarse timestamps.
+    QThread::sleep(1);
+
+    QString filePath;
+    QIODevice::OpenMode openMode = QIODevice::Append;
+    switch (activity) {
+    case ActivitySourceChange:
+        filePath = m_changedFiles.sourceFile;
+        break;
+    case ActivityHeaderChange:
+        filePath = m_changedFiles.headerFile;
+        break;
+    case ActivityProductFileChange:
+        filePath = m_changedFiles.productFile;
+        break;
+    case ActivityWildcardFileAdded:
+        filePath = m_changedFiles.addedFile;
+        openMode = QIODevice::WriteOnly;
+        if (QFileInfo(projectDir + '/' + filePath).exists()) {
+            throw Exception(QString::fromLatin1("File '%1' already exists in the test project.")
+                            .arg(filePath));
+        }
+        break;
+    default:
+        throw Exception(QString::fromLatin1("Activity %1 does not change the project.")
+                        .arg(activity));
+    }
+    QFile file(projectDir + '/' + filePath);
+    if (!file.open(openMode) || file.write("\n") != 1) {
+        throw Exception(QString::fromLatin1("Failed to write file '%1': %2")
+                        .arg(file.fileName(), file.errorString()));
+    }
 }
 
 void ValgrindRunner::traceActivity(Activity activity, const QString &buildDirCallgrind,
-                                   const QString &buildDirMassif)
+                                   const QString &buildDirMassif, const QString &projectFile)
 {
     QString activityString;
     QString qbsCommand;
@@ -112,24 +192,32 @@ void ValgrindRunner::traceActivity(Activity activity, const QString &buildDirCal
         qbsCommand = "build";
         dryRun = false;
         break;
+    case ActivitySourceChange:
+    case ActivityHeaderChange:
+    case ActivityProductFileChange:
+    case ActivityWildcardFileAdded:
+        activityString = incrementalActivityName(activity);
+        qbsCommand = "build";
+        dryRun = false;
+        break;
     }
 
     const QString outFileCallgrind = m_baseOutputDir + "/outfile." + activityString + ".callgrind";
     const QString outFileMassif = m_baseOutputDir + "/outfile." + activityString + ".massif";
     QFuture<qint64> callGrindFuture = QtConcurrent::run(this, &ValgrindRunner::runCallgrind,
-            qbsCommand, buildDirCallgrind, dryRun, outFileCallgrind);
+            qbsCommand, buildDirCallgrind, dryRun, projectFile, outFileCallgrind);
     QFuture<qint64> massifFuture = QtConcurrent::run(this, &ValgrindRunner::runMassif, qbsCommand,
-            buildDirMassif, dryRun, outFileMassif);
+            buildDirMassif, dryRun, projectFile, outFileMassif);
     callGrindFuture.waitForFinished();
     massifFuture.waitForFinished();
     addToResults(ValgrindResult(activity, callGrindFuture.result(), massifFuture.result()));
 }
 
 QStringList ValgrindRunner::qbsCommandLine(const QString &command, const QString &buildDir,
-                                           bool dryRun) const
+                                           bool dryRun, const QString &projectFile) const
 {
     QStringList commandLine = QStringList() << m_qbsBinary << command << "-qq" << "-d" << buildDir
-                                            << "-f" << m_testProject;
+                                            << "-f" << projectFile;
     if (dryRun)
         commandLine << "--dry-run";
     return commandLine;
@@ -143,9 +231,10 @@ QStringList ValgrindRunner::wrapForValgrind(const QStringList &commandLine, cons
 }
 
 QStringList ValgrindRunner::valgrindCommandLine(const QString &qbsCommand, const QString &buildDir,
-        bool dryRun, const QString &tool, const QString &outFile) const
+        bool dryRun, const QString &projectFile, const QString &tool, const QString &outFile) const
 {
-    return wrapForValgrind(qbsCommandLine(qbsCommand, buildDir, dryRun), tool, outFile);
+    return wrapForValgrind(qbsCommandLine(qbsCommand, buildDir, dryRun, projectFile), tool,
+                           outFile);
 }
 
 void ValgrindRunner::addToResults(const ValgrindResult &result)
@@ -155,9 +244,11 @@ void ValgrindRunner::addToResults(const ValgrindResult &result)
 }
 
 qint64 ValgrindRunner::runCallgrind(const QString &qbsCommand, const QString &buildDir,
-                                     bool dryRun, const QString &outFile)
+                                    bool dryRun, const QString &projectFile,
+                                    const QString &outFile)
 {
-    runProcess(valgrindCommandLine(qbsCommand, buildDir, dryRun, "callgrind", outFile));
+    runProcess(valgrindCommandLine(qbsCommand, buildDir, dryRun, projectFile, "callgrind",
+                                   outFile));
     QFile f(outFile);
     if (!f.open(QIODevice::ReadOnly)) {
         throw Exception(QString::fromLatin1("Failed to open file '%1': %2")
@@ -184,9 +275,10 @@ qint64 ValgrindRunner::runCallgrind(const QString &qbsCommand, const QString &bu
 }
 
 qint64 ValgrindRunner::runMassif(const QString &qbsCommand, const QString &buildDir, bool dryRun,
-                                  const QString &outFile)
+                                 const QString &projectFile, const QString &outFile)
 {
-    runProcess(valgrindCommandLine(qbsCommand, buildDir, dryRun, "massif", outFile));
+    runProcess(valgrindCommandLine(qbsCommand, buildDir, dryRun, projectFile, "massif",
+                                   outFile));
     QByteArray ms_printOutput;
     runProcess(QStringList() << "ms_print" << outFile, QString(), &ms_printOutput);
     QBuffer buffer(&ms_printOutput);
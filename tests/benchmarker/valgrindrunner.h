@@ -57,7 +57,7 @@ class ValgrindRunner
 {
 public:
     ValgrindRunner(Activities activities, const QString &testProject, const QString &qbsBuildDir,
-                    const QString &baseOutputDir);
+                    const QString &baseOutputDir, const ChangedFiles &changedFiles);
 
     void run();
     QList<ValgrindResult> results() const { return m_results; }
@@ -66,23 +66,27 @@ private:
     void traceResolving();
     void traceRuleExecution();
     void traceNullBuild();
+    void traceIncrementalBuild(Activity activity);
     void traceActivity(Activity activity, const QString &buildDirCallgrind,
-                       const QString &buildDirMassif);
-    QStringList qbsCommandLine(const QString &command, const QString &buildDir, bool dryRun) const;
+                       const QString &buildDirMassif, const QString &projectFile);
+    void applyChange(Activity activity, const QString &projectDir) const;
+    QStringList qbsCommandLine(const QString &command, const QString &buildDir, bool dryRun,
+                               const QString &projectFile) const;
     QStringList wrapForValgrind(const QStringList &commandLine, const QString &tool,
                                 const QString &outFile) const;
     QStringList valgrindCommandLine(const QString &qbsCommand, const QString &buildDir, bool dryRun,
-            const QString &tool, const QString &outFile) const;
+            const QString &projectFile, const QString &tool, const QString &outFile) const;
     void addToResults(const ValgrindResult &results);
     qint64 runCallgrind(const QString &qbsCommand, const QString &buildDir, bool dryRun,
-                         const QString &outFile);
+                        const QString &projectFile, const QString &outFile);
     qint64 runMassif(const QString &qbsCommand, const QString &buildDir, bool dryRun,
-                      const QString &outFile);
+                     const QString &projectFile, const QString &outFile);
 
     const Activities m_activities;
     const QString m_testProject;
     const QString m_qbsBinary;
     const QString m_baseOutputDir;
+    const ChangedFiles m_changedFiles;
     QList<ValgrindResult> m_results;
     QMutex m_resultsMutex;
 };
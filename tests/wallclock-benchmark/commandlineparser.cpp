@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "commandlineparser.h"
+
+#include "exception.h"
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+
+using qbsBenchmarker::Exception;
+
+namespace qbsWallclockBenchmark {
+
+static QString allScenariosString() { return "all"; }
+
+CommandLineParser::CommandLineParser() : m_repetitions(1)
+{
+}
+
+void CommandLineParser::parse()
+{
+    const ProjectParameters defaults;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("This tool measures the wall-clock time and peak memory "
+                                     "usage of qbs on generated projects of configurable size.");
+    parser.addHelpOption();
+    QCommandLineOption qbsOption("qbs", "The qbs executable to benchmark.", "file path");
+    parser.addOption(qbsOption);
+    QCommandLineOption profileOption("profile", "The profile to build with.", "profile");
+    parser.addOption(profileOption);
+    QCommandLineOption productsOption("products", "The number of products.", "count",
+                                      QString::number(defaults.productCount));
+    parser.addOption(productsOption);
+    QCommandLineOption sourcesOption("sources", "The number of sources per product.", "count",
+                                     QString::number(defaults.sourcesPerProduct));
+    parser.addOption(sourcesOption);
+    QCommandLineOption includeDepthOption("include-depth",
+            "The length of the header include chain in each product.", "depth",
+            QString::number(defaults.includeDepth));
+    parser.addOption(includeDepthOption);
+    QCommandLineOption modulesOption("modules",
+            "The number of generated modules every product depends on.", "count",
+            QString::number(defaults.moduleCount));
+    parser.addOption(modulesOption);
+    QStringList scenarioNames;
+    foreach (const Scenario scenario, allScenarios())
+        scenarioNames << scenarioName(scenario);
+    QCommandLineOption scenariosOption("scenarios",
+            QString::fromLatin1("The scenarios to run. Possible values (CSV): %1,%2")
+                    .arg(scenarioNames.join(','), allScenariosString()),
+            "scenarios", allScenariosString());
+    parser.addOption(scenariosOption);
+    QCommandLineOption repetitionsOption("repetitions",
+            "How often to measure each scenario.", "count", "1");
+    parser.addOption(repetitionsOption);
+    QCommandLineOption outputOption("output",
+            "The file to write the JSON results to. Default is standard output.", "file path");
+    parser.addOption(outputOption);
+    QCommandLineOption workDirOption("work-dir",
+            "The directory to generate and build projects in. Default is a temporary directory.",
+            "dir path");
+    parser.addOption(workDirOption);
+    QCommandLineOption generateOnlyOption("generate-only",
+            "Only generate a project into the given directory, do not run any scenarios.",
+            "dir path");
+    parser.addOption(generateOnlyOption);
+    parser.process(*QCoreApplication::instance());
+
+    const QList<QCommandLineOption> countOptions = QList<QCommandLineOption>()
+            << productsOption << sourcesOption << includeDepthOption << modulesOption
+            << repetitionsOption;
+    QList<int> counts;
+    foreach (const QCommandLineOption &o, countOptions) {
+        bool ok;
+        const int count = parser.value(o).toInt(&ok);
+        if (!ok || count < 0)
+            throwException(o.names().first(), parser.value(o), parser.helpText());
+        counts << count;
+    }
+    m_projectParameters.productCount = counts.at(0);
+    m_projectParameters.sourcesPerProduct = counts.at(1);
+    m_projectParameters.includeDepth = counts.at(2);
+    m_projectParameters.moduleCount = counts.at(3);
+    m_repetitions = counts.at(4);
+    if (m_repetitions == 0) {
+        throwException(repetitionsOption.names().first(), parser.value(repetitionsOption),
+                       parser.helpText());
+    }
+
+    m_generateOnlyDirPath = parser.value(generateOnlyOption);
+    if (!m_generateOnlyDirPath.isEmpty())
+        return;
+
+    if (!parser.isSet(qbsOption))
+        throwException(qbsOption.names().first(), parser.helpText());
+    m_qbsFilePath = parser.value(qbsOption);
+    m_profile = parser.value(profileOption);
+    m_outputFilePath = parser.value(outputOption);
+    m_workDirPath = parser.value(workDirOption);
+    m_scenarios = 0;
+    foreach (const QString &scenarioString, parser.value(scenariosOption).split(',')) {
+        if (scenarioString == allScenariosString()) {
+            foreach (const Scenario scenario, allScenarios())
+                m_scenarios |= scenario;
+            break;
+        }
+        const int index = scenarioNames.indexOf(scenarioString);
+        if (index == -1)
+            throwException(scenariosOption.names().first(), scenarioString, parser.helpText());
+        m_scenarios |= allScenarios().at(index);
+    }
+}
+
+void CommandLineParser::throwException(const QString &optionName, const QString &illegalValue,
+                                       const QString &helpText)
+{
+    const QString errorText(QString::fromLatin1("Error parsing command line: Illegal value '%1' "
+            "for option '--%2'.\n%3").arg(illegalValue, optionName, helpText));
+    throw Exception(errorText);
+}
+
+void CommandLineParser::throwException(const QString &missingOption, const QString &helpText)
+{
+    const QString errorText(QString::fromLatin1("Error parsing command line: Missing mandatory "
+            "option '--%1'.\n%2").arg(missingOption, helpText));
+    throw Exception(errorText);
+}
+
+} // namespace qbsWallclockBenchmark
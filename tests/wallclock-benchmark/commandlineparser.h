@@ -0,0 +1,73 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_WALLCLOCKBENCHMARK_COMMANDLINEPARSER_H
+#define QBS_WALLCLOCKBENCHMARK_COMMANDLINEPARSER_H
+
+#include "projectgenerator.h"
+#include "scenarios.h"
+
+#include <QString>
+
+namespace qbsWallclockBenchmark {
+
+class CommandLineParser
+{
+public:
+    CommandLineParser();
+
+    void parse();
+
+    QString qbsFilePath() const { return m_qbsFilePath; }
+    QString profile() const { return m_profile; }
+    ProjectParameters projectParameters() const { return m_projectParameters; }
+    Scenarios scenarios() const { return m_scenarios; }
+    int repetitions() const { return m_repetitions; }
+    QString outputFilePath() const { return m_outputFilePath; }
+    QString workDirPath() const { return m_workDirPath; }
+    QString generateOnlyDirPath() const { return m_generateOnlyDirPath; }
+
+private:
+    Q_NORETURN void throwException(const QString &optionName, const QString &illegalValue,
+                                   const QString &helpText);
+    Q_NORETURN void throwException(const QString &missingOption, const QString &helpText);
+
+    QString m_qbsFilePath;
+    QString m_profile;
+    ProjectParameters m_projectParameters;
+    Scenarios m_scenarios;
+    int m_repetitions;
+    QString m_outputFilePath;
+    QString m_workDirPath;
+    QString m_generateOnlyDirPath;
+};
+
+} // namespace qbsWallclockBenchmark
+
+#endif // Include guard.
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "commandlineparser.h"
+#include "exception.h"
+#include "projectgenerator.h"
+#include "scenariorunner.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace qbsWallclockBenchmark;
+using qbsBenchmarker::Exception;
+
+static void writeResults(const QByteArray &json, const QString &outputFilePath)
+{
+    if (outputFilePath.isEmpty()) {
+        std::cout << json.constData();
+        return;
+    }
+    QFile outputFile(outputFilePath);
+    if (!outputFile.open(QIODevice::WriteOnly) || outputFile.write(json) != json.size()) {
+        throw Exception(QString::fromLatin1("Failed to write file '%1': %2")
+                        .arg(outputFilePath, outputFile.errorString()));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try {
+        QCoreApplication app(argc, argv);
+        CommandLineParser clParser;
+        clParser.parse();
+        if (!clParser.generateOnlyDirPath().isEmpty()) {
+            const ProjectGenerator generator(clParser.projectParameters(),
+                                             clParser.generateOnlyDirPath());
+            generator.generate();
+            std::cout << qPrintable(QDir::toNativeSeparators(generator.projectFilePath()))
+                      << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        QTemporaryDir tempDir;
+        QString workDir = clParser.workDirPath();
+        if (workDir.isEmpty()) {
+            if (!tempDir.isValid())
+                throw Exception("Failed to create temporary directory.");
+            workDir = tempDir.path();
+        }
+        QString qbsFilePath = clParser.qbsFilePath();
+        if (QFileInfo(qbsFilePath).exists()) // Otherwise, it's looked up in PATH.
+            qbsFilePath = QFileInfo(qbsFilePath).absoluteFilePath();
+        ScenarioRunner runner(qbsFilePath, clParser.profile(),
+                              clParser.projectParameters(), workDir, clParser.repetitions());
+        runner.run(clParser.scenarios());
+        writeResults(runner.resultsAsJson(), clParser.outputFilePath());
+    } catch (const Exception &e) {
+        std::cerr << qPrintable(e.description()) << std::endl;
+        return EXIT_FAILURE;
+    }
+}
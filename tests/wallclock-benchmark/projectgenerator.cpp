@@ -0,0 +1,198 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "projectgenerator.h"
+
+#include "exception.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+using qbsBenchmarker::Exception;
+
+namespace qbsWallclockBenchmark {
+
+static QByteArray moduleName(int module)
+{
+    return "synthetic_module" + QByteArray::number(module);
+}
+
+static QByteArray headerName(int product, int level)
+{
+    return ProjectGenerator::productName(product).toLatin1() + "_h" + QByteArray::number(level)
+            + ".h";
+}
+
+ProjectGenerator::ProjectGenerator(const ProjectParameters &parameters, const QString &projectDir)
+    : m_parameters(parameters), m_projectDir(QDir::cleanPath(projectDir))
+{
+    if (m_parameters.productCount < 1 || m_parameters.sourcesPerProduct < 1
+            || m_parameters.includeDepth < 0 || m_parameters.moduleCount < 0) {
+        throw Exception("Invalid project parameters: There must be at least one product "
+                        "with at least one source file.");
+    }
+}
+
+void ProjectGenerator::generate() const
+{
+    const QDir projectDir(m_projectDir);
+    if (projectDir.exists() && !projectDir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot)
+            .isEmpty()) {
+        throw Exception(QString::fromLatin1("Refusing to generate project into non-empty "
+                                            "directory '%1'.").arg(m_projectDir));
+    }
+
+    QByteArray project = "import qbs\n\nProject {\n"
+            "    qbsSearchPaths: [\".\"]\n"
+            "    references: [\n";
+    for (int i = 0; i < m_parameters.productCount; ++i) {
+        project += "        \"" + projectDir.relativeFilePath(productFilePath(i)).toLatin1()
+                + "\",\n";
+    }
+    project += "    ]\n}\n";
+    writeFile(projectFilePath(), project);
+
+    writeFile(commonHeaderFilePath(), "#ifndef SYNTHETIC_COMMON_H\n"
+                                      "#define SYNTHETIC_COMMON_H\n\n"
+                                      "#define SYNTHETIC_COMMON_VALUE 1\n\n"
+                                      "#endif\n");
+
+    for (int i = 0; i < m_parameters.moduleCount; ++i)
+        generateModule(i);
+    for (int i = 0; i < m_parameters.productCount; ++i)
+        generateProduct(i);
+}
+
+QString ProjectGenerator::projectFilePath() const
+{
+    return m_projectDir + "/project.qbs";
+}
+
+QString ProjectGenerator::productFilePath(int product) const
+{
+    return productDir(product) + '/' + productName(product) + ".qbs";
+}
+
+QString ProjectGenerator::sourceFilePath(int product, int source) const
+{
+    return productDir(product) + "/src/" + productName(product) + "_source"
+            + QString::number(source) + ".cpp";
+}
+
+QString ProjectGenerator::commonHeaderFilePath() const
+{
+    return m_projectDir + "/common/common.h";
+}
+
+QString ProjectGenerator::productName(int product)
+{
+    return "product" + QString::number(product);
+}
+
+void ProjectGenerator::generateModule(int module) const
+{
+    const QByteArray name = moduleName(module);
+    const QByteArray content = "import qbs\n\nModule {\n"
+            "    Depends { name: \"cpp\" }\n"
+            "    property string tag: \"" + name + "\"\n"
+            "    cpp.defines: [\"" + name.toUpper() + "_TAG=\\\"\" + tag + \"\\\"\"]\n"
+            "}\n";
+    writeFile(m_projectDir + "/modules/" + name + '/' + name + ".qbs", content);
+}
+
+void ProjectGenerator::generateProduct(int product) const
+{
+    const QByteArray name = productName(product).toLatin1();
+    QByteArray productFile = "import qbs\n\nStaticLibrary {\n"
+            "    name: \"" + name + "\"\n"
+            "    property int revision: 0\n"
+            "    Depends { name: \"cpp\" }\n";
+    for (int i = 0; i < m_parameters.moduleCount; ++i)
+        productFile += "    Depends { name: \"" + moduleName(i) + "\" }\n";
+    productFile += "    cpp.includePaths: [\"include\", \"../../common\"]\n"
+            "    cpp.defines: [\"" + name.toUpper() + "_REVISION=\" + revision]\n"
+            "    Group {\n"
+            "        name: \"sources\"\n"
+            "        files: [\"src/*.cpp\"]\n"
+            "    }\n"
+            "    Group {\n"
+            "        name: \"headers\"\n"
+            "        files: [\"include/*.h\"]\n"
+            "    }\n"
+            "}\n";
+    writeFile(productFilePath(product), productFile);
+
+    // Header i includes header i + 1; the last one in the chain includes the common header.
+    for (int level = 0; level < m_parameters.includeDepth; ++level) {
+        const QByteArray guard = headerName(product, level).toUpper().replace('.', '_');
+        const QByteArray nextHeader = level + 1 < m_parameters.includeDepth
+                ? headerName(product, level + 1) : QByteArray("common.h");
+        writeFile(productDir(product) + "/include/" + headerName(product, level),
+                  "#ifndef " + guard + "\n#define " + guard + "\n\n"
+                  "#include \"" + nextHeader + "\"\n\n"
+                  "#define " + guard + "_VALUE (SYNTHETIC_COMMON_VALUE + "
+                  + QByteArray::number(level) + ")\n\n"
+                  "#endif\n");
+    }
+
+    for (int source = 0; source < m_parameters.sourcesPerProduct; ++source)
+        generateSource(product, source);
+}
+
+void ProjectGenerator::generateSource(int product, int source) const
+{
+    const QByteArray firstHeader = m_parameters.includeDepth > 0
+            ? headerName(product, 0) : QByteArray("common.h");
+    writeFile(sourceFilePath(product, source),
+              "#include \"" + firstHeader + "\"\n\n"
+              "int " + productName(product).toLatin1() + "_function" + QByteArray::number(source)
+              + "()\n{\n    return SYNTHETIC_COMMON_VALUE + " + QByteArray::number(source)
+              + ";\n}\n");
+}
+
+QString ProjectGenerator::productDir(int product) const
+{
+    return m_projectDir + "/products/" + productName(product);
+}
+
+void ProjectGenerator::writeFile(const QString &filePath, const QByteArray &content)
+{
+    if (!QDir::root().mkpath(QFileInfo(filePath).absolutePath())) {
+        throw Exception(QString::fromLatin1("Failed to create directory '%1'.")
+                        .arg(QFileInfo(filePath).absolutePath()));
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+        throw Exception(QString::fromLatin1("Failed to write file '%1': %2")
+                        .arg(filePath, file.errorString()));
+    }
+}
+
+} // namespace qbsWallclockBenchmark
@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_WALLCLOCKBENCHMARK_PROJECTGENERATOR_H
+#define QBS_WALLCLOCKBENCHMARK_PROJECTGENERATOR_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace qbsWallclockBenchmark {
+
+class ProjectParameters
+{
+public:
+    ProjectParameters() : productCount(50), sourcesPerProduct(20), includeDepth(5), moduleCount(5)
+    {}
+
+    int productCount;
+    int sourcesPerProduct;
+    int includeDepth;
+    int moduleCount;
+};
+
+// Emits a synthetic project:
+//   - productCount static libraries, each of which depends on moduleCount generated modules,
+//   - sourcesPerProduct sources per product, picked up via wildcards,
+//   - a chain of includeDepth headers per product, included by every source of that product,
+//   - one header that is included (indirectly) by every source in the project.
+class ProjectGenerator
+{
+public:
+    ProjectGenerator(const ProjectParameters &parameters, const QString &projectDir);
+
+    void generate() const;
+    void generateSource(int product, int source) const;
+
+    QString projectFilePath() const;
+    QString productFilePath(int product) const;
+    QString sourceFilePath(int product, int source) const;
+    QString commonHeaderFilePath() const;
+    const ProjectParameters &parameters() const { return m_parameters; }
+
+    static QString productName(int product);
+
+private:
+    void generateModule(int module) const;
+    void generateProduct(int product) const;
+    QString productDir(int product) const;
+
+    static void writeFile(const QString &filePath, const QByteArray &content);
+
+    const ProjectParameters m_parameters;
+    const QString m_projectDir;
+};
+
+} // namespace qbsWallclockBenchmark
+
+#endif // Include guard.
@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "runsupport.h"
+
+#include "exception.h"
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+
+#ifdef Q_OS_UNIX
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#include <QProcess>
+#endif
+
+using qbsBenchmarker::Exception;
+
+namespace qbsWallclockBenchmark {
+
+static void throwExitCodeError(const QString &command, int exitCode)
+{
+    throw Exception(QString::fromLatin1("Command '%1' finished with exit code %2.")
+                    .arg(command).arg(exitCode));
+}
+
+#ifdef Q_OS_UNIX
+// QProcess does not tell us about the child's resource usage, so we fork ourselves and
+// collect it via wait4().
+ProcessMeasurement runMeasuredProcess(const QStringList &commandLine, const QString &workingDir)
+{
+    const QString command = commandLine.first();
+    QList<QByteArray> args;
+    foreach (const QString &arg, commandLine)
+        args << arg.toLocal8Bit();
+    QVector<char *> argv;
+    for (int i = 0; i < args.count(); ++i)
+        argv << args[i].data();
+    argv << 0;
+    const QByteArray workingDirLocal = workingDir.toLocal8Bit();
+
+    QElapsedTimer timer;
+    timer.start();
+    const pid_t pid = fork();
+    if (pid == -1) {
+        throw Exception(QString::fromLatin1("Process '%1' failed to start: %2")
+                        .arg(command, QString::fromLocal8Bit(strerror(errno))));
+    }
+    if (pid == 0) {
+        const int devNull = open("/dev/null", O_WRONLY);
+        if (devNull != -1)
+            dup2(devNull, STDOUT_FILENO);
+        if (!workingDirLocal.isEmpty() && chdir(workingDirLocal.constData()) != 0)
+            _exit(127);
+        execvp(argv.first(), argv.data());
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    pid_t result;
+    do {
+        result = wait4(pid, &status, 0, &usage);
+    } while (result == -1 && errno == EINTR);
+    ProcessMeasurement measurement;
+    measurement.wallClockTimeMs = timer.elapsed();
+    if (result == -1) {
+        throw Exception(QString::fromLatin1("Failed to wait for process '%1': %2")
+                        .arg(command, QString::fromLocal8Bit(strerror(errno))));
+    }
+    if (!WIFEXITED(status))
+        throw Exception(QString::fromLatin1("Process '%1' crashed.").arg(command));
+    if (WEXITSTATUS(status) != 0)
+        throwExitCodeError(command, WEXITSTATUS(status));
+#ifdef Q_OS_OSX
+    measurement.peakRssBytes = usage.ru_maxrss;
+#else
+    measurement.peakRssBytes = qint64(usage.ru_maxrss) * 1024;
+#endif
+    return measurement;
+}
+#else
+ProcessMeasurement runMeasuredProcess(const QStringList &commandLine, const QString &workingDir)
+{
+    QStringList args = commandLine;
+    const QString command = args.takeFirst();
+    QProcess p;
+    p.setWorkingDirectory(workingDir);
+    p.setStandardOutputFile(QProcess::nullDevice());
+    p.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    QElapsedTimer timer;
+    timer.start();
+    p.start(command, args);
+    if (!p.waitForStarted())
+        throw Exception(QString::fromLatin1("Process '%1' failed to start.").arg(command));
+    p.waitForFinished(-1);
+    ProcessMeasurement measurement;
+    measurement.wallClockTimeMs = timer.elapsed();
+    if (p.exitStatus() != QProcess::NormalExit) {
+        throw Exception(QString::fromLatin1("Error running '%1': %2")
+                        .arg(command, p.errorString()));
+    }
+    if (p.exitCode() != 0)
+        throwExitCodeError(command, p.exitCode());
+    return measurement;
+}
+#endif
+
+} // namespace qbsWallclockBenchmark
@@ -0,0 +1,57 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_WALLCLOCKBENCHMARK_RUNSUPPORT_H
+#define QBS_WALLCLOCKBENCHMARK_RUNSUPPORT_H
+
+#include <QtGlobal>
+
+QT_BEGIN_NAMESPACE
+class QString;
+class QStringList;
+QT_END_NAMESPACE
+
+namespace qbsWallclockBenchmark {
+
+class ProcessMeasurement
+{
+public:
+    ProcessMeasurement() : wallClockTimeMs(0), peakRssBytes(-1) {}
+
+    qint64 wallClockTimeMs;
+    qint64 peakRssBytes; // -1 if not available on this platform.
+};
+
+// Runs the command to completion and throws if it fails. The peak RSS is the one of the
+// largest process in the tree, i.e. usually qbs itself or the largest compiler run.
+ProcessMeasurement runMeasuredProcess(const QStringList &commandLine, const QString &workingDir);
+
+} // namespace qbsWallclockBenchmark
+
+#endif // Include guard.
@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#include "scenariorunner.h"
+
+#include "exception.h"
+#include "runsupport.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegExp>
+#include <QThread>
+
+#include <algorithm>
+#include <iostream>
+
+using qbsBenchmarker::Exception;
+
+namespace qbsWallclockBenchmark {
+
+qint64 ScenarioResult::medianWallClockTimeMs() const
+{
+    if (wallClockTimesMs.isEmpty())
+        return 0;
+    QList<qint64> times = wallClockTimesMs;
+    std::sort(times.begin(), times.end());
+    return times.at(times.count() / 2);
+}
+
+ScenarioRunner::ScenarioRunner(const QString &qbsFilePath, const QString &profile,
+                               const ProjectParameters &parameters, const QString &baseDir,
+                               int repetitions)
+    : m_qbsFilePath(qbsFilePath)
+    , m_profile(profile)
+    , m_parameters(parameters)
+    , m_baseDir(baseDir)
+    , m_repetitions(repetitions)
+{
+}
+
+void ScenarioRunner::run(Scenarios scenarios)
+{
+    foreach (const Scenario scenario, allScenarios()) {
+        if (!(scenarios & scenario))
+            continue;
+        std::cerr << "Running scenario '" << qPrintable(scenarioName(scenario)) << "'..."
+                  << std::endl;
+        m_results << runScenario(scenario);
+    }
+}
+
+QByteArray ScenarioRunner::resultsAsJson() const
+{
+    QJsonObject parameters;
+    parameters.insert("products", m_parameters.productCount);
+    parameters.insert("sourcesPerProduct", m_parameters.sourcesPerProduct);
+    parameters.insert("includeDepth", m_parameters.includeDepth);
+    parameters.insert("modules", m_parameters.moduleCount);
+
+    QJsonArray scenarios;
+    foreach (const ScenarioResult &result, m_results) {
+        QJsonArray times;
+        foreach (const qint64 time, result.wallClockTimesMs)
+            times.append(double(time));
+        QJsonObject scenario;
+        scenario.insert("name", scenarioName(result.scenario));
+        scenario.insert("wallClockTimesMs", times);
+        scenario.insert("medianWallClockTimeMs", double(result.medianWallClockTimeMs()));
+        scenario.insert("peakRssBytes", double(result.peakRssBytes));
+        scenarios.append(scenario);
+    }
+
+    QJsonObject root;
+    root.insert("qbs", m_qbsFilePath);
+    root.insert("profile", m_profile);
+    root.insert("parameters", parameters);
+    root.insert("repetitions", m_repetitions);
+    root.insert("scenarios", scenarios);
+    return QJsonDocument(root).toJson();
+}
+
+ScenarioResult ScenarioRunner::runScenario(Scenario scenario)
+{
+    const QString scenarioDir = m_baseDir + '/' + scenarioName(scenario);
+    if (QDir(scenarioDir).exists() && !QDir(scenarioDir).removeRecursively())
+        throw Exception(QString::fromLatin1("Failed to remove directory '%1'.").arg(scenarioDir));
+    const QString buildDir = scenarioDir + "/build";
+    const ProjectGenerator generator(m_parameters, scenarioDir + "/project");
+    generator.generate();
+    const QStringList buildCommandLine
+            = qbsCommandLine("build", buildDir, generator.projectFilePath());
+
+    // Everything but the cold resolve starts from a fully built project.
+    if (scenario != ScenarioColdResolve)
+        runMeasuredProcess(buildCommandLine, scenarioDir);
+
+    ScenarioResult result;
+    result.scenario = scenario;
+    for (int i = 0; i < m_repetitions; ++i) {
+        ProcessMeasurement measurement;
+        if (scenario == ScenarioColdResolve) {
+            if (QDir(buildDir).exists() && !QDir(buildDir).removeRecursively()) {
+                throw Exception(QString::fromLatin1("Failed to remove directory '%1'.")
+                                .arg(buildDir));
+            }
+            measurement = runMeasuredProcess(qbsCommandLine("resolve", buildDir,
+                                                            generator.projectFilePath()),
+                                             scenarioDir);
+        } else {
+            applyChange(scenario, generator, i);
+            measurement = runMeasuredProcess(buildCommandLine, scenarioDir);
+        }
+        result.wallClockTimesMs << measurement.wallClockTimeMs;
+        result.peakRssBytes = qMax(result.peakRssBytes, measurement.peakRssBytes);
+    }
+    return result;
+}
+
+void ScenarioRunner::applyChange(Scenario scenario, const ProjectGenerator &generator,
+                                 int repetition) const
+{
+    if (scenario == ScenarioNullBuild)
+        return;
+    waitForNewTimestamp();
+    const QByteArray comment = "// change " + QByteArray::number(repetition) + '\n';
+    switch (scenario) {
+    case ScenarioTouchSource:
+        appendToFile(generator.sourceFilePath(0, 0), comment);
+        break;
+    case ScenarioTouchCommonHeader:
+        appendToFile(generator.commonHeaderFilePath(), comment);
+        break;
+    case ScenarioAddFile:
+        generator.generateSource(0, m_parameters.sourcesPerProduct + repetition);
+        break;
+    case ScenarioEditProductFile:
+        bumpRevision(generator.productFilePath(0));
+        break;
+    default:
+        break;
+    }
+}
+
+QStringList ScenarioRunner::qbsCommandLine(const QString &command, const QString &buildDir,
+                                           const QString &projectFilePath) const
+{
+    QStringList commandLine = QStringList() << m_qbsFilePath << command << "-qq" << "-d"
+                                            << buildDir << "-f" << projectFilePath;
+    if (!m_profile.isEmpty())
+        commandLine << ("profile:" + m_profile);
+    return commandLine;
+}
+
+void ScenarioRunner::appendToFile(const QString &filePath, const QByteArray &content)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::Append) || file.write(content) != content.size()) {
+        throw Exception(QString::fromLatin1("Failed to write file '%1': %2")
+                        .arg(filePath, file.errorString()));
+    }
+}
+
+void ScenarioRunner::bumpRevision(const QString &productFilePath)
+{
+    QFile file(productFilePath);
+    if (!file.open(QIODevice::ReadWrite)) {
+        throw Exception(QString::fromLatin1("Failed to open file '%1': %2")
+                        .arg(productFilePath, file.errorString()));
+    }
+    QString content = QString::fromUtf8(file.readAll());
+    QRegExp revisionRegExp("property int revision: (\\d+)");
+    if (revisionRegExp.indexIn(content) == -1) {
+        throw Exception(QString::fromLatin1("File '%1' has no revision property.")
+                        .arg(productFilePath));
+    }
+    content.replace(revisionRegExp, "property int revision: "
+                    + QString::number(revisionRegExp.cap(1).toInt() + 1));
+    file.seek(0);
+    file.resize(0);
+    file.write(content.toUtf8());
+}
+
+// Make sure qbs sees the changed files as newer than the artifacts of the previous build,
+// even on file systems with coarse timestamps. This happens outside of the measured time.
+void ScenarioRunner::waitForNewTimestamp()
+{
+    QThread::sleep(1);
+}
+
+} // namespace qbsWallclockBenchmark
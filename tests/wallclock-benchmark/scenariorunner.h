@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing
+**
+** This file is part of the Qt Build Suite.
+**
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms and
+** conditions see http://www.qt.io/terms-conditions. For further information
+** use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file.  Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, The Qt Company gives you certain additional
+** rights.  These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+****************************************************************************/
+#ifndef QBS_WALLCLOCKBENCHMARK_SCENARIORUNNER_H
+#define QBS_WALLCLOCKBENCHMARK_SCENARIORUNNER_H
+
+#include "projectgenerator.h"
+#include "scenarios.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace qbsWallclockBenchmark {
+
+class ScenarioResult
+{
+public:
+    ScenarioResult() : scenario(ScenarioColdResolve), peakRssBytes(-1) {}
+
+    qint64 medianWallClockTimeMs() const;
+
+    Scenario scenario;
+    QList<qint64> wallClockTimesMs;
+    qint64 peakRssBytes;
+};
+
+class ScenarioRunner
+{
+public:
+    ScenarioRunner(const QString &qbsFilePath, const QString &profile,
+                   const ProjectParameters &parameters, const QString &baseDir, int repetitions);
+
+    void run(Scenarios scenarios);
+    QList<ScenarioResult> results() const { return m_results; }
+    QByteArray resultsAsJson() const;
+
+private:
+    ScenarioResult runScenario(Scenario scenario);
+    void applyChange(Scenario scenario, const ProjectGenerator &generator, int repetition) const;
+    QStringList qbsCommandLine(const QString &command, const QString &buildDir,
+                               const QString &projectFilePath) const;
+
+    static void appendToFile(const QString &filePath, const QByteArray &content);
+    static void bumpRevision(const QString &productFilePath);
+    static void waitForNewTimestamp();
+
+    const QString m_qbsFilePath;
+    const QString m_profile;
+    const ProjectParameters m_parameters;
+    const QString m_baseDir;
+    const int m_repetitions;
+    QList<ScenarioResult> m_results;
+};
+
+} // namespace qbsWallclockBenchmark
+
+#endif // Include guard.
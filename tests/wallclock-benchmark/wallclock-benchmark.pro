@@ -0,0 +1,19 @@
+TARGET = qbs_wallclock-benchmark
+DESTDIR = ../../bin
+CONFIG += console
+CONFIG -= app_bundle
+INCLUDEPATH += ../benchmarker
+SOURCES = \
+    commandlineparser.cpp \
+    main.cpp \
+    projectgenerator.cpp \
+    runsupport.cpp \
+    scenariorunner.cpp
+
+HEADERS = \
+    ../benchmarker/exception.h \
+    commandlineparser.h \
+    projectgenerator.h \
+    runsupport.h \
+    scenariorunner.h \
+    scenarios.h